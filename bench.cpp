@@ -0,0 +1,504 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	bench.cpp - A headless benchmark runner that sweeps packet size x packet count matrices
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					bool parse_sweep(int argc, char *argv[], SweepSpec &spec)
+--					int run_sweep(const SweepSpec &spec)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The benchmark runner drives both sides of a transfer without any user interaction. For every protocol in the
+--	sweep a server is started on its own thread running an EventLoop, and the client side calls send_packet for every
+--	packet size, packet count and repetition. After each transfer the runner waits for the server to report the
+--	received statistics and prints one CSV row per cell to stdout, so that results can be collected by scripts.
+--
+--		analyser bench [--proto tcp,udp] [--sizes 1024,4096] [--counts 10,100] [--streams 1,4] [--reps 5]
+--		               [--host 127.0.0.1] [--port 5150] [transfer options]
+--
+--	The stream counts only apply to TCP; UDP cells always use one stream. With --format json|csv each cell is printed
+--	as a RunRecord (see record.cpp) instead, holding both sides of the transfer, and --history appends every cell to
+--	a run history.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "bench.h"
+#include "event_loop.h"
+#include "options.h"
+#include "recv_pool.h"
+#include "record.h"
+#include "tcp.h"
+#include "udp.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	The server side of a benchmark. The EventLoop runs on its own thread and every finished transfer is handed to the
+--	runner through wait_result.
+----------------------------------------------------------------------------------------------------------------------*/
+class BenchServer
+{
+	public:
+		BenchServer() {};
+		~BenchServer() { stop(); };
+		void start(Protocol server_protocol, int server_port, const TransferOptions &options);
+		bool wait_result(int timeout_ms, TransferResult &transfer_result);
+		void stop();
+	private:
+		Protocol protocol;
+		int port;
+		TCP tcp_server;
+		UDP udp_server;
+		EventLoop loop;
+		std::thread loop_thread;
+		std::mutex result_lock;
+		std::condition_variable result_ready;
+		bool finished = false;
+		TransferResult result;
+};
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_list
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_list(const char *arg, std::vector<int> &values)
+--						const char *arg: Comma separated list of positive integers
+--						std::vector<int> &values: Replaced with the parsed values
+--
+--	RETURNS:		bool - true if every value was a positive integer.
+--
+--	NOTES:
+--	Parses the comma separated lists used by --sizes, --counts and --streams.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool parse_list(const char *arg, std::vector<int> &values)
+{
+	char *end;
+	long value;
+
+	values.clear();
+	while (*arg != '\0')
+	{
+		value = strtol(arg, &end, 10);
+		if (end == arg || value <= 0 || (*end != ',' && *end != '\0'))
+		{
+			return false;
+		}
+		values.push_back((int)value);
+		arg = (*end == ',') ? end + 1 : end;
+	}
+
+	return !values.empty();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_sweep
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added --hugepages]
+--					October 16, 2026 [Accept the transfer options]
+--					October 16, 2026 [Added --streams]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_sweep(int argc, char *argv[], SweepSpec &spec)
+--						int argc: Number of sweep arguments
+--						char *argv[]: Sweep arguments (after the "bench" mode)
+--						SweepSpec &spec: Filled in with the sweep
+--
+--	RETURNS:		bool - true if the arguments were valid.
+--
+--	NOTES:
+--	Parses the sweep specification from the command line. Options that are not given keep the defaults in SweepSpec.
+----------------------------------------------------------------------------------------------------------------------*/
+bool parse_sweep(int argc, char *argv[], SweepSpec &spec)
+{
+	for (int i = 0; i < argc; i++)
+	{
+		std::string option = argv[i];
+		int parsed;
+
+		// Swept Stream Counts
+		if (option == "--streams" && i + 1 < argc)
+		{
+			if (!parse_list(argv[++i], spec.stream_counts))
+				return false;
+			for (int streams : spec.stream_counts)
+			{
+				if (streams > TCP_MAX_STREAMS)
+					return false;
+			}
+			continue;
+		}
+
+		// Options of every Transfer in the Sweep
+		if ((parsed = parse_transfer_option(argc, argv, i, spec.options)) != 0)
+		{
+			if (parsed < 0)
+				return false;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "Missing value for %s\n", option.c_str());
+			return false;
+		}
+
+		const char *value = argv[++i];
+
+		if (option == "--proto")
+		{
+			std::string protocols = value;
+			spec.protocols.clear();
+			if (protocols.find("tcp") != std::string::npos)
+				spec.protocols.push_back(TCP_PROTOCOL);
+			if (protocols.find("udp") != std::string::npos)
+				spec.protocols.push_back(UDP_PROTOCOL);
+			if (spec.protocols.empty())
+				return false;
+		}
+		else if (option == "--sizes")
+		{
+			if (!parse_list(value, spec.packet_sizes))
+				return false;
+		}
+		else if (option == "--counts")
+		{
+			if (!parse_list(value, spec.packet_counts))
+				return false;
+		}
+		else if (option == "--reps")
+		{
+			if ((spec.repetitions = atoi(value)) <= 0)
+				return false;
+		}
+		else if (option == "--host")
+		{
+			spec.host = value;
+		}
+		else if (option == "--port")
+		{
+			if ((spec.port = atoi(value)) <= 0)
+				return false;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown option %s\n", option.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Apply the transfer options]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(Protocol server_protocol, int server_port, const TransferOptions &options)
+--						Protocol server_protocol: Protocol of the server
+--						int server_port: The Port the server will be listening on
+--						const TransferOptions &options: Options of the transfers in the sweep
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Starts the server on the calling thread, so the socket is listening before the first client connects, and then
+--	runs the EventLoop on a new thread. The handler is the same as run_server in main_posix.cpp, except that finished
+--	transfers wake up wait_result instead of being printed.
+----------------------------------------------------------------------------------------------------------------------*/
+void BenchServer::start(Protocol server_protocol, int server_port, const TransferOptions &options)
+{
+	protocol = server_protocol;
+	port = server_port;
+	tcp_server.set_options(options);
+	udp_server.set_options(options);
+
+	switch (protocol)
+	{
+	case TCP_PROTOCOL:
+		tcp_server.start_server(port, loop);
+		break;
+	case UDP_PROTOCOL:
+		udp_server.start_server(port, loop);
+		break;
+	}
+
+	loop_thread = std::thread([this]()
+	{
+		std::string print_string;
+
+		loop.run([this, &print_string](SOCKET sock, int event)
+		{
+			switch (event)
+			{
+			case EVENT_ACCEPT:
+				tcp_server.accept_connection(sock, loop);
+				break;
+			case EVENT_READ:
+			case EVENT_CLOSE:
+				if (protocol == TCP_PROTOCOL)
+					tcp_server.receive_packet(port, sock, print_string);
+				else
+					udp_server.receive_packet(port, sock, print_string);
+				break;
+			case EVENT_IDLE:
+				if (protocol == UDP_PROTOCOL)
+					udp_server.check_timeout(print_string);
+				break;
+			}
+
+			// Hand the Finished Transfer to the Runner
+			if (!print_string.empty())
+			{
+				std::lock_guard<std::mutex> guard(result_lock);
+				result = (protocol == TCP_PROTOCOL) ? tcp_server.get_result() : udp_server.get_result();
+				finished = true;
+				print_string.clear();
+				result_ready.notify_one();
+			}
+		}, UDP_IDLE_TIMEOUT);
+	});
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		wait_result
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		wait_result(int timeout_ms, TransferResult &transfer_result)
+--						int timeout_ms: Maximum time to wait for the server
+--						TransferResult &transfer_result: Set to the server statistics
+--
+--	RETURNS:		bool - true if the server finished a transfer before the timeout.
+--
+--	NOTES:
+--	Waits for the server to finish the transfer in progress and consumes its result.
+----------------------------------------------------------------------------------------------------------------------*/
+bool BenchServer::wait_result(int timeout_ms, TransferResult &transfer_result)
+{
+	std::unique_lock<std::mutex> guard(result_lock);
+
+	if (!result_ready.wait_for(guard, std::chrono::milliseconds(timeout_ms), [this] { return finished; }))
+	{
+		return false;
+	}
+
+	transfer_result = result;
+	finished = false;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		stop
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		stop()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Stops the EventLoop thread and closes the server sockets.
+----------------------------------------------------------------------------------------------------------------------*/
+void BenchServer::stop()
+{
+	if (loop_thread.joinable())
+	{
+		loop.stop();
+		loop_thread.join();
+		tcp_server.end_connection();
+		udp_server.end_connection();
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		run_sweep
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Report TransferTimer statistics]
+--					October 16, 2026 [Report bytes touched per byte received]
+--					October 16, 2026 [Apply the transfer options]
+--					October 16, 2026 [Report datagrams per call]
+--					October 16, 2026 [Expect the file size with --sendfile]
+--					October 16, 2026 [Report disk write throughput]
+--					October 16, 2026 [Report system calls]
+--					October 16, 2026 [Sweep TCP stream counts]
+--					October 16, 2026 [Print RunRecords with --format, append them with --history]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		run_sweep(const SweepSpec &spec)
+--						const SweepSpec &spec: The sweep to run
+--
+--	RETURNS:		int - 0 if every cell produced a server result, 1 otherwise.
+--
+--	NOTES:
+--	Runs every cell of the sweep and prints one CSV row per cell. A UDP cell whose datagrams were all lost has no
+--	server result and is reported with zero bytes received. The server is given time to finish each transfer before
+--	the next cell starts, so consecutive transfers never overlap.
+----------------------------------------------------------------------------------------------------------------------*/
+int run_sweep(const SweepSpec &spec)
+{
+	int status = 0;
+	std::vector<char> host(spec.host.begin(), spec.host.end());
+	host.push_back('\0');
+
+	recv_pool_init(spec.options.hugepages);
+
+	bool csv_header = false;
+
+	if (spec.options.format == FORMAT_TEXT)
+	{
+		printf("protocol,packet_size,num_packets,streams,repetition,bytes_sent,bytes_received,packets_received,"
+			"send_ms,receive_ms,ttfb_ms,throughput_mbps,gap_p50_us,gap_p99_us,gap_p999_us,touched_per_byte,send_per_call,recv_per_call,disk_mbps,send_syscalls,recv_syscalls,loss_percent\n");
+	}
+
+	for (Protocol protocol : spec.protocols)
+	{
+		BenchServer server;
+		TCP tcp_client;
+		UDP udp_client;
+		udp_client.set_options(spec.options);
+		server.start(protocol, spec.port, spec.options);
+
+		// Stream Counts only Apply to TCP
+		std::vector<int> stream_counts = (protocol == TCP_PROTOCOL) ? spec.stream_counts : std::vector<int>(1, 1);
+
+		for (int packet_size : spec.packet_sizes)
+		{
+			for (int num_packet : spec.packet_counts)
+			{
+				for (int streams : stream_counts)
+				{
+					TransferOptions cell_options = spec.options;
+					cell_options.streams = streams;
+
+					for (int rep = 1; rep <= spec.repetitions; rep++)
+					{
+						TransferResult sent;
+						TransferResult received;
+						CpuSample cpu_start = cpu_sample();
+						RunRecord record;
+						int timeout;
+
+						// Run the Client Side
+						if (protocol == TCP_PROTOCOL)
+						{
+							tcp_client.set_options(cell_options);
+							tcp_client.send_packet(host.data(), spec.port, packet_size, num_packet);
+							sent = tcp_client.get_result();
+							timeout = BENCH_TCP_TIMEOUT;
+						}
+						else
+						{
+							udp_client.send_packet(host.data(), spec.port, packet_size, num_packet);
+							sent = udp_client.get_result();
+							timeout = UDP_IDLE_TIMEOUT * 3;
+						}
+
+						// Wait for the Server Side
+						if (sent.total_bytes == 0 || !server.wait_result(timeout, received))
+						{
+							received = TransferResult();
+							status = 1;
+						}
+
+						long long expected = (long long)packet_size * num_packet;
+						if (!spec.options.send_file.empty() && protocol == TCP_PROTOCOL)
+							expected = sent.total_bytes;
+						double loss = (expected > 0) ? 100.0 * (expected - received.total_bytes) / expected : 0;
+
+						// Both Sides of the Cell
+						record.mode = "bench";
+						record.protocol = protocol;
+						record.host = spec.host;
+						record.port = spec.port;
+						record.packet_size = packet_size;
+						record.num_packets = num_packet;
+						record.repetition = rep;
+						record.options = cell_options;
+						record.has_client = record.has_server = true;
+						record.client = sent;
+						record.server = received;
+						record.cpu = cpu_since(cpu_start);
+
+						if (spec.options.format == FORMAT_JSON)
+						{
+							printf("%s\n", record_json(record).c_str());
+						}
+						else if (spec.options.format == FORMAT_CSV)
+						{
+							if (!csv_header)
+								printf("%s\n", record_csv_header(record).c_str());
+							csv_header = true;
+							printf("%s\n", record_csv(record).c_str());
+						}
+						else
+						{
+							printf("%s,%d,%d,%d,%d,%lld,%lld,%lld,%.3f,%.3f,%.3f,%.2f,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%lld,%lld,%.2f\n",
+								(protocol == TCP_PROTOCOL) ? "tcp" : "udp", packet_size, num_packet, streams, rep,
+								sent.total_bytes, received.total_bytes, received.packets,
+								sent.elapsed_ms, received.elapsed_ms, received.ttfb_ms, received.throughput_mbps,
+								received.gap_p50_us, received.gap_p99_us, received.gap_p999_us, received.touched_per_byte,
+								sent.datagrams_per_call, received.datagrams_per_call, received.disk_mbps,
+								sent.syscalls, received.syscalls, loss);
+						}
+						fflush(stdout);
+
+						if (!spec.options.history_file.empty())
+						{
+							append_history(spec.options.history_file, record);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return status;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "transport.h"
+
+#define BENCH_TCP_TIMEOUT 60000
+
+// Benchmark Sweep Specification (every protocol x packet size x packet count x stream count x repetition is one cell)
+struct SweepSpec
+{
+	std::vector<Protocol> protocols = { TCP_PROTOCOL, UDP_PROTOCOL };
+	std::vector<int> packet_sizes = { PACKETSIZE };
+	std::vector<int> packet_counts = { NUMPACKETS };
+	std::vector<int> stream_counts = { 1 };
+	int repetitions = 1;
+	std::string host = "127.0.0.1";
+	int port = PORT;
+	TransferOptions options;
+};
+
+bool parse_sweep(int argc, char *argv[], SweepSpec &spec);
+int run_sweep(const SweepSpec &spec);
@@ -0,0 +1,670 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	coro.cpp - C++20 coroutine transfer API on a single-threaded epoll executor
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					AsyncSocket(Executor &executor, SOCKET sock)
+--					~AsyncSocket()
+--					Task<long long> send(const char *buf, int len)
+--					Task<long long> send(struct iovec *iov, int count)
+--					Task<long long> recv(char *buf, int len, uint64_t deadline_ns)
+--					Executor()
+--					~Executor()
+--					bool run(int timeout_ms)
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The send loops block their thread until the whole transfer is sent, so every concurrent flow used to need a
+--	thread of its own. A flow written as a coroutine instead suspends whenever its socket would block:
+--
+--		Task<long long> flow(AsyncSocket &conn, ...)
+--		{
+--			...
+--			if (co_await conn.send(buf, len) == -1)
+--				co_return -1;
+--			...
+--		}
+--
+--	and the Executor resumes it once the socket is ready again, so one thread drives as many flows as there are
+--	sockets. A Task does not start until it is awaited or spawned; when it returns it resumes the coroutine that
+--	awaited it (symmetric transfer, so deep chains do not grow the stack).
+--
+--	Every AsyncSocket is registered with the Executor's epoll instance once, edge triggered for reading and writing.
+--	A coroutine only waits after its call returned EAGAIN, so it cannot miss the edge that wakes it. Paced flows
+--	sleep with co_await executor.sleep_until(due), on a timerfd armed to the earliest timer. A read can be given a
+--	deadline, which puts a timer next to the wait on the socket: whichever fires first resumes the coroutine, and
+--	the other is dropped (a stale deadline is recognised by its wait id). run() returns when no coroutine is waiting
+--	on a socket or a timer any more, which on a single thread means every spawned task has returned.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "coro.h"
+#include "frame.h"
+#include "event_loop.h"
+#include "timing.h"
+#include "trace.h"
+#include "pacing.h"
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		AsyncSocket
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		AsyncSocket(Executor &executor, SOCKET sock)
+--						Executor &executor: Executor that resumes the coroutines waiting on the socket
+--						SOCKET sock: Non-blocking socket, owned by the caller
+--
+--	NOTES:
+--	Registers the socket with the Executor.
+----------------------------------------------------------------------------------------------------------------------*/
+AsyncSocket::AsyncSocket(Executor &executor, SOCKET sock) : executor(executor), sock(sock)
+{
+	executor.add(this);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		~AsyncSocket
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		~AsyncSocket()
+--
+--	NOTES:
+--	Removes the socket from the Executor. The socket itself is left open.
+----------------------------------------------------------------------------------------------------------------------*/
+AsyncSocket::~AsyncSocket()
+{
+	executor.remove(this);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		await_suspend
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Start a timer for a read deadline]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		await_suspend(std::coroutine_handle<> waiting)
+--						std::coroutine_handle<> waiting: Coroutine to resume when the socket is ready
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	A read wait with a deadline also starts a timer carrying a new wait id, so a timer left over from an earlier
+--	wait of the same socket cannot end this one.
+----------------------------------------------------------------------------------------------------------------------*/
+void AsyncSocket::Readiness::await_suspend(std::coroutine_handle<> waiting)
+{
+	if (write)
+	{
+		conn.writer = waiting;
+	}
+	else
+	{
+		conn.reader = waiting;
+		conn.timed_out = false;
+		if (deadline_ns > 0)
+		{
+			conn.read_wait = ++conn.executor.last_wait_id;
+			conn.executor.add_timer({ deadline_ns, waiting, conn.sock, conn.read_wait });
+		}
+	}
+	conn.executor.waiting++;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send(const char *buf, int len)
+--						const char *buf: Data to send, unchanged until the task returns
+--						int len: Number of bytes to send
+--
+--	RETURNS:		Task<long long> - the number of bytes sent (len), or -1 on error (errno is set).
+--
+--	NOTES:
+--	The coroutine counterpart of send_all: sends the whole buffer, suspending whenever the send buffer is full.
+----------------------------------------------------------------------------------------------------------------------*/
+Task<long long> AsyncSocket::send(const char *buf, int len)
+{
+	ssize_t sent_bytes;
+	long long offset = 0;
+
+	while (offset < len)
+	{
+		syscalls++;
+		sent_bytes = ::send(sock, buf + offset, len - offset, MSG_NOSIGNAL);
+		trace_ring().record(TRACE_SEND, (uint32_t)syscalls, (uint32_t)(len - offset), (int32_t)sent_bytes,
+			(sent_bytes == -1) ? errno : 0);
+		if (sent_bytes == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				co_await writable();
+				continue;
+			}
+			co_return -1;
+		}
+		offset += sent_bytes;
+	}
+
+	co_return offset;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send(struct iovec *iov, int count)
+--						struct iovec *iov: Buffers to send in order, advanced as they are sent
+--						int count: Number of buffers
+--
+--	RETURNS:		Task<long long> - the number of bytes sent, or -1 on error (errno is set).
+--
+--	NOTES:
+--	Gathers the buffers into the stream with sendmsg, suspending whenever the send buffer is full. The iovecs are
+--	modified as a short send leaves part of them to send.
+----------------------------------------------------------------------------------------------------------------------*/
+Task<long long> AsyncSocket::send(struct iovec *iov, int count)
+{
+	struct msghdr msg;
+	ssize_t sent_bytes;
+	long long total = 0;
+	long long pending = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		pending += iov[i].iov_len;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	while (count > 0)
+	{
+		msg.msg_iov = iov;
+		msg.msg_iovlen = count;
+		syscalls++;
+		sent_bytes = sendmsg(sock, &msg, MSG_NOSIGNAL);
+		trace_ring().record(TRACE_SEND, (uint32_t)syscalls, (uint32_t)(pending - total), (int32_t)sent_bytes,
+			(sent_bytes == -1) ? errno : 0);
+		if (sent_bytes == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				co_await writable();
+				continue;
+			}
+			co_return -1;
+		}
+		advance_iovecs(iov, count, sent_bytes);
+		total += sent_bytes;
+	}
+
+	co_return total;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		recv
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Give up at an optional deadline]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		recv(char *buf, int len, uint64_t deadline_ns)
+--						char *buf: Buffer the data is read into
+--						int len: Size of the buffer
+--						uint64_t deadline_ns: Monotonic time to give up at, or 0 to wait for as long as it takes
+--
+--	RETURNS:		Task<long long> - the number of bytes read, 0 at the end of the stream, or -1 on error (errno is
+--					set, ETIMEDOUT at the deadline).
+--
+--	NOTES:
+--	Suspends until the socket has data, then returns what one read delivers.
+----------------------------------------------------------------------------------------------------------------------*/
+Task<long long> AsyncSocket::recv(char *buf, int len, uint64_t deadline_ns)
+{
+	ssize_t received_bytes;
+
+	while (true)
+	{
+		syscalls++;
+		received_bytes = ::recv(sock, buf, len, 0);
+		trace_ring().record(TRACE_RECV, (uint32_t)syscalls, (uint32_t)len, (int32_t)received_bytes,
+			(received_bytes == -1) ? errno : 0);
+		if (received_bytes >= 0)
+		{
+			co_return received_bytes;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			if (!co_await readable(deadline_ns))
+			{
+				errno = ETIMEDOUT;
+				co_return -1;
+			}
+		}
+		else if (errno != EINTR)
+		{
+			co_return -1;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		Executor
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		Executor()
+--
+--	NOTES:
+--	Creates the epoll instance and the timerfd of the sleeping coroutines.
+----------------------------------------------------------------------------------------------------------------------*/
+Executor::Executor()
+{
+	struct epoll_event event;
+
+	if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+	{
+		perror("epoll_create1() failed");
+		return;
+	}
+	if ((timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) == -1)
+	{
+		perror("timerfd_create() failed");
+		return;
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.fd = timer_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		~Executor
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		~Executor()
+----------------------------------------------------------------------------------------------------------------------*/
+Executor::~Executor()
+{
+	if (timer_fd != -1)
+		close(timer_fd);
+	if (epoll_fd != -1)
+		close(epoll_fd);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		add
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		add(AsyncSocket *conn)
+--						AsyncSocket *conn: Socket to watch
+--
+--	RETURNS:		bool - true if the socket was registered.
+--
+--	NOTES:
+--	The events carry the descriptor, and the socket is looked up by it, so an event of a socket removed earlier in
+--	the same batch is dropped instead of reaching freed memory.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Executor::add(AsyncSocket *conn)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.fd = conn->sock;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->sock, &event) == -1)
+	{
+		perror("epoll_ctl() failed");
+		return false;
+	}
+
+	if ((size_t)conn->sock >= sockets.size())
+	{
+		sockets.resize(conn->sock + 1, NULL);
+	}
+	sockets[conn->sock] = conn;
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		remove
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		remove(AsyncSocket *conn)
+--						AsyncSocket *conn: Socket to stop watching
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void Executor::remove(AsyncSocket *conn)
+{
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->sock, NULL);
+	if ((size_t)conn->sock < sockets.size() && sockets[conn->sock] == conn)
+	{
+		sockets[conn->sock] = NULL;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		await_ready
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		await_ready()
+--
+--	RETURNS:		bool - true if the due time has passed, so the coroutine does not suspend.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Executor::Sleep::await_ready() const noexcept
+{
+	return due_ns <= monotonic_ns();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		await_suspend
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Queue the timer with add_timer]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		await_suspend(std::coroutine_handle<> waiting)
+--						std::coroutine_handle<> waiting: Coroutine to resume at the due time
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void Executor::Sleep::await_suspend(std::coroutine_handle<> waiting)
+{
+	executor.add_timer({ due_ns, waiting, INVALID_SOCKET, 0 });
+	executor.waiting++;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		add_timer
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		add_timer(const ExecutorTimer &timer)
+--						const ExecutorTimer &timer: Sleep or read deadline to wait for
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Queues the timer and rearms the timerfd if it is now the earliest.
+----------------------------------------------------------------------------------------------------------------------*/
+void Executor::add_timer(const ExecutorTimer &timer)
+{
+	bool earliest = timers.empty() || timer.due_ns < timers.top().due_ns;
+
+	timers.push(timer);
+	if (earliest)
+	{
+		arm_timer();
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		arm_timer
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		arm_timer()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sets the timerfd to PACE_SPIN_NS before the earliest due time, or disarms it when no coroutine sleeps. The
+--	timerfd fires up to the timer slack late, so run() spins the rest of the way, as pace_until does.
+----------------------------------------------------------------------------------------------------------------------*/
+void Executor::arm_timer()
+{
+	struct itimerspec expiry;
+
+	memset(&expiry, 0, sizeof(expiry));
+	if (!timers.empty())
+	{
+		uint64_t due_ns = (timers.top().due_ns > PACE_SPIN_NS) ? timers.top().due_ns - PACE_SPIN_NS : 0;
+
+		// A Zero Value would Disarm the Timer
+		expiry.it_value.tv_sec = (time_t)(due_ns / 1000000000ULL);
+		expiry.it_value.tv_nsec = (long)(due_ns % 1000000000ULL);
+		if (due_ns == 0)
+			expiry.it_value.tv_nsec = 1;
+	}
+	timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &expiry, NULL);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		run
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Stop after an optional timeout]
+--					October 17, 2026 [End read waits at their deadline]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		run(int timeout_ms)
+--						int timeout_ms: Longest time to run, or -1 to run until no coroutine is waiting
+--
+--	RETURNS:		bool - false if coroutines were still waiting when the timeout expired.
+--
+--	NOTES:
+--	Waits on epoll and resumes the coroutines whose socket became ready or whose timer expired, until none is
+--	waiting. The handles are taken off a socket before any is resumed, since a resumed coroutine may finish and
+--	destroy the socket. A coroutine still waiting at the timeout is never resumed: its Task and its AsyncSocket
+--	must be destroyed without running the Executor again.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Executor::run(int timeout_ms)
+{
+	struct epoll_event events[MAXEVENTS];
+	std::vector<ExecutorTimer> expired;
+	uint64_t deadline_ns = (timeout_ms >= 0) ? monotonic_ns() + timeout_ms * 1000000ULL : 0;
+	int wait_ms = -1;
+	int ready;
+
+	while (waiting > 0)
+	{
+		if (timeout_ms >= 0)
+		{
+			uint64_t now_ns = monotonic_ns();
+
+			if (now_ns >= deadline_ns)
+			{
+				return false;
+			}
+			wait_ms = (int)((deadline_ns - now_ns + 999999) / 1000000);
+		}
+		if ((ready = epoll_wait(epoll_fd, events, MAXEVENTS, wait_ms)) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("epoll_wait() failed");
+			break;
+		}
+
+		for (int i = 0; i < ready; i++)
+		{
+			int fd = events[i].data.fd;
+			uint32_t flags = events[i].events;
+
+			// Sleeping Coroutines
+			if (fd == timer_fd)
+			{
+				uint64_t count;
+				uint64_t now_ns = monotonic_ns();
+
+				while (read(timer_fd, &count, sizeof(count)) > 0);
+				expired.clear();
+				while (!timers.empty() && timers.top().due_ns <= now_ns + PACE_SPIN_NS)
+				{
+					expired.push_back(timers.top());
+					timers.pop();
+				}
+				arm_timer();
+				for (ExecutorTimer &timer : expired)
+				{
+					// A Read Deadline Ends its Wait only if the Socket has not Woken it yet
+					if (timer.sock != INVALID_SOCKET)
+					{
+						AsyncSocket *conn = ((size_t)timer.sock < sockets.size()) ? sockets[timer.sock] : NULL;
+
+						if (conn == NULL || !conn->reader || conn->read_wait != timer.wait_id)
+						{
+							continue;
+						}
+						conn->reader = nullptr;
+						conn->read_wait = 0;
+						conn->timed_out = true;
+					}
+					pace_until(timer.due_ns);
+					waiting--;
+					wakeup_count++;
+					timer.waiting.resume();
+				}
+				continue;
+			}
+
+			// Coroutines Waiting on a Socket
+			if ((size_t)fd >= sockets.size() || sockets[fd] == NULL)
+			{
+				continue;
+			}
+
+			AsyncSocket *conn = sockets[fd];
+			std::coroutine_handle<> writer, reader;
+
+			if ((flags & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && conn->writer)
+			{
+				writer = std::exchange(conn->writer, nullptr);
+				waiting--;
+			}
+			if ((flags & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP)) && conn->reader)
+			{
+				reader = std::exchange(conn->reader, nullptr);
+				conn->read_wait = 0;
+				waiting--;
+			}
+			if (writer)
+			{
+				wakeup_count++;
+				writer.resume();
+			}
+			if (reader)
+			{
+				wakeup_count++;
+				reader.resume();
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "transport.h"
+#include <coroutine>
+#include <exception>
+#include <queue>
+#include <utility>
+#include <sys/uio.h>
+#include <stdint.h>
+
+class Executor;
+
+// Coroutine Returning a T: started when awaited (or by Executor::spawn), resumes its awaiter when it returns
+template <typename T>
+class Task
+{
+	public:
+		struct promise_type
+		{
+			T value{};
+			std::coroutine_handle<> continuation;
+
+			// Hand Control back to the Awaiting Coroutine, or to the Executor
+			struct FinalAwaiter
+			{
+				bool await_ready() noexcept { return false; };
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> done) noexcept
+				{
+					std::coroutine_handle<> next = done.promise().continuation;
+					return next ? next : std::noop_coroutine();
+				};
+				void await_resume() noexcept {};
+			};
+
+			Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); };
+			std::suspend_always initial_suspend() noexcept { return {}; };
+			FinalAwaiter final_suspend() noexcept { return {}; };
+			void return_value(T result) { value = std::move(result); };
+			void unhandled_exception() { std::terminate(); };
+		};
+
+		Task() {};
+		explicit Task(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {};
+		Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {};
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other)
+			{
+				if (handle)
+					handle.destroy();
+				handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		};
+		Task(const Task &) = delete;
+		Task &operator=(const Task &) = delete;
+		~Task() { if (handle) handle.destroy(); };
+
+		bool done() const { return !handle || handle.done(); };
+		T result() const { return handle.promise().value; };
+
+		// co_await task
+		bool await_ready() const noexcept { return false; };
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+		{
+			handle.promise().continuation = awaiting;
+			return handle;
+		};
+		T await_resume() { return std::move(handle.promise().value); };
+	private:
+		friend class Executor;
+		std::coroutine_handle<promise_type> handle;
+};
+
+// Non-Blocking Socket Driven by an Executor: co_await conn.send(buf, len), co_await conn.recv(buf, len, deadline_ns)
+class AsyncSocket
+{
+	public:
+		AsyncSocket(Executor &executor, SOCKET sock);
+		~AsyncSocket();
+		AsyncSocket(const AsyncSocket &) = delete;
+		AsyncSocket &operator=(const AsyncSocket &) = delete;
+		Task<long long> send(const char *buf, int len);
+		Task<long long> send(struct iovec *iov, int count);
+		Task<long long> recv(char *buf, int len, uint64_t deadline_ns = 0);
+		SOCKET socket() const { return sock; };
+		long long calls() const { return syscalls; };
+
+		// Suspends until the Socket is Readable or Writable (Edge Triggered, so only after EAGAIN), or the Deadline
+		struct Readiness
+		{
+			AsyncSocket &conn;
+			bool write;
+			uint64_t deadline_ns;
+			bool await_ready() const noexcept { return false; };
+			void await_suspend(std::coroutine_handle<> waiting);
+			bool await_resume() const noexcept { return write || !conn.timed_out; };
+		};
+		Readiness readable(uint64_t deadline_ns = 0) { return Readiness{ *this, false, deadline_ns }; };
+		Readiness writable() { return Readiness{ *this, true, 0 }; };
+	private:
+		friend class Executor;
+		Executor &executor;
+		SOCKET sock;
+		long long syscalls = 0;
+		std::coroutine_handle<> reader;
+		std::coroutine_handle<> writer;
+		uint64_t read_wait = 0;
+		bool timed_out = false;
+};
+
+// Timer Waiting in the Executor: a Sleep, or the Deadline of Read Wait wait_id on sock
+struct ExecutorTimer
+{
+	uint64_t due_ns;
+	std::coroutine_handle<> waiting;
+	SOCKET sock;
+	uint64_t wait_id;
+	bool operator>(const ExecutorTimer &other) const { return due_ns > other.due_ns; };
+};
+
+// Single-Threaded epoll Executor of the Coroutines of a Transfer
+class Executor
+{
+	public:
+		Executor();
+		~Executor();
+		bool is_ready() const { return epoll_fd != -1 && timer_fd != -1; };
+		template <typename T> void spawn(Task<T> &task) { task.handle.resume(); };
+		bool run(int timeout_ms = -1);
+		long long wakeups() const { return wakeup_count; };
+
+		// co_await executor.sleep_until(due_ns) (monotonic clock)
+		struct Sleep
+		{
+			Executor &executor;
+			uint64_t due_ns;
+			bool await_ready() const noexcept;
+			void await_suspend(std::coroutine_handle<> waiting);
+			void await_resume() const noexcept {};
+		};
+		Sleep sleep_until(uint64_t due_ns) { return Sleep{ *this, due_ns }; };
+	private:
+		friend class AsyncSocket;
+		bool add(AsyncSocket *conn);
+		void remove(AsyncSocket *conn);
+		void arm_timer();
+		void add_timer(const ExecutorTimer &timer);
+		int epoll_fd = -1;
+		int timer_fd = -1;
+		int waiting = 0;
+		long long wakeup_count = 0;
+		uint64_t last_wait_id = 0;
+		std::vector<AsyncSocket *> sockets;
+		std::priority_queue<ExecutorTimer, std::vector<ExecutorTimer>, std::greater<ExecutorTimer>> timers;
+};
@@ -0,0 +1,381 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	crc32c.cpp - CRC32C (Castagnoli) checksums, with the SSE4.2 crc32 instruction and PCLMUL folding
+--								where the CPU has them
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					uint32_t crc32c(uint32_t crc, const void *data, size_t len)
+--					const char *crc32c_engine()
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The checksums of --verify. crc32c(0, data, len) is the standard CRC32C (iSCSI, ext4), and passing the result of
+--	one call as the crc of the next continues it over the following data.
+--
+--	The crc32 instruction of SSE4.2 takes 8 Bytes per call, but each call waits for the result of the previous one.
+--	Long buffers are therefore split into three lanes that are checksummed side by side, and the three results are
+--	folded into one: a lane's CRC is moved past the lanes that follow it by one carry-less multiplication (PCLMUL)
+--	with a constant x^(8n-33) mod P, reduced by one more crc32 instruction. The CPU is checked once at run time, so
+--	the same build falls back to a table lookup per Byte on CPUs without SSE4.2 and PCLMUL, and on other targets.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "crc32c.h"
+#include <string.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#define CRC32C_X86
+#endif
+
+// Reflected CRC32C Polynomial
+#define CRC32C_POLY 0x82F63B78
+
+// Lane Lengths of the Three-Way Interleave (long buffers, then the rest)
+#define CRC32C_LONG_LANE 8192
+#define CRC32C_SHORT_LANE 256
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		multiply_mod
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		multiply_mod(uint32_t a, uint32_t b)
+--						uint32_t a: Polynomial, reflected
+--						uint32_t b: Polynomial, reflected
+--
+--	RETURNS:		uint32_t - a * b mod P.
+--
+--	NOTES:
+--	Bit by bit, so it is only used for the folding constants.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t multiply_mod(uint32_t a, uint32_t b)
+{
+	uint32_t product = 0;
+
+	for (uint32_t bit = 1u << 31; bit != 0; bit >>= 1)
+	{
+		if (a & bit)
+		{
+			product ^= b;
+		}
+		b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+	}
+
+	return product;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		power_mod
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		power_mod(uint64_t n)
+--						uint64_t n: Exponent
+--
+--	RETURNS:		uint32_t - x^n mod P, reflected.
+--
+--	NOTES:
+--	Square and multiply: x^(2^k) is squared from x^(2^(k-1)) for every bit of n.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t power_mod(uint64_t n)
+{
+	uint32_t result = 1u << 31;
+	uint32_t square = 1u << 30;
+
+	while (n > 0)
+	{
+		if (n & 1)
+		{
+			result = multiply_mod(square, result);
+		}
+		square = multiply_mod(square, square);
+		n >>= 1;
+	}
+
+	return result;
+}
+
+// Byte Table of the Software CRC
+struct Crc32cTable
+{
+	uint32_t entry[256];
+
+	Crc32cTable()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t crc = i;
+			for (int bit = 0; bit < 8; bit++)
+			{
+				crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+			}
+			entry[i] = crc;
+		}
+	}
+};
+
+static const Crc32cTable crc32c_table;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		crc32c_software
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		crc32c_software(uint32_t state, const unsigned char *data, size_t len)
+--						uint32_t state: CRC register before the data
+--						const unsigned char *data: Data to checksum
+--						size_t len: Length of the data in Bytes
+--
+--	RETURNS:		uint32_t - the CRC register after the data.
+--
+--	NOTES:
+--	One table lookup per Byte.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t crc32c_software(uint32_t state, const unsigned char *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		state = crc32c_table.entry[(state ^ data[i]) & 0xFF] ^ (state >> 8);
+	}
+
+	return state;
+}
+
+#ifdef CRC32C_X86
+// Folding Constants of the Lane Lengths, x^(8n-33) mod P
+struct Crc32cFold
+{
+	uint64_t long_lane;
+	uint64_t short_lane;
+	bool hardware;
+
+	Crc32cFold()
+	{
+		long_lane = power_mod(8 * CRC32C_LONG_LANE - 33);
+		short_lane = power_mod(8 * CRC32C_SHORT_LANE - 33);
+		hardware = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+	}
+};
+
+static const Crc32cFold crc32c_fold;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		fold_lane
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		fold_lane(uint32_t state, uint64_t constant)
+--						uint32_t state: CRC register at the end of a lane
+--						uint64_t constant: Folding constant of the lane length
+--
+--	RETURNS:		uint32_t - the register moved past one more lane of zeros.
+--
+--	NOTES:
+--	The carry-less product of the register and x^(8n-33) is x * state * x^(8n-33) in the crc32 instruction's bit
+--	order, and the instruction reduces it times x^32, leaving state * x^(8n) mod P.
+----------------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t fold_lane(uint32_t state, uint64_t constant)
+{
+	__m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)state), _mm_cvtsi64_si128((long long)constant), 0);
+
+	return (uint32_t)_mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(product));
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		crc32c_lanes
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		crc32c_lanes(uint32_t state, const unsigned char *&data, size_t &len, size_t lane, uint64_t constant)
+--						uint32_t state: CRC register before the data
+--						const unsigned char *&data: Data to checksum, advanced past the Bytes taken
+--						size_t &len: Length of the data, reduced by the Bytes taken
+--						size_t lane: Lane length in Bytes (a multiple of 8)
+--						uint64_t constant: Folding constant of the lane length
+--
+--	RETURNS:		uint32_t - the CRC register after the Bytes taken.
+--
+--	NOTES:
+--	Takes blocks of three lanes while the data lasts. The second and third lanes start from a zero register, and the
+--	CRC is linear, so folding the first lane past the second and XORing gives the register after both, and so on.
+----------------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_lanes(uint32_t state, const unsigned char *&data, size_t &len, size_t lane, uint64_t constant)
+{
+	while (len >= 3 * lane)
+	{
+		uint64_t crc0 = state;
+		uint64_t crc1 = 0;
+		uint64_t crc2 = 0;
+		uint64_t word0, word1, word2;
+
+		for (size_t i = 0; i < lane; i += 8)
+		{
+			memcpy(&word0, data + i, 8);
+			memcpy(&word1, data + lane + i, 8);
+			memcpy(&word2, data + 2 * lane + i, 8);
+			crc0 = _mm_crc32_u64(crc0, word0);
+			crc1 = _mm_crc32_u64(crc1, word1);
+			crc2 = _mm_crc32_u64(crc2, word2);
+		}
+
+		state = fold_lane((uint32_t)crc0, constant) ^ (uint32_t)crc1;
+		state = fold_lane(state, constant) ^ (uint32_t)crc2;
+		data += 3 * lane;
+		len -= 3 * lane;
+	}
+
+	return state;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		crc32c_hardware
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		crc32c_hardware(uint32_t state, const unsigned char *data, size_t len)
+--						uint32_t state: CRC register before the data
+--						const unsigned char *data: Data to checksum
+--						size_t len: Length of the data in Bytes
+--
+--	RETURNS:		uint32_t - the CRC register after the data.
+--
+--	NOTES:
+--	Long lanes, then short lanes, then 8 Bytes and single Bytes at a time for the rest.
+----------------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_hardware(uint32_t state, const unsigned char *data, size_t len)
+{
+	uint64_t word;
+	uint64_t crc;
+
+	state = crc32c_lanes(state, data, len, CRC32C_LONG_LANE, crc32c_fold.long_lane);
+	state = crc32c_lanes(state, data, len, CRC32C_SHORT_LANE, crc32c_fold.short_lane);
+
+	crc = state;
+	for (; len >= 8; data += 8, len -= 8)
+	{
+		memcpy(&word, data, 8);
+		crc = _mm_crc32_u64(crc, word);
+	}
+	state = (uint32_t)crc;
+	for (; len > 0; data++, len--)
+	{
+		state = _mm_crc32_u8(state, *data);
+	}
+
+	return state;
+}
+#endif
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		crc32c
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		crc32c(uint32_t crc, const void *data, size_t len)
+--						uint32_t crc: CRC of the data before, 0 to start
+--						const void *data: Data to checksum
+--						size_t len: Length of the data in Bytes
+--
+--	RETURNS:		uint32_t - the CRC32C of the data before and this data.
+--
+--	NOTES:
+--	The register is inverted before and after the data, as the standard CRC32C is.
+----------------------------------------------------------------------------------------------------------------------*/
+uint32_t crc32c(uint32_t crc, const void *data, size_t len)
+{
+#ifdef CRC32C_X86
+	if (crc32c_fold.hardware)
+	{
+		return ~crc32c_hardware(~crc, (const unsigned char *)data, len);
+	}
+#endif
+
+	return ~crc32c_software(~crc, (const unsigned char *)data, len);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		crc32c_engine
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		crc32c_engine()
+--
+--	RETURNS:		const char * - the name of the implementation crc32c uses on this CPU.
+--
+--	NOTES:
+--	For the reports.
+----------------------------------------------------------------------------------------------------------------------*/
+const char *crc32c_engine()
+{
+#ifdef CRC32C_X86
+	if (crc32c_fold.hardware)
+	{
+		return "SSE4.2 + PCLMUL";
+	}
+#endif
+
+	return "table";
+}
+
+#endif
@@ -0,0 +1,500 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	disk_sink.cpp - Saves the data received by the Server to a file
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					bool open(const std::string &path, SinkMode sink_mode)
+--					bool write(const char *data, size_t len)
+--					bool close()
+--					void discard()
+--					void report(TransferResult &result)
+--					void append_report(std::string &print_output)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The receive paths count the received bytes and discard them. The DiskSink persists them instead, with one of
+--	three strategies:
+--
+--		buffered	write() into the page cache, with an fdatasync every SINK_SYNC_INTERVAL Bytes.
+--		mmap		The file is extended one SINK_MMAP_WINDOW at a time with fallocate, the window is mapped and the
+--					data is copied into it. Full windows are synced and unmapped.
+--		direct		O_DIRECT writes from a SINK_ALIGNMENT aligned staging buffer of SINK_DIRECT_BUFFER Bytes, which
+--					bypass the page cache. The last partial block is padded and the file truncated to its real size.
+--
+--	Every strategy syncs the file when it is closed. The time spent in the sink (copying, writing, syncing) is
+--	measured on its own, so the disk write throughput can be compared with the network throughput of the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "disk_sink.h"
+#include "timing.h"
+#include "recv_pool.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		open
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Clear the discarded flag]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		open(const std::string &path, SinkMode sink_mode)
+--						const std::string &path: File the received data is written to (created or truncated)
+--						SinkMode sink_mode: Write strategy
+--
+--	RETURNS:		bool - false if the file could not be opened.
+--
+--	NOTES:
+--	Opens the file for a new transfer. A sink that is still open is closed first.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::open(const std::string &path, SinkMode sink_mode)
+{
+	int flags = O_RDWR | O_CREAT | O_TRUNC;
+
+	close();
+
+	mode = sink_mode;
+	file_path = path;
+	failed = false;
+	discarded = false;
+	written = 0;
+	unsynced = 0;
+	disk_ns = 0;
+	window_offset = 0;
+	window_used = 0;
+	direct_used = 0;
+
+	if (mode == SINK_DIRECT)
+	{
+		flags |= O_DIRECT;
+		if (posix_memalign((void **)&direct_buf, SINK_ALIGNMENT, SINK_DIRECT_BUFFER) != 0)
+		{
+			direct_buf = NULL;
+			fprintf(stderr, "Cannot allocate the direct I/O buffer\n");
+			return false;
+		}
+	}
+
+	if ((fd = ::open(path.c_str(), flags, 0644)) == -1)
+	{
+		perror("Cannot open save file");
+		free(direct_buf);
+		direct_buf = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		write
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Count the staging copies in bytes touched per byte received]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		write(const char *data, size_t len)
+--						const char *data: Received data
+--						size_t len: Number of bytes received
+--
+--	RETURNS:		bool - false if the data could not be written. The sink stops writing after the first error.
+--
+--	NOTES:
+--	Appends received data to the file with the strategy of the sink.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::write(const char *data, size_t len)
+{
+	uint64_t start = monotonic_ns();
+
+	if (fd == -1 || failed)
+	{
+		return false;
+	}
+
+	while (len > 0 && !failed)
+	{
+		size_t chunk = len;
+		ssize_t result;
+
+		switch (mode)
+		{
+		case SINK_BUFFERED:
+			if ((result = ::write(fd, data, len)) == -1)
+			{
+				if (errno == EINTR)
+					continue;
+				perror("write() to save file failed");
+				failed = true;
+				break;
+			}
+			chunk = (size_t)result;
+			unsynced += chunk;
+			if (unsynced >= SINK_SYNC_INTERVAL)
+			{
+				fdatasync(fd);
+				unsynced = 0;
+			}
+			break;
+		case SINK_MMAP:
+			if (window == NULL && !map_window())
+				break;
+			if (chunk > SINK_MMAP_WINDOW - window_used)
+				chunk = SINK_MMAP_WINDOW - window_used;
+			memcpy(window + window_used, data, chunk);
+			recv_pool().record_copied(chunk);
+			window_used += chunk;
+			if (window_used == SINK_MMAP_WINDOW)
+				unmap_window(true);
+			break;
+		case SINK_DIRECT:
+			if (chunk > SINK_DIRECT_BUFFER - direct_used)
+				chunk = SINK_DIRECT_BUFFER - direct_used;
+			memcpy(direct_buf + direct_used, data, chunk);
+			recv_pool().record_copied(chunk);
+			direct_used += chunk;
+			if (direct_used == SINK_DIRECT_BUFFER)
+				flush_direct(false);
+			break;
+		}
+
+		if (failed)
+		{
+			break;
+		}
+		data += chunk;
+		len -= chunk;
+		written += chunk;
+	}
+
+	disk_ns += monotonic_ns() - start;
+	return !failed;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		map_window
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		map_window()
+--
+--	RETURNS:		bool - false if the file could not be extended or mapped.
+--
+--	NOTES:
+--	Preallocates the next SINK_MMAP_WINDOW Bytes of the file and maps them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::map_window()
+{
+	void *mapping;
+
+	if (fallocate(fd, 0, window_offset, SINK_MMAP_WINDOW) == -1 && ftruncate(fd, window_offset + SINK_MMAP_WINDOW) == -1)
+	{
+		perror("Cannot extend save file");
+		failed = true;
+		return false;
+	}
+
+	if ((mapping = mmap(NULL, SINK_MMAP_WINDOW, PROT_WRITE, MAP_SHARED, fd, window_offset)) == MAP_FAILED)
+	{
+		perror("Cannot map save file");
+		failed = true;
+		return false;
+	}
+
+	window = (char *)mapping;
+	window_used = 0;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		unmap_window
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		unmap_window(bool sync)
+--						bool sync: Write the window back to the disk before unmapping it
+--
+--	RETURNS:		bool - false if the window could not be synced.
+--
+--	NOTES:
+--	Ends the current mmap window and moves the window offset past it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::unmap_window(bool sync)
+{
+	bool success = true;
+
+	if (window == NULL)
+	{
+		return true;
+	}
+
+	if (sync && msync(window, window_used, MS_SYNC) == -1)
+	{
+		perror("msync() of save file failed");
+		failed = true;
+		success = false;
+	}
+
+	munmap(window, SINK_MMAP_WINDOW);
+	window = NULL;
+	window_offset += window_used;
+	window_used = 0;
+	return success;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		flush_direct
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Count the O_DIRECT padding in bytes touched per byte received]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		flush_direct(bool final_block)
+--						bool final_block: The staging buffer holds the end of the stream and may be partial
+--
+--	RETURNS:		bool - false if the write failed.
+--
+--	NOTES:
+--	Writes the staging buffer with O_DIRECT. O_DIRECT writes must be a multiple of SINK_ALIGNMENT long, so the final
+--	partial buffer is padded with zeros; close truncates the padding away.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::flush_direct(bool final_block)
+{
+	size_t len = direct_used;
+	size_t offset = 0;
+	ssize_t result;
+
+	if (final_block)
+	{
+		len = (direct_used + SINK_ALIGNMENT - 1) / SINK_ALIGNMENT * SINK_ALIGNMENT;
+		memset(direct_buf + direct_used, 0, len - direct_used);
+		recv_pool().record_copied(len - direct_used);
+	}
+
+	while (offset < len)
+	{
+		if ((result = ::write(fd, direct_buf + offset, len - offset)) == -1)
+		{
+			if (errno == EINTR)
+				continue;
+			perror("O_DIRECT write() to save file failed");
+			failed = true;
+			return false;
+		}
+		offset += result;
+	}
+
+	direct_used = 0;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		close
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		close()
+--
+--	RETURNS:		bool - false if the end of the data could not be written or synced.
+--
+--	NOTES:
+--	Writes out whatever the strategy still holds, trims the file to the number of bytes received and syncs it. The
+--	time this takes is part of the disk write time.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DiskSink::close()
+{
+	uint64_t start;
+
+	if (fd == -1)
+	{
+		return !failed;
+	}
+
+	start = monotonic_ns();
+
+	switch (mode)
+	{
+	case SINK_BUFFERED:
+		break;
+	case SINK_MMAP:
+		unmap_window(true);
+		break;
+	case SINK_DIRECT:
+		if (direct_used > 0 && !failed)
+			flush_direct(true);
+		break;
+	}
+
+	// Remove the Preallocated Window or the Direct I/O Padding
+	if (mode != SINK_BUFFERED && ftruncate(fd, written) == -1)
+	{
+		perror("ftruncate() of save file failed");
+		failed = true;
+	}
+
+	if (fdatasync(fd) == -1)
+	{
+		perror("fdatasync() of save file failed");
+		failed = true;
+	}
+
+	::close(fd);
+	fd = -1;
+	free(direct_buf);
+	direct_buf = NULL;
+
+	disk_ns += monotonic_ns() - start;
+	return !failed;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		discard
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		discard()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Closes the file without syncing it and removes it, for a transfer whose data cannot be saved as one stream. The
+--	report of the transfer says the file was discarded.
+----------------------------------------------------------------------------------------------------------------------*/
+void DiskSink::discard()
+{
+	if (fd == -1)
+	{
+		return;
+	}
+
+	if (window != NULL)
+	{
+		munmap(window, SINK_MMAP_WINDOW);
+		window = NULL;
+	}
+
+	::close(fd);
+	fd = -1;
+	free(direct_buf);
+	direct_buf = NULL;
+
+	if (unlink(file_path.c_str()) == -1)
+	{
+		perror("Cannot remove save file");
+	}
+	discarded = true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Receives the disk write statistics
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Copies the disk write time and throughput into the result of a transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void DiskSink::report(TransferResult &result) const
+{
+	result.disk_ms = disk_ns / 1e6;
+	result.disk_mbps = (disk_ns > 0) ? (written * 8.0 * 1000.0) / disk_ns : 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Report a discarded file]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the statistics are appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the disk write statistics of the last transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void DiskSink::append_report(std::string &print_output) const
+{
+	static const char *mode_names[] = { "buffered", "mmap", "direct" };
+	char line[BUFFERSIZE * 2];
+
+	if (discarded)
+	{
+		snprintf(line, sizeof(line), "\nNot Saved: %s (discarded, the transfer had several connections)",
+			file_path.c_str());
+		print_output += line;
+		return;
+	}
+
+	snprintf(line, sizeof(line), "\nSaved to: %s (%s%s)", file_path.c_str(), mode_names[mode],
+		failed ? ", write failed" : "");
+	print_output += line;
+	snprintf(line, sizeof(line), "\nDisk Write Time: %.3f ms", disk_ns / 1e6);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nDisk Throughput: %.2f Mbit/s",
+		(disk_ns > 0) ? (written * 8.0 * 1000.0) / disk_ns : 0);
+	print_output += line;
+}
+
+#endif
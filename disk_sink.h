@@ -0,0 +1,41 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+#define SINK_ALIGNMENT 4096
+#define SINK_MMAP_WINDOW (64 * 1024 * 1024)
+#define SINK_DIRECT_BUFFER (4 * 1024 * 1024)
+#define SINK_SYNC_INTERVAL (64 * 1024 * 1024)
+
+// Writes a Received Stream to a File
+class DiskSink
+{
+	public:
+		DiskSink() {};
+		~DiskSink() { close(); };
+		bool open(const std::string &path, SinkMode sink_mode);
+		bool write(const char *data, size_t len);
+		bool close();
+		void discard();
+		bool is_open() const { return fd != -1; };
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output) const;
+	private:
+		bool map_window();
+		bool unmap_window(bool sync);
+		bool flush_direct(bool final_block);
+		SinkMode mode = SINK_BUFFERED;
+		std::string file_path;
+		int fd = -1;
+		bool failed = false;
+		bool discarded = false;
+		long long written = 0;
+		long long unsynced = 0;
+		uint64_t disk_ns = 0;
+		char *window = NULL;
+		long long window_offset = 0;
+		size_t window_used = 0;
+		char *direct_buf = NULL;
+		size_t direct_used = 0;
+};
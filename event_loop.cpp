@@ -0,0 +1,273 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	event_loop.cpp - An epoll event loop that dispatches socket events on POSIX systems
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					EventLoop()
+--					~EventLoop()
+--					bool async_select(SOCKET sock, int events)
+--					void remove(SOCKET sock)
+--					void run(EventHandler handler, int idle_ms)
+--					void stop()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	On Windows, socket events are delivered to WndProc as WM_SOCKET messages registered with WSAAsyncSelect. The
+--	EventLoop replaces the window message pump on POSIX systems. Sockets are registered with async_select for the
+--	events they are interested in, and run() waits on epoll and dispatches each event to the handler with the socket
+--	that triggered it, in the same way WndProc receives the socket in wParam and the event in lParam.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "event_loop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		EventLoop
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		EventLoop()
+--
+--	NOTES:
+--	Creates the epoll instance and an eventfd that is used to wake the loop up when stop() is called from another
+--	thread.
+----------------------------------------------------------------------------------------------------------------------*/
+EventLoop::EventLoop() : running(true)
+{
+	struct epoll_event event;
+
+	if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+	{
+		perror("epoll_create1() failed");
+	}
+
+	if ((wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1)
+	{
+		perror("eventfd() failed");
+		return;
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.u64 = (uint64_t)(uint32_t)wake_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		~EventLoop
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		~EventLoop()
+--
+--	NOTES:
+--	Closes the epoll instance and the wake up eventfd. Registered sockets are owned by the caller.
+----------------------------------------------------------------------------------------------------------------------*/
+EventLoop::~EventLoop()
+{
+	close(wake_fd);
+	close(epoll_fd);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		async_select
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		async_select(SOCKET sock, int events)
+--						SOCKET sock: The socket to watch
+--						int events: SocketEvent flags the caller is interested in
+--
+--	RETURNS:		bool - true if the socket was registered.
+--
+--	NOTES:
+--	The POSIX equivalent of WSAAsyncSelect. The requested events are stored alongside the socket in the epoll data
+--	so that run() can tell a listening socket (EVENT_ACCEPT) from a connected one (EVENT_READ). Calling it again on
+--	the same socket replaces the events.
+----------------------------------------------------------------------------------------------------------------------*/
+bool EventLoop::async_select(SOCKET sock, int events)
+{
+	struct epoll_event event;
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.u64 = ((uint64_t)events << 32) | (uint32_t)sock;
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &event) == -1)
+	{
+		if (errno != EEXIST || epoll_ctl(epoll_fd, EPOLL_CTL_MOD, sock, &event) == -1)
+		{
+			perror("epoll_ctl() failed");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		remove
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		remove(SOCKET sock)
+--						SOCKET sock: The socket to stop watching
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Stops dispatching events for the socket. Closing a socket also removes it from epoll, so this is only needed
+--	when the socket stays open.
+----------------------------------------------------------------------------------------------------------------------*/
+void EventLoop::remove(SOCKET sock)
+{
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock, NULL);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		run
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		run(EventHandler handler, int idle_ms)
+--						EventHandler handler: Called for every socket event
+--						int idle_ms: Dispatch EVENT_IDLE after this many ms without events (-1 to disable)
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Waits on epoll and dispatches events until stop() is called. Readable data is always dispatched as EVENT_READ
+--	(or EVENT_ACCEPT for listening sockets) before a hang up so that the handler can drain the socket and see the
+--	end of stream itself. EVENT_CLOSE is only dispatched when there is nothing left to read.
+----------------------------------------------------------------------------------------------------------------------*/
+void EventLoop::run(EventHandler handler, int idle_ms)
+{
+	struct epoll_event events[MAXEVENTS];
+	int ready;
+
+	while (running)
+	{
+		if ((ready = epoll_wait(epoll_fd, events, MAXEVENTS, idle_ms)) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("epoll_wait() failed");
+			break;
+		}
+
+		if (ready == 0)
+		{
+			handler(INVALID_SOCKET, EVENT_IDLE);
+			continue;
+		}
+
+		for (int i = 0; i < ready && running; i++)
+		{
+			SOCKET sock = (SOCKET)(uint32_t)events[i].data.u64;
+			int selected = (int)(events[i].data.u64 >> 32);
+
+			if (sock == wake_fd)
+			{
+				uint64_t count;
+				while (read(wake_fd, &count, sizeof(count)) > 0);
+				continue;
+			}
+
+			// Dispatch the Event
+			if ((events[i].events & EPOLLIN) && (selected & EVENT_ACCEPT))
+			{
+				handler(sock, EVENT_ACCEPT);
+			}
+			else if ((events[i].events & EPOLLIN) && (selected & EVENT_READ))
+			{
+				handler(sock, EVENT_READ);
+			}
+			else if (events[i].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))
+			{
+				remove(sock);
+				if (selected & EVENT_CLOSE)
+				{
+					handler(sock, EVENT_CLOSE);
+				}
+			}
+		}
+	}
+
+	// Allow the Loop to be Run Again
+	running = true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		stop
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		stop()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Makes run() return after the event currently being dispatched. Safe to call from the handler or from another
+--	thread, including before run() has started.
+----------------------------------------------------------------------------------------------------------------------*/
+void EventLoop::stop()
+{
+	uint64_t count = 1;
+
+	running = false;
+	if (write(wake_fd, &count, sizeof(count)) == -1)
+	{
+		perror("eventfd write failed");
+	}
+}
+
+#endif
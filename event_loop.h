@@ -0,0 +1,34 @@
+#pragma once
+
+#include "transport.h"
+#include <atomic>
+#include <functional>
+
+#define MAXEVENTS 64
+
+// Socket Events (the POSIX equivalent of FD_ACCEPT/FD_READ/FD_CLOSE)
+enum SocketEvent
+{
+	EVENT_ACCEPT = 0x01,
+	EVENT_READ = 0x02,
+	EVENT_CLOSE = 0x04,
+	EVENT_IDLE = 0x08
+};
+
+// Event Handler (the POSIX equivalent of the WM_SOCKET case in WndProc)
+typedef std::function<void(SOCKET sock, int event)> EventHandler;
+
+class EventLoop
+{
+	public:
+		EventLoop();
+		~EventLoop();
+		bool async_select(SOCKET sock, int events);
+		void remove(SOCKET sock);
+		void run(EventHandler handler, int idle_ms = -1);
+		void stop();
+	private:
+		int epoll_fd;
+		int wake_fd;
+		std::atomic<bool> running;
+};
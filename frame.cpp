@@ -0,0 +1,649 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	frame.cpp - Framing of TCP packets: a fixed header before every packet, gathered with the packet
+--								by sendmsg and parsed in place in the Server's reads, so the packet is never copied
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void advance_iovecs(struct iovec *&iov, int &count, size_t bytes)
+--					void start(uint32_t stream_id, uint32_t first_seq, bool checksum)
+--					int prepare(struct iovec iov[2], const char *packet, int len)
+--					int finish(struct iovec iov[1])
+--					void merge(const FrameWriter &other)
+--					void append_report(std::string &print_output, double elapsed_ms)
+--					bool consume(size_t received_bytes, const char *buffer, const FrameDataHandler &deliver)
+--					bool parse_header(const char *data)
+--					void verify_block()
+--					void merge(const FrameReader &other)
+--					void report(TransferResult &result)
+--					void append_report(std::string &print_output, double elapsed_ms)
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	With --frame, the TCP Client sends every packet behind a 32-Byte FrameHeader: its length, its sequence number in
+--	the transfer, the stream that carries it and the time it was sent. The header and the packet are two iovecs of
+--	one sendmsg, so the packet is sent from the Payload where it is and never copied into a combined buffer.
+--
+--	The Server reads a framed connection in bulk, as many frames per read as fit in the receive buffer, and parses
+--	the headers where they lie in the buffer; the packet data between them is delivered in place. Only a header
+--	split between two reads is copied, into the FrameReader. The Server counts the frames, and the frames of a
+--	connection that arrive out of sequence order.
+--
+--	With --verify the header also carries the CRC32C of its packet (see crc32c.cpp), and after the last packet of a
+--	connection the Client sends an empty FRAME_END frame with the CRC32C of all the packet checksums of the
+--	connection, which reveals a packet lost or repeated whole. The Server checksums every packet while it is still
+--	in the receive buffer, as it is read, and both sides report the time the checksums took next to the transfer
+--	time.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "frame.h"
+#include "timing.h"
+#include "crc32c.h"
+#include "recv_pool.h"
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		advance_iovecs
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		advance_iovecs(struct iovec *&iov, int &count, size_t bytes)
+--						struct iovec *&iov: First iovec still to send, advanced past the ones sent
+--						int &count: Number of iovecs still to send
+--						size_t bytes: Bytes a short sendmsg sent
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Skips the iovecs a short send finished and trims the one it stopped in, so the next call sends the rest.
+----------------------------------------------------------------------------------------------------------------------*/
+void advance_iovecs(struct iovec *&iov, int &count, size_t bytes)
+{
+	while (count > 0 && bytes >= iov->iov_len)
+	{
+		bytes -= iov->iov_len;
+		iov++;
+		count--;
+	}
+	if (count > 0)
+	{
+		iov->iov_base = (char *)iov->iov_base + bytes;
+		iov->iov_len -= bytes;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_cost
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_cost(std::string &print_output, long long bytes, uint64_t verify_ns, double elapsed_ms)
+--						std::string &print_output: Output string the cost is appended to
+--						long long bytes: Bytes checksummed
+--						uint64_t verify_ns: Time the checksums took
+--						double elapsed_ms: Time the transfer took
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	The checksum rate and the share of the transfer time spent on the checksums.
+----------------------------------------------------------------------------------------------------------------------*/
+static void append_cost(std::string &print_output, long long bytes, uint64_t verify_ns, double elapsed_ms)
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nChecksum Time: %.3f ms (%.2f GB/s, %.1f%% of the transfer time)", verify_ns / 1e6,
+		(verify_ns > 0) ? (double)bytes / verify_ns : 0, (elapsed_ms > 0) ? verify_ns / (elapsed_ms * 1e4) : 0);
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(uint32_t stream_id, uint32_t first_seq, bool checksum)
+--						uint32_t stream_id: Stream of the connection, from 0
+--						uint32_t first_seq: Sequence number of the connection's first packet in the transfer
+--						bool checksum: Whether the frames carry the CRC32C of their packet (--verify)
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	The streams of a striped transfer carry contiguous shares of the packets, so their sequence numbers continue
+--	from one stream to the next.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::start(uint32_t stream_id, uint32_t first_seq, bool checksum)
+{
+	stream = stream_id;
+	next_seq = first_seq;
+	framed = 0;
+	verify = checksum;
+	digest = 0;
+	payload_bytes = 0;
+	verify_ns = 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		prepare
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		prepare(struct iovec iov[2], const char *packet, int len)
+--						struct iovec iov[2]: Set to the header and the packet
+--						const char *packet: Packet to send
+--						int len: Size of the packet in Bytes
+--
+--	RETURNS:		int - the number of iovecs to send.
+--
+--	NOTES:
+--	Builds the header of the next packet, with the CRC32C of the packet if the frames are checksummed. The header is
+--	kept in the FrameWriter, so it must be sent before the next packet is prepared.
+----------------------------------------------------------------------------------------------------------------------*/
+int FrameWriter::prepare(struct iovec iov[2], const char *packet, int len)
+{
+	uint64_t send_ns = monotonic_ns();
+	uint32_t crc;
+
+	header.magic = htonl(FRAME_MAGIC);
+	header.length = htonl((uint32_t)len);
+	header.seq = htonl(next_seq++);
+	header.stream = htonl(stream);
+	header.send_ns_high = htonl((uint32_t)(send_ns >> 32));
+	header.send_ns_low = htonl((uint32_t)send_ns);
+	header.flags = 0;
+	header.crc = 0;
+	framed++;
+
+	// Checksum the Packet, and the Checksum into the Digest of the Connection
+	if (verify)
+	{
+		crc = htonl(crc32c(0, packet, len));
+		digest = crc32c(digest, &crc, sizeof(crc));
+		header.flags = htonl(FRAME_CRC);
+		header.crc = crc;
+		payload_bytes += len;
+		verify_ns += monotonic_ns() - send_ns;
+	}
+
+	iov[0].iov_base = &header;
+	iov[0].iov_len = sizeof(header);
+	iov[1].iov_base = (void *)packet;
+	iov[1].iov_len = len;
+
+	return 2;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		finish
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		finish(struct iovec iov[1])
+--						struct iovec iov[1]: Set to the FRAME_END header
+--
+--	RETURNS:		int - the number of iovecs to send (0 if the frames are not checksummed).
+--
+--	NOTES:
+--	Builds the frame that ends a checksummed connection: no packet, and the digest of the packet checksums.
+----------------------------------------------------------------------------------------------------------------------*/
+int FrameWriter::finish(struct iovec iov[1])
+{
+	uint64_t send_ns = monotonic_ns();
+
+	if (!verify)
+	{
+		return 0;
+	}
+
+	header.magic = htonl(FRAME_MAGIC);
+	header.length = 0;
+	header.seq = htonl(next_seq);
+	header.stream = htonl(stream);
+	header.send_ns_high = htonl((uint32_t)(send_ns >> 32));
+	header.send_ns_low = htonl((uint32_t)send_ns);
+	header.flags = htonl(FRAME_CRC | FRAME_END);
+	header.crc = htonl(digest);
+
+	iov[0].iov_base = &header;
+	iov[0].iov_len = sizeof(header);
+
+	return 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		merge
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		merge(const FrameWriter &other)
+--						const FrameWriter &other: Frames of another stream of the transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Adds the counts of a stream to the transfer, for the report of a striped transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::merge(const FrameWriter &other)
+{
+	framed += other.framed;
+	verify = verify || other.verify;
+	payload_bytes += other.payload_bytes;
+	verify_ns += other.verify_ns;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output, double elapsed_ms)
+--						std::string &print_output: Output string the statistics are appended to
+--						double elapsed_ms: Time the transfer took
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the frames sent and the header Bytes they added to the transfer, and the cost of the checksums.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameWriter::append_report(std::string &print_output, double elapsed_ms) const
+{
+	print_output += "\nFrames: ";
+	print_output += std::to_string(framed);
+	print_output += " (";
+	print_output += std::to_string(framed * (long long)sizeof(FrameHeader));
+	print_output += " Bytes of headers, sent with sendmsg())";
+	if (verify)
+	{
+		print_output += "\nChecksums: CRC32C (";
+		print_output += crc32c_engine();
+		print_output += ") of every packet";
+		append_cost(print_output, payload_bytes, verify_ns, elapsed_ms);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		consume
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Parse the frames of a bulk read in place]
+--					October 17, 2026 [Count the split header copies in bytes touched per byte received]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		consume(size_t received_bytes, const char *buffer, const FrameDataHandler &deliver)
+--						size_t received_bytes: Bytes read into the buffer
+--						const char *buffer: The data of one read of the connection
+--						const FrameDataHandler &deliver: Called with every piece of packet data
+--
+--	RETURNS:		bool - false once the connection turned out not to be framed.
+--
+--	NOTES:
+--	Walks the frames of one read: the packet data is checksummed and delivered where it lies in the buffer, and a
+--	header that is whole in the buffer is parsed there too. Only a header split between two reads is copied, into
+--	the FrameReader's header, until its rest arrives. A checksummed packet is checksummed piece by piece and verified
+--	once its last piece is in. A header with the wrong magic ends the framing of the connection: its Bytes and
+--	everything after them are delivered as data.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FrameReader::consume(size_t received_bytes, const char *buffer, const FrameDataHandler &deliver)
+{
+	const char *end = buffer + received_bytes;
+	const char *next;
+	size_t left;
+	size_t take;
+
+	while (buffer < end)
+	{
+		left = end - buffer;
+
+		// Connections that are not Framed are Delivered Whole
+		if (raw)
+		{
+			deliver(buffer, left);
+			return false;
+		}
+
+		// Packet Data of the Current Frame, Checksummed and Delivered in Place
+		if (in_payload)
+		{
+			take = (left < payload_left) ? left : payload_left;
+			if (checked)
+			{
+				uint64_t start_ns = monotonic_ns();
+
+				block_crc = crc32c(block_crc, buffer, take);
+				verify_ns += monotonic_ns() - start_ns;
+				verified_bytes += take;
+			}
+			deliver(buffer, take);
+			payload_bytes += take;
+			payload_left -= take;
+			buffer += take;
+			in_payload = (payload_left > 0);
+			if (!in_payload && checked)
+			{
+				verify_block();
+			}
+			continue;
+		}
+
+		// Header of the Next Frame, Copied only when the Read Split it
+		if (header_got == 0 && left >= sizeof(FrameHeader))
+		{
+			next = buffer;
+			buffer += sizeof(FrameHeader);
+		}
+		else
+		{
+			take = (left < sizeof(header) - header_got) ? left : sizeof(header) - header_got;
+			memcpy((char *)&header + header_got, buffer, take);
+			recv_pool().record_copied(take);
+			header_got += take;
+			buffer += take;
+			if (header_got < sizeof(header))
+			{
+				break;
+			}
+			header_got = 0;
+			next = (const char *)&header;
+		}
+
+		if (!parse_header(next))
+		{
+			deliver(next, sizeof(FrameHeader));
+		}
+	}
+
+	return !raw;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		header_field
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		header_field(const char *data, size_t offset)
+--						const char *data: Start of a FrameHeader, at any alignment
+--						size_t offset: Offset of the field in the FrameHeader
+--
+--	RETURNS:		uint32_t - the field in host byte order.
+--
+--	NOTES:
+--	A header parsed in the receive buffer is not aligned, so its fields are loaded with memcpy.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t header_field(const char *data, size_t offset)
+{
+	uint32_t value;
+
+	memcpy(&value, data + offset, sizeof(value));
+	return ntohl(value);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_header
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_header(const char *data)
+--						const char *data: The 32 Bytes of the header, in the receive buffer or the FrameReader's copy
+--
+--	RETURNS:		bool - true if the header is a frame header.
+--
+--	NOTES:
+--	Starts the frame of a complete header. TCP keeps the order of a connection, so a frame out of sequence order
+--	means the Client sent it so (the streams of a striped transfer each carry their own ascending share). A FRAME_END
+--	header is not a frame: it carries the digest the connection's packet checksums must add up to.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FrameReader::parse_header(const char *data)
+{
+	uint32_t seq;
+	uint32_t flags;
+
+	if (header_field(data, offsetof(FrameHeader, magic)) != FRAME_MAGIC)
+	{
+		raw = true;
+		unframed++;
+		return false;
+	}
+
+	flags = header_field(data, offsetof(FrameHeader, flags));
+	payload_left = header_field(data, offsetof(FrameHeader, length));
+	in_payload = (payload_left > 0);
+
+	// End of a Checksummed Connection: the Digest of its Packet Checksums
+	if (flags & FRAME_END)
+	{
+		if (header_field(data, offsetof(FrameHeader, crc)) == digest)
+			digests_verified++;
+		else
+			digest_errors++;
+		return true;
+	}
+
+	seq = header_field(data, offsetof(FrameHeader, seq));
+	if (has_seq && seq <= last_seq)
+	{
+		out_of_order++;
+	}
+	has_seq = true;
+	last_seq = seq;
+	frames++;
+
+	// Checksum the Packet as it is Read
+	checked = (flags & FRAME_CRC) != 0;
+	block_crc = 0;
+	expected_crc = header_field(data, offsetof(FrameHeader, crc));
+	if (checked && !in_payload)
+	{
+		verify_block();
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		verify_block
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		verify_block()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Compares the CRC32C of a whole packet with the one in its header, and adds it to the digest of the connection
+--	the way the Client did.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameReader::verify_block()
+{
+	uint32_t crc = htonl(block_crc);
+
+	if (block_crc == expected_crc)
+		blocks_verified++;
+	else
+		crc_errors++;
+	digest = crc32c(digest, &crc, sizeof(crc));
+	checked = false;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		merge
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		merge(const FrameReader &other)
+--						const FrameReader &other: Frames of another connection of the transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Adds the counts of a closed connection to the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameReader::merge(const FrameReader &other)
+{
+	frames += other.frames;
+	payload_bytes += other.payload_bytes;
+	out_of_order += other.out_of_order;
+	unframed += other.unframed;
+	verified_bytes += other.verified_bytes;
+	blocks_verified += other.blocks_verified;
+	crc_errors += other.crc_errors;
+	digests_verified += other.digests_verified;
+	digest_errors += other.digest_errors;
+	verify_ns += other.verify_ns;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Result the frame counts are recorded in
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Frames out of order and connections that were not framed are both counted as frame errors. Packets and
+--	connections whose checksum did not match are counted as checksum errors.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameReader::report(TransferResult &result) const
+{
+	result.frames = frames;
+	result.frame_errors = out_of_order + unframed;
+	result.crc_errors = crc_errors + digest_errors;
+	result.verify_ms = verify_ns / 1e6;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output, double elapsed_ms)
+--						std::string &print_output: Output string the statistics are appended to
+--						double elapsed_ms: Time the transfer took
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the frames received, the packet data they carried and the frame errors, and the checksums verified with
+--	their cost.
+----------------------------------------------------------------------------------------------------------------------*/
+void FrameReader::append_report(std::string &print_output, double elapsed_ms) const
+{
+	char line[BUFFERSIZE];
+
+	print_output += "\nFrames: ";
+	print_output += std::to_string(frames);
+	print_output += " (";
+	print_output += std::to_string(payload_bytes);
+	print_output += " Bytes of packets, parsed in place)";
+	print_output += "\nFrames out of Order: ";
+	print_output += std::to_string(out_of_order);
+	if (unframed > 0)
+	{
+		print_output += "\nConnections not Framed: ";
+		print_output += std::to_string(unframed);
+	}
+	if (blocks_verified + crc_errors > 0)
+	{
+		snprintf(line, sizeof(line), "\nChecksums: CRC32C (%s), %lld packets verified, %lld bad", crc32c_engine(),
+			blocks_verified, crc_errors);
+		print_output += line;
+		snprintf(line, sizeof(line), "\nConnections Verified: %lld, %lld bad", digests_verified, digest_errors);
+		print_output += line;
+		append_cost(print_output, verified_bytes, verify_ns, elapsed_ms);
+	}
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "transport.h"
+#include <sys/uio.h>
+#include <stdint.h>
+#include <functional>
+
+#define FRAME_MAGIC 0x46524D31
+
+// Flags of a Frame
+#define FRAME_CRC 1
+#define FRAME_END 2
+
+// Header Sent before every Packet of a Framed TCP Transfer (network byte order, half a cache line)
+struct alignas(32) FrameHeader
+{
+	uint32_t magic;
+	uint32_t length;
+	uint32_t seq;
+	uint32_t stream;
+	uint32_t send_ns_high;
+	uint32_t send_ns_low;
+	uint32_t flags;
+	uint32_t crc;
+};
+
+static_assert(sizeof(FrameHeader) == 32, "FrameHeader must stay 32 Bytes");
+
+// Called with every Piece of Packet Data a FrameReader Finds in a Read
+typedef std::function<void(const char *data, size_t len)> FrameDataHandler;
+
+void advance_iovecs(struct iovec *&iov, int &count, size_t bytes);
+
+// Frames the Packets of one Connection: the Header and the Packet are Sent as Separate iovecs (Client side)
+class FrameWriter
+{
+	public:
+		FrameWriter() {};
+		~FrameWriter() {};
+		void start(uint32_t stream_id, uint32_t first_seq, bool checksum);
+		int prepare(struct iovec iov[2], const char *packet, int len);
+		int finish(struct iovec iov[1]);
+		void merge(const FrameWriter &other);
+		long long frames() const { return framed; };
+		double verify_ms() const { return verify_ns / 1e6; };
+		void append_report(std::string &print_output, double elapsed_ms) const;
+	private:
+		FrameHeader header;
+		uint32_t stream = 0;
+		uint32_t next_seq = 0;
+		long long framed = 0;
+		bool verify = false;
+		uint32_t digest = 0;
+		long long payload_bytes = 0;
+		uint64_t verify_ns = 0;
+};
+
+// Parses the Frames of one Connection out of its Reads, in Place (Server side)
+class FrameReader
+{
+	public:
+		FrameReader() {};
+		~FrameReader() {};
+		bool consume(size_t received_bytes, const char *buffer, const FrameDataHandler &deliver);
+		void merge(const FrameReader &other);
+		bool active() const { return frames > 0 || unframed > 0; };
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output, double elapsed_ms) const;
+	private:
+		bool parse_header(const char *data);
+		void verify_block();
+		FrameHeader header;
+		size_t header_got = 0;
+		size_t payload_left = 0;
+		bool in_payload = false;
+		bool raw = false;
+		bool has_seq = false;
+		uint32_t last_seq = 0;
+		long long frames = 0;
+		long long payload_bytes = 0;
+		long long out_of_order = 0;
+		long long unframed = 0;
+		bool checked = false;
+		uint32_t block_crc = 0;
+		uint32_t expected_crc = 0;
+		uint32_t digest = 0;
+		long long verified_bytes = 0;
+		long long blocks_verified = 0;
+		long long crc_errors = 0;
+		long long digests_verified = 0;
+		long long digest_errors = 0;
+		uint64_t verify_ns = 0;
+};
@@ -0,0 +1,431 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	latency.cpp - Request/response (ping-pong) latency runs and their round trip time histogram
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void record(uint64_t value_ns)
+--					void merge(const LatencyHistogram &other)
+--					uint64_t percentile_ns(double percentile)
+--					void append_distribution(std::string &print_output)
+--					void run_latency(LatencyRun &run, Executor &executor, RoundTrip round_trip)
+--					void append_latency_report(std::string &print_output, const LatencyRun &run,
+--						TransferResult &result)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The latency modes (tcp-latency, udp-latency) send one packet at a time and wait for the Server (started with
+--	--echo) to send it back. Every round trip time is recorded into a LatencyHistogram, which keeps a count per
+--	bucket instead of every sample: values below 2 * LATENCY_SUB_COUNT ns have a bucket each, and every power of two
+--	above that is split into LATENCY_SUB_COUNT buckets, like an HDR histogram with two significant digits. The
+--	histogram has the same size for ten requests or ten million, and histograms of several workers merge by
+--	adding their counts.
+--
+--	A run has concurrency workers, each with its own socket, taking requests 0, 1, 2, ... in turn. The workers are
+--	coroutines on one Executor (see coro.cpp), so a run of thousands of workers takes one thread. Without a rate
+--	every worker sends its next request as soon as the previous one returned (closed loop). With a rate the
+--	requests are sent on a fixed schedule (request i at i / rate seconds) and the round trip time is measured from
+--	the time the request was due, not the time it was sent, so a stalled response also counts against the requests
+--	that queued behind it (no coordinated omission).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "latency.h"
+#include "timing.h"
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		bucket_index
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		bucket_index(uint64_t value)
+--						uint64_t value: Recorded value
+--
+--	RETURNS:		int - the bucket of the value.
+--
+--	NOTES:
+--	The value is reduced to its top LATENCY_SUB_BITS + 1 bits; the number of bits shifted out selects the power of
+--	two and the remaining bits the sub-bucket within it.
+----------------------------------------------------------------------------------------------------------------------*/
+static int bucket_index(uint64_t value)
+{
+	int shift;
+
+	if (value < 2 * LATENCY_SUB_COUNT)
+	{
+		return (int)value;
+	}
+
+	shift = 63 - __builtin_clzll(value) - LATENCY_SUB_BITS;
+	return shift * LATENCY_SUB_COUNT + (int)(value >> shift);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		bucket_highest
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		bucket_highest(int index)
+--						int index: Bucket of the histogram
+--
+--	RETURNS:		uint64_t - the highest value that falls into the bucket.
+--
+--	NOTES:
+--	Percentiles are reported as the highest value of their bucket, so they never understate the latency.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint64_t bucket_highest(int index)
+{
+	int shift;
+
+	if (index < 2 * LATENCY_SUB_COUNT)
+	{
+		return (uint64_t)index;
+	}
+
+	shift = index / LATENCY_SUB_COUNT - 1;
+	return (((uint64_t)(index % LATENCY_SUB_COUNT) + LATENCY_SUB_COUNT) << shift) + ((1ULL << shift) - 1);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record(uint64_t value_ns)
+--						uint64_t value_ns: Round trip time in ns
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void LatencyHistogram::record(uint64_t value_ns)
+{
+	counts[bucket_index(value_ns)]++;
+	total++;
+	sum_ns += value_ns;
+	if (value_ns < min_value)
+	{
+		min_value = value_ns;
+	}
+	if (value_ns > max_value)
+	{
+		max_value = value_ns;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		merge
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		merge(const LatencyHistogram &other)
+--						const LatencyHistogram &other: Histogram of another worker
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+	for (int i = 0; i < LATENCY_BUCKETS; i++)
+	{
+		counts[i] += other.counts[i];
+	}
+	total += other.total;
+	sum_ns += other.sum_ns;
+	if (other.min_value < min_value)
+	{
+		min_value = other.min_value;
+	}
+	if (other.max_value > max_value)
+	{
+		max_value = other.max_value;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		percentile_ns
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		percentile_ns(double percentile)
+--						double percentile: Percentile between 0 and 100
+--
+--	RETURNS:		uint64_t - the round trip time at the percentile in ns, or 0 if nothing was recorded.
+--
+--	NOTES:
+--	Nearest-rank method over the bucket counts. The value is capped at the largest value recorded.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t LatencyHistogram::percentile_ns(double percentile) const
+{
+	long long rank = (long long)(percentile / 100.0 * total + 0.5);
+	long long seen = 0;
+
+	if (total == 0)
+	{
+		return 0;
+	}
+	if (rank < 1)
+	{
+		rank = 1;
+	}
+
+	for (int i = 0; i < LATENCY_BUCKETS; i++)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+		{
+			return (bucket_highest(i) < max_value) ? bucket_highest(i) : max_value;
+		}
+	}
+
+	return max_value;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_distribution
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_distribution(std::string &print_output)
+--						std::string &print_output: Output string the distribution is appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the percentile distribution in the layout of HdrHistogram's .hgrm files (value in us, percentile,
+--	count up to the value, 1/(1-percentile)), so the output can be fed to the usual HDR plotting tools. The
+--	percentiles halve the remaining distance to 100% on every line.
+----------------------------------------------------------------------------------------------------------------------*/
+void LatencyHistogram::append_distribution(std::string &print_output) const
+{
+	char line[BUFFERSIZE];
+	double remaining = 1.0;
+
+	print_output += "\n       Value     Percentile TotalCount 1/(1-Percentile)\n";
+
+	while (total > 0)
+	{
+		double percentile = 1.0 - remaining;
+		uint64_t value = percentile_ns(percentile * 100.0);
+		long long at_or_below = 0;
+
+		for (int i = 0; i <= bucket_index(value); i++)
+		{
+			at_or_below += counts[i];
+		}
+		if (at_or_below >= total)
+		{
+			break;
+		}
+
+		snprintf(line, sizeof(line), "\n%12.3f %14.12f %10lld %14.2f", value / 1e3, percentile, at_or_below,
+			1.0 / remaining);
+		print_output += line;
+		remaining /= 2;
+	}
+
+	snprintf(line, sizeof(line), "\n%12.3f %14.12f %10lld", max_value / 1e3, 1.0, total);
+	print_output += line;
+	snprintf(line, sizeof(line), "\n#[Mean    = %12.3f, Max = %12.3f]", mean_ns() / 1e3, max_value / 1e3);
+	print_output += line;
+	snprintf(line, sizeof(line), "\n#[Total count    = %12lld, SubBuckets = %6d]", total, LATENCY_SUB_COUNT);
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		latency_worker
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		latency_worker(LatencyRun &run, Executor &executor, const RoundTrip &round_trip, int worker,
+--						uint64_t run_start)
+--						LatencyRun &run: Run the round trip times are recorded into
+--						Executor &executor: Executor the worker sleeps on until its requests are due
+--						const RoundTrip &round_trip: Sends one request on the worker's socket and waits for its echo
+--						int worker: Number of the worker
+--						uint64_t run_start: Monotonic start time of the run, which the rate schedule counts from
+--
+--	RETURNS:		Task<bool> - false if the worker stopped at a failed request.
+--
+--	NOTES:
+--	Worker w sends requests w, w + concurrency, ... and records their round trip times into the run. All workers run
+--	on the thread of the Executor, so they share the histogram without a lock. A worker stops at its first failed
+--	request; a lost request (UDP) is counted and the worker carries on.
+----------------------------------------------------------------------------------------------------------------------*/
+static Task<bool> latency_worker(LatencyRun &run, Executor &executor, const RoundTrip &round_trip, int worker,
+	uint64_t run_start)
+{
+	uint64_t interval_ns = (run.rate > 0) ? 1000000000ULL / run.rate : 0;
+
+	for (int seq = worker; seq < run.num_request; seq += run.concurrency)
+	{
+		uint64_t start_ns = monotonic_ns();
+		RequestStatus status;
+
+		// Wait until the Request is Due
+		if (interval_ns > 0)
+		{
+			start_ns = run_start + (uint64_t)seq * interval_ns;
+			co_await executor.sleep_until(start_ns);
+		}
+
+		status = co_await round_trip(worker, (uint32_t)seq);
+		if (status == REQUEST_FAILED)
+		{
+			run.failed++;
+			co_return false;
+		}
+		if (status == REQUEST_LOST)
+		{
+			run.lost++;
+			continue;
+		}
+		run.histogram.record(monotonic_ns() - start_ns);
+		run.completed++;
+	}
+
+	co_return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		run_latency
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Run the workers as coroutines on one Executor]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		run_latency(LatencyRun &run, Executor &executor, RoundTrip round_trip)
+--						LatencyRun &run: Concurrency, number of requests and rate; set to the results of the run
+--						Executor &executor: Executor the sockets of the workers are registered with
+--						RoundTrip round_trip: Sends one request on a worker's socket and waits for its echo
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Spawns a latency_worker coroutine per worker and runs the Executor on this thread until every worker is done.
+--	The round trip must give up on a request by itself (a read deadline), since the Executor runs without one.
+----------------------------------------------------------------------------------------------------------------------*/
+void run_latency(LatencyRun &run, Executor &executor, RoundTrip round_trip)
+{
+	std::vector<Task<bool>> workers;
+	uint64_t run_start = monotonic_ns();
+
+	workers.reserve(run.concurrency);
+	for (int w = 0; w < run.concurrency; w++)
+	{
+		workers.push_back(latency_worker(run, executor, round_trip, w, run_start));
+		executor.spawn(workers.back());
+	}
+	executor.run();
+
+	run.elapsed_ms = (monotonic_ns() - run_start) / 1e6;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_latency_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_latency_report(std::string &print_output, const LatencyRun &run, TransferResult &result)
+--						std::string &print_output: Output string the statistics are appended to
+--						const LatencyRun &run: A finished run
+--						TransferResult &result: Set to the round trip time percentiles
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the request counts, the achieved rate, the round trip time summary and the full distribution.
+----------------------------------------------------------------------------------------------------------------------*/
+void append_latency_report(std::string &print_output, const LatencyRun &run, TransferResult &result)
+{
+	const LatencyHistogram &histogram = run.histogram;
+	char line[BUFFERSIZE];
+
+	result.packets = run.completed;
+	result.elapsed_ms = run.elapsed_ms;
+	result.rtt_p50_us = histogram.percentile_ns(50) / 1e3;
+	result.rtt_p99_us = histogram.percentile_ns(99) / 1e3;
+	result.rtt_p999_us = histogram.percentile_ns(99.9) / 1e3;
+	result.rtt_max_us = histogram.max_ns() / 1e3;
+
+	print_output += "\nConcurrency: ";
+	print_output += std::to_string(run.concurrency);
+	print_output += "\nTarget Rate: ";
+	print_output += (run.rate > 0) ? std::to_string(run.rate) + " Requests/s" : std::string("closed loop");
+	snprintf(line, sizeof(line), "\nCompleted Requests: %lld (%lld lost, %lld failed)", run.completed, run.lost,
+		run.failed);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nElapsed Time: %.3f ms", run.elapsed_ms);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nAchieved Rate: %.1f Requests/s",
+		(run.elapsed_ms > 0) ? run.completed * 1000.0 / run.elapsed_ms : 0);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nRound Trip Time min/mean/max: %.1f / %.1f / %.1f us", histogram.min_ns() / 1e3,
+		histogram.mean_ns() / 1e3, histogram.max_ns() / 1e3);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nRound Trip Time p50/p90/p99/p99.9/p99.99: %.1f / %.1f / %.1f / %.1f / %.1f us",
+		result.rtt_p50_us, histogram.percentile_ns(90) / 1e3, result.rtt_p99_us, result.rtt_p999_us,
+		histogram.percentile_ns(99.99) / 1e3);
+	print_output += line;
+	print_output += "\nRound Trip Time Distribution (HDR):";
+	histogram.append_distribution(print_output);
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "transport.h"
+#include "coro.h"
+#include <stdint.h>
+#include <functional>
+
+// 2^LATENCY_SUB_BITS Sub-Buckets per Power of Two (values kept to better than 1%)
+#define LATENCY_SUB_BITS 7
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((65 - LATENCY_SUB_BITS) * LATENCY_SUB_COUNT)
+
+// Outcome of one Request
+enum RequestStatus { REQUEST_DONE, REQUEST_LOST, REQUEST_FAILED };
+
+// Coroutine that Sends Request seq on a Worker's Socket and Waits for its Echo
+typedef std::function<Task<RequestStatus>(int worker, uint32_t seq)> RoundTrip;
+
+// Log-Linear (HDR style) Histogram of Round Trip Times in ns
+class LatencyHistogram
+{
+	public:
+		LatencyHistogram() : counts(LATENCY_BUCKETS, 0) {};
+		~LatencyHistogram() {};
+		void record(uint64_t value_ns);
+		void merge(const LatencyHistogram &other);
+		long long count() const { return total; };
+		uint64_t percentile_ns(double percentile) const;
+		double mean_ns() const { return (total > 0) ? (double)sum_ns / total : 0; };
+		uint64_t min_ns() const { return (total > 0) ? min_value : 0; };
+		uint64_t max_ns() const { return max_value; };
+		void append_distribution(std::string &print_output) const;
+	private:
+		std::vector<long long> counts;
+		long long total = 0;
+		uint64_t sum_ns = 0;
+		uint64_t min_value = UINT64_MAX;
+		uint64_t max_value = 0;
+};
+
+// A Latency Run: num_request requests over concurrency workers, at rate requests/s (0: each worker back to back)
+struct LatencyRun
+{
+	int concurrency = 1;
+	int num_request = 0;
+	int rate = 0;
+	LatencyHistogram histogram;
+	long long completed = 0;
+	long long lost = 0;
+	long long failed = 0;
+	double elapsed_ms = 0;
+};
+
+void run_latency(LatencyRun &run, Executor &executor, RoundTrip round_trip);
+void append_latency_report(std::string &print_output, const LatencyRun &run, TransferResult &result);
@@ -0,0 +1,141 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	loop_shards.cpp - Event loops running on their own threads, one per core
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void start(int count, int first_core, ShardHandler handler, int idle_ms)
+--					void stop()
+--					int core_count()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	A single EventLoop handles every connection of the Server on one thread, so one core does all of the receive
+--	work. LoopShards runs additional EventLoops, each on its own thread pinned to its own core. The Server assigns
+--	every accepted socket to one of the loops, and all events of that socket are handled by that loop's thread, so
+--	the per-connection state needs no locking. The main thread keeps running its own EventLoop (the listening
+--	socket), which acts as shard 0.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "loop_shards.h"
+#include <pthread.h>
+#include <sched.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(int count, int first_core, ShardHandler handler, int idle_ms)
+--						int count: Number of event loops to start
+--						int first_core: Core of the first loop, the following loops take the following cores
+--						ShardHandler handler: Called on the loop's thread for every event of its sockets
+--						int idle_ms: Idle time before the handler gets EVENT_IDLE (-1 never)
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Creates every EventLoop before starting the threads, so sockets can be registered with loop(index) as soon as
+--	start returns. Each thread is pinned to its core; if pinning fails the thread runs unpinned.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopShards::start(int count, int first_core, ShardHandler handler, int idle_ms)
+{
+	int cores = core_count();
+
+	stop();
+
+	for (int i = 0; i < count; i++)
+	{
+		loops.push_back(std::unique_ptr<EventLoop>(new EventLoop()));
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		threads.emplace_back([this, i, handler, idle_ms, core = (first_core + i) % cores]()
+		{
+			cpu_set_t cpus;
+
+			// Pin the Loop to its Core
+			CPU_ZERO(&cpus);
+			CPU_SET(core, &cpus);
+			pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+			loops[i]->run([i, &handler](SOCKET sock, int event) { handler(i, sock, event); }, idle_ms);
+		});
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		stop
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		stop()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Stops every loop and waits for its thread. The sockets registered with the loops are owned by the caller.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoopShards::stop()
+{
+	for (std::unique_ptr<EventLoop> &loop : loops)
+	{
+		loop->stop();
+	}
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	threads.clear();
+	loops.clear();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		core_count
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		core_count()
+--
+--	RETURNS:		int - the number of online cores, at least 1.
+--
+--	NOTES:
+--	The default number of event loops of the Server.
+----------------------------------------------------------------------------------------------------------------------*/
+int LoopShards::core_count()
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (cores < 1) ? 1 : (cores > SERVER_MAX_LOOPS) ? SERVER_MAX_LOOPS : (int)cores;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "event_loop.h"
+#include <memory>
+#include <thread>
+
+// Event Handler of a Shard (the shard index is passed with the socket and the event)
+typedef std::function<void(int shard, SOCKET sock, int event)> ShardHandler;
+
+// Event Loops Running on their own Threads, one per Core
+class LoopShards
+{
+	public:
+		LoopShards() {};
+		~LoopShards() { stop(); };
+		void start(int count, int first_core, ShardHandler handler, int idle_ms = -1);
+		void stop();
+		EventLoop &loop(int index) { return *loops[index]; };
+		int size() const { return (int)loops.size(); };
+		static int core_count();
+	private:
+		std::vector<std::unique_ptr<EventLoop>> loops;
+		std::vector<std::thread> threads;
+};
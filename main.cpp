@@ -45,9 +45,6 @@
 #include "tcp.h"
 #include "udp.h"
 
-// Enum Definition
-enum Protocol { TCP_PROTOCOL, UDP_PROTOCOL };
-
 // Function Prototypes
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 BOOL CALLBACK DialogProc(HWND, UINT, WPARAM, LPARAM);
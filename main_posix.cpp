@@ -0,0 +1,423 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	main_posix.cpp - The console entry point of the program on POSIX systems
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					int main(int argc, char *argv[])
+--					void print_usage()
+--					void run_server(EventLoop &loop, const TransferOptions &options)
+--					void report_transfer(const RunRecord &record, const std::string &text, const TransferOptions &options)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		October 16, 2026 [Added the benchmark runner mode]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The POSIX counterpart of main.cpp. There is no window or menu, so the mode is selected on the command line:
+--
+--		analyser tcp-server [port] [transfer options]
+--		analyser udp-server [port] [transfer options]
+--		analyser tcp-client host [port] [packet_size] [num_packets] [transfer options]
+--		analyser udp-client host [port] [packet_size] [num_packets] [transfer options]
+--		analyser tcp-latency host [port] [packet_size] [num_requests] [transfer options]
+--		analyser udp-latency host [port] [packet_size] [num_requests] [transfer options]
+--		analyser bench [sweep options] [transfer options]
+--		analyser trace file
+--		analyser history history_file [name=value ...] [--fields a,b,c] [--last N]
+--		analyser compare history_file [run_a] [run_b]
+--
+--	The server modes run the EventLoop, which takes the place of the WM_SOCKET handling in WndProc, and print the
+--	statistics of every transfer to stdout instead of painting them on the window. With --trace the trace ring is
+--	dumped after every transfer, and the trace mode decodes a dump. With --format json|csv every transfer is
+--	printed as a machine readable record instead (see record.cpp), and with --history it is appended to a run
+--	history, which the history and compare modes query.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "transport.h"
+#include "event_loop.h"
+#include "bench.h"
+#include "options.h"
+#include "recv_pool.h"
+#include "trace.h"
+#include "record.h"
+#include "tcp.h"
+#include "udp.h"
+
+// Function Prototypes
+void print_usage();
+void run_server(EventLoop &loop, const TransferOptions &options);
+void report_transfer(const RunRecord &record, const std::string &text, const TransferOptions &options);
+
+// Global Variables
+Protocol protocol;
+TCP tcp_connection;
+UDP udp_connection;
+static std::string print_string;
+
+// Initialize Default Values
+int port = PORT;
+int packetsize = PACKETSIZE;
+int numpackets = NUMPACKETS;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		main
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added the bench mode]
+--					October 16, 2026 [Added --hugepages]
+--					October 16, 2026 [Accept the transfer options]
+--					October 16, 2026 [Added the latency modes]
+--					October 16, 2026 [Added the trace mode and --trace]
+--					October 16, 2026 [Report machine readable records with --format and --history]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		int main(int argc, char *argv[])
+--						int argc: Number of command line arguments
+--						char *argv[]: Command line arguments
+--
+--	RETURNS:		int.
+--
+--	NOTES:
+--	Selects the mode from the command line. The client modes send the data and print the client statistics, the
+--	latency modes time request/response round trips against a Server started with --echo, and the server modes
+--	start the server and run the EventLoop until the process is terminated.
+----------------------------------------------------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+	EventLoop loop;
+	TransferOptions options;
+	std::string mode;
+
+	if (argc < 2)
+	{
+		print_usage();
+		return 1;
+	}
+
+	mode = argv[1];
+	protocol = (mode.compare(0, 3, "udp") == 0) ? UDP_PROTOCOL : TCP_PROTOCOL;
+
+	if (mode == "bench")
+	{
+		SweepSpec spec;
+
+		if (!parse_sweep(argc - 2, argv + 2, spec))
+		{
+			print_usage();
+			return 1;
+		}
+		return run_sweep(spec);
+	}
+	if (mode == "trace")
+	{
+		if (argc != 3)
+		{
+			print_usage();
+			return 1;
+		}
+		return trace_decode(argv[2]);
+	}
+	if (mode == "history")
+	{
+		return query_history(argc - 2, argv + 2);
+	}
+	if (mode == "compare")
+	{
+		return compare_history(argc - 2, argv + 2);
+	}
+
+	// Separate the Options from the Positional Arguments
+	std::vector<char *> args;
+	for (int i = 2; i < argc; i++)
+	{
+		if (strncmp(argv[i], "--", 2) != 0)
+		{
+			args.push_back(argv[i]);
+			continue;
+		}
+
+		int parsed = parse_transfer_option(argc, argv, i, options);
+		if (parsed == 0)
+		{
+			fprintf(stderr, "Unknown option %s\n", argv[i]);
+		}
+		if (parsed <= 0)
+		{
+			print_usage();
+			return 1;
+		}
+	}
+	argc = (int)args.size() + 2;
+	args.insert(args.begin(), 2, argv[0]);
+	argv = args.data();
+
+	recv_pool_init(options.hugepages);
+	if (!options.trace_file.empty())
+	{
+		trace_ring().enable(options.trace_file);
+	}
+	tcp_connection.set_options(options);
+	udp_connection.set_options(options);
+
+	if (mode == "tcp-server" || mode == "udp-server")
+	{
+		if (argc > 2)
+			port = atoi(argv[2]);
+
+		// Determine Protocol
+		switch (protocol)
+		{
+		case TCP_PROTOCOL:
+			tcp_connection.start_server(port, loop);
+			printf("TCP SERVER: Waiting for Connection on Port %d\n", port);
+			break;
+		case UDP_PROTOCOL:
+			udp_connection.start_server(port, loop);
+			printf("UDP SERVER: Waiting for Connection on Port %d\n", port);
+			break;
+		}
+		fflush(stdout);
+
+		run_server(loop, options);
+		tcp_connection.end_connection();
+		udp_connection.end_connection();
+		return 0;
+	}
+
+	if ((mode == "tcp-client" || mode == "udp-client" || mode == "tcp-latency" || mode == "udp-latency")
+		&& argc > 2)
+	{
+		bool latency = (mode.find("latency") != std::string::npos);
+		CpuSample cpu_start = cpu_sample();
+		RunRecord record;
+
+		if (argc > 3)
+			port = atoi(argv[3]);
+		if (argc > 4)
+			packetsize = atoi(argv[4]);
+		if (argc > 5)
+			numpackets = atoi(argv[5]);
+
+		// Determine Protocol
+		switch (protocol)
+		{
+		case TCP_PROTOCOL:
+			print_string = latency ? tcp_connection.measure_latency(argv[2], port, packetsize, numpackets)
+				: tcp_connection.send_packet(argv[2], port, packetsize, numpackets);
+			break;
+		case UDP_PROTOCOL:
+			print_string = latency ? udp_connection.measure_latency(argv[2], port, packetsize, numpackets)
+				: udp_connection.send_packet(argv[2], port, packetsize, numpackets);
+			break;
+		}
+		// Report the Client Side
+		record.mode = mode;
+		record.protocol = protocol;
+		record.host = argv[2];
+		record.port = port;
+		record.packet_size = packetsize;
+		record.num_packets = numpackets;
+		record.options = options;
+		record.has_client = true;
+		record.client = (protocol == TCP_PROTOCOL) ? tcp_connection.get_result() : udp_connection.get_result();
+		record.cpu = cpu_since(cpu_start);
+		report_transfer(record, print_string, options);
+		trace_ring().dump();
+		return 0;
+	}
+
+	print_usage();
+	return 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		print_usage
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added the bench mode]
+--					October 16, 2026 [List the transfer options]
+--					October 16, 2026 [Added the bench --streams list]
+--					October 16, 2026 [Added the latency modes]
+--					October 16, 2026 [Added the trace mode]
+--					October 16, 2026 [Added the history and compare modes]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		print_usage()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Prints the command line usage. This replaces the Help MessageBox of the Windows application.
+----------------------------------------------------------------------------------------------------------------------*/
+void print_usage()
+{
+	std::string help_text("The Application contains eight of the following functions:\n\n");
+	help_text += "1) Starting a TCP Server and wait for incoming data\n";
+	help_text += "   analyser tcp-server [port]\n";
+	help_text += "2) Send Data to a TCP Server as a TCP Client\n";
+	help_text += "   analyser tcp-client host [port] [packet_size] [num_packets]\n";
+	help_text += "3) Starting a UDP Server and wait for incoming data\n";
+	help_text += "   analyser udp-server [port]\n";
+	help_text += "4) Send Data to a UDP Server as a UDP Client\n";
+	help_text += "   analyser udp-client host [port] [packet_size] [num_packets]\n";
+	help_text += "5) Run a TCP/UDP benchmark sweep, one CSV row per cell\n";
+	help_text += "   analyser bench [--proto tcp,udp] [--sizes 1024,4096] [--counts 10,100] [--reps N]\n";
+	help_text += "                  [--streams 1,4] [--host 127.0.0.1] [--port 5150]\n";
+	help_text += "6) Measure request/response latency against a Server started with --echo\n";
+	help_text += "   analyser tcp-latency|udp-latency host [port] [packet_size] [num_requests]\n";
+	help_text += "                  [--concurrency N] [--rate requests_per_second]\n";
+	help_text += "7) Decode a trace dump written with --trace\n";
+	help_text += "   analyser trace file\n";
+	help_text += "8) List and compare the runs of a --history file\n";
+	help_text += "   analyser history history_file [name=value ...] [--fields a,b,c] [--last N]\n";
+	help_text += "   analyser compare history_file [run_a] [run_b]\n";
+	help_text += "\nEvery mode also accepts the transfer options.\n";
+	help_text += transfer_option_usage();
+
+	fprintf(stderr, "%s", help_text.c_str());
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		run_server
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Dump the trace after every transfer]
+--					October 16, 2026 [Report every transfer as a RunRecord]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		run_server(EventLoop &loop)
+--						EventLoop &loop: Event loop the server sockets are registered with
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Runs the EventLoop and handles the socket events the same way the WM_SOCKET case of WndProc does. Every time a
+--	transfer finishes its statistics are printed.
+----------------------------------------------------------------------------------------------------------------------*/
+void run_server(EventLoop &loop, const TransferOptions &options)
+{
+	CpuSample cpu_start = cpu_sample();
+
+	loop.run([&loop, &options, &cpu_start](SOCKET sock, int event)
+	{
+		switch (event)
+		{
+		case EVENT_ACCEPT:
+			tcp_connection.accept_connection(sock, loop);
+			break;
+		case EVENT_READ:
+			switch (protocol)
+			{
+			case TCP_PROTOCOL:
+				tcp_connection.receive_packet(port, sock, print_string);
+				break;
+			case UDP_PROTOCOL:
+				udp_connection.receive_packet(port, sock, print_string);
+				break;
+			}
+			break;
+		case EVENT_CLOSE:
+			if (protocol == TCP_PROTOCOL)
+			{
+				tcp_connection.receive_packet(port, sock, print_string);
+			}
+			break;
+		case EVENT_IDLE:
+			if (protocol == UDP_PROTOCOL)
+			{
+				udp_connection.check_timeout(print_string);
+			}
+			break;
+		}
+
+		// Print the Statistics of a Finished Transfer
+		if (!print_string.empty())
+		{
+			RunRecord record;
+
+			record.mode = (protocol == TCP_PROTOCOL) ? "tcp-server" : "udp-server";
+			record.protocol = protocol;
+			record.port = port;
+			record.options = options;
+			record.has_server = true;
+			record.server = (protocol == TCP_PROTOCOL) ? tcp_connection.get_result() : udp_connection.get_result();
+			record.cpu = cpu_since(cpu_start);
+			cpu_start = cpu_sample();
+			report_transfer(record, print_string + "\n", options);
+			fflush(stdout);
+			print_string.clear();
+			trace_ring().dump();
+		}
+	}, UDP_IDLE_TIMEOUT);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report_transfer
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report_transfer(const RunRecord &record, const std::string &text, const TransferOptions &options)
+--						const RunRecord &record: Record of the finished transfer
+--						const std::string &text: Printable statistics of the transfer
+--						const TransferOptions &options: Output format and history file
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Prints the transfer in the format of --format (the CSV header before the first row) and appends it to the
+--	--history file.
+----------------------------------------------------------------------------------------------------------------------*/
+void report_transfer(const RunRecord &record, const std::string &text, const TransferOptions &options)
+{
+	static bool csv_header = false;
+
+	switch (options.format)
+	{
+	case FORMAT_TEXT:
+		printf("%s\n", text.c_str());
+		break;
+	case FORMAT_JSON:
+		printf("%s\n", record_json(record).c_str());
+		break;
+	case FORMAT_CSV:
+		if (!csv_header)
+		{
+			printf("%s\n", record_csv_header(record).c_str());
+			csv_header = true;
+		}
+		printf("%s\n", record_csv(record).c_str());
+		break;
+	}
+
+	if (!options.history_file.empty())
+	{
+		append_history(options.history_file, record);
+	}
+}
+
+#endif
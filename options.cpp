@@ -0,0 +1,537 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	options.cpp - Command line options of a transfer
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					int parse_transfer_option(int argc, char *argv[], int &index, TransferOptions &options)
+--					std::string transfer_option_usage()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The server, client and bench modes all accept the same transfer options. They are parsed here into a
+--	TransferOptions structure, which is handed to the TCP and UDP classes with set_options.
+--
+--	--profile replaces the socket tuning with a named profile, and the single socket options (--sndbuf, --nodelay,
+--	...) override one option of it, so they go after --profile on the command line.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "options.h"
+
+// Transfer Options followed by a Value
+static const char *value_options[] = { "--payload", "--payload-file", "--batch", "--gso", "--sendfile", "--save", "--sink", "--uring", "--zerocopy", "--streams", "--loops", "--reuseport", "--reliable",
+	"--concurrency", "--rate", "--bitrate", "--pps", "--burst", "--ramp", "--trace",
+	"--format", "--history", "--profile", "--sndbuf", "--rcvbuf", "--nodelay", "--cork", "--notsent-lowat", "--cc",
+	"--busy-poll" };
+
+// Socket Tuning Profiles: name, SO_SNDBUF, SO_RCVBUF, TCP_NODELAY, TCP_CORK, TCP_NOTSENT_LOWAT, SO_BUSY_POLL and
+// congestion control (the default profile leaves every option to the OS)
+static const SocketTuning profiles[] =
+{
+	{ "default", 0, 0, -1, -1, 0, 0, "" },
+	{ "throughput", 4 * 1024 * 1024, 4 * 1024 * 1024, 0, -1, 0, 0, "" },
+	{ "bulk", 8 * 1024 * 1024, 8 * 1024 * 1024, 0, 1, 0, 0, "bbr" },
+	{ "latency", 0, 0, 1, 0, 16384, 50, "" },
+	{ "small", 64 * 1024, 64 * 1024, -1, -1, 0, 0, "" },
+};
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		takes_value
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		takes_value(const std::string &option)
+--						const std::string &option: Command line option
+--
+--	RETURNS:		bool - true if the option is a transfer option followed by a value.
+--
+--	NOTES:
+--	Looks the option up in value_options.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool takes_value(const std::string &option)
+{
+	for (const char *name : value_options)
+	{
+		if (option == name)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_rate
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_rate(const std::string &value, double &bits_per_second)
+--						const std::string &value: Rate with an optional k, m or g suffix (1000, 1000000, 1000000000)
+--						double &bits_per_second: Set to the rate
+--
+--	RETURNS:		bool - true if the value is a positive rate.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool parse_rate(const std::string &value, double &bits_per_second)
+{
+	char *end;
+	double rate = strtod(value.c_str(), &end);
+	bool has_number = (end != value.c_str());
+
+	switch (*end)
+	{
+	case 'k':
+	case 'K':
+		rate *= 1e3;
+		end++;
+		break;
+	case 'm':
+	case 'M':
+		rate *= 1e6;
+		end++;
+		break;
+	case 'g':
+	case 'G':
+		rate *= 1e9;
+		end++;
+		break;
+	}
+
+	if (!has_number || *end != '\0' || rate <= 0)
+	{
+		return false;
+	}
+
+	bits_per_second = rate;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_transfer_option
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added --batch]
+--					October 16, 2026 [Added --gso]
+--					October 16, 2026 [Added --sendfile]
+--					October 16, 2026 [Added --save and --sink]
+--					October 16, 2026 [Added --uring]
+--					October 16, 2026 [Added --streams]
+--					October 16, 2026 [Added --loops]
+--					October 16, 2026 [Added --reuseport]
+--					October 16, 2026 [Added --reliable]
+--					October 16, 2026 [Added --stamp]
+--					October 16, 2026 [Added --echo, --concurrency and --rate]
+--					October 16, 2026 [Added --bitrate, --pps, --burst and --ramp]
+--					October 16, 2026 [Added --trace]
+--					October 16, 2026 [Added --format and --history]
+--					October 16, 2026 [Added --profile and the socket option overrides]
+--					October 16, 2026 [Added --zerocopy]
+--					October 16, 2026 [Added --timestamps]
+--					October 17, 2026 [Added --frame]
+--					October 17, 2026 [Added --verify]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_transfer_option(int argc, char *argv[], int &index, TransferOptions &options)
+--						int argc: Number of arguments
+--						char *argv[]: Arguments
+--						int &index: Index of the option, advanced past its value if it has one
+--						TransferOptions &options: Set from the option
+--
+--	RETURNS:		int - 1 if the option was parsed, 0 if it is not a transfer option, -1 if its value is invalid.
+--
+--	NOTES:
+--	Parses the transfer option at argv[index]. Errors are printed to stderr.
+----------------------------------------------------------------------------------------------------------------------*/
+int parse_transfer_option(int argc, char *argv[], int &index, TransferOptions &options)
+{
+	std::string option = argv[index];
+
+	if (option == "--hugepages")
+	{
+		options.hugepages = true;
+		return 1;
+	}
+	if (option == "--stamp")
+	{
+		options.stamp = true;
+		return 1;
+	}
+	if (option == "--timestamps")
+	{
+		options.stamp = true;
+		options.timestamps = true;
+		return 1;
+	}
+	if (option == "--echo")
+	{
+		options.echo = true;
+		return 1;
+	}
+	if (option == "--frame")
+	{
+		options.frame = true;
+		return 1;
+	}
+	if (option == "--verify")
+	{
+		options.frame = true;
+		options.verify = true;
+		return 1;
+	}
+
+	if (!takes_value(option))
+	{
+		return 0;
+	}
+
+	if (index + 1 >= argc)
+	{
+		fprintf(stderr, "Missing value for %s\n", option.c_str());
+		return -1;
+	}
+
+	std::string value = argv[++index];
+
+	if (option == "--batch")
+	{
+		options.batch_size = atoi(value.c_str());
+		if (options.batch_size < 1 || options.batch_size > UDP_MAX_BATCH)
+		{
+			fprintf(stderr, "Batch size must be between 1 and %d\n", UDP_MAX_BATCH);
+			return -1;
+		}
+	}
+	else if (option == "--gso")
+	{
+		options.gso_size = atoi(value.c_str());
+		if (options.gso_size < 1 || options.gso_size > UDP_DATAGRAM_MAX)
+		{
+			fprintf(stderr, "Invalid segment size %s\n", value.c_str());
+			return -1;
+		}
+	}
+	else if (option == "--uring")
+	{
+		options.uring_depth = atoi(value.c_str());
+		if (options.uring_depth < 1 || options.uring_depth > URING_MAX_DEPTH)
+		{
+			fprintf(stderr, "Queue depth must be between 1 and %d\n", URING_MAX_DEPTH);
+			return -1;
+		}
+	}
+	else if (option == "--zerocopy")
+	{
+		options.zerocopy_depth = atoi(value.c_str());
+		if (options.zerocopy_depth < 1 || options.zerocopy_depth > ZEROCOPY_MAX_DEPTH)
+		{
+			fprintf(stderr, "Zero-copy pool size must be between 1 and %d\n", ZEROCOPY_MAX_DEPTH);
+			return -1;
+		}
+	}
+	else if (option == "--streams")
+	{
+		options.streams = atoi(value.c_str());
+		if (options.streams < 1 || options.streams > TCP_MAX_STREAMS)
+		{
+			fprintf(stderr, "Stream count must be between 1 and %d\n", TCP_MAX_STREAMS);
+			return -1;
+		}
+	}
+	else if (option == "--loops")
+	{
+		options.server_loops = atoi(value.c_str());
+		if (options.server_loops < 0 || options.server_loops > SERVER_MAX_LOOPS)
+		{
+			fprintf(stderr, "Event loop count must be between 0 and %d\n", SERVER_MAX_LOOPS);
+			return -1;
+		}
+	}
+	else if (option == "--reuseport")
+	{
+		options.reuseport = atoi(value.c_str());
+		if (options.reuseport < 1 || options.reuseport > SERVER_MAX_LOOPS)
+		{
+			fprintf(stderr, "Socket count must be between 1 and %d\n", SERVER_MAX_LOOPS);
+			return -1;
+		}
+	}
+	else if (option == "--reliable")
+	{
+		options.reliable_window = atoi(value.c_str());
+		if (options.reliable_window < 1 || options.reliable_window > RUDP_MAX_WINDOW)
+		{
+			fprintf(stderr, "Reliable UDP window must be between 1 and %d\n", RUDP_MAX_WINDOW);
+			return -1;
+		}
+	}
+	else if (option == "--concurrency")
+	{
+		options.concurrency = atoi(value.c_str());
+		if (options.concurrency < 1 || options.concurrency > LATENCY_MAX_CONCURRENCY)
+		{
+			fprintf(stderr, "Concurrency must be between 1 and %d\n", LATENCY_MAX_CONCURRENCY);
+			return -1;
+		}
+	}
+	else if (option == "--rate")
+	{
+		options.request_rate = atoi(value.c_str());
+		if (options.request_rate < 0)
+		{
+			fprintf(stderr, "Request rate must be 0 (closed loop) or more\n");
+			return -1;
+		}
+	}
+	else if (option == "--bitrate")
+	{
+		if (!parse_rate(value, options.pace_bps))
+		{
+			fprintf(stderr, "Bit rate must be a positive number of bits/s, with an optional k, m or g suffix\n");
+			return -1;
+		}
+	}
+	else if (option == "--pps")
+	{
+		options.pace_pps = atof(value.c_str());
+		if (options.pace_pps <= 0)
+		{
+			fprintf(stderr, "Packet rate must be a positive number of packets/s\n");
+			return -1;
+		}
+	}
+	else if (option == "--burst")
+	{
+		options.burst = atoi(value.c_str());
+		if (options.burst < 1 || options.burst > PACE_MAX_BURST)
+		{
+			fprintf(stderr, "Burst size must be between 1 and %d packets\n", PACE_MAX_BURST);
+			return -1;
+		}
+	}
+	else if (option == "--ramp")
+	{
+		options.ramp_loss = atof(value.c_str());
+		if (options.ramp_loss <= 0 || options.ramp_loss >= 100)
+		{
+			fprintf(stderr, "Ramp loss threshold must be a percentage between 0 and 100\n");
+			return -1;
+		}
+	}
+	else if (option == "--sendfile")
+	{
+		options.send_file = value;
+	}
+	else if (option == "--save")
+	{
+		options.save_file = value;
+	}
+	else if (option == "--trace")
+	{
+		options.trace_file = value;
+	}
+	else if (option == "--history")
+	{
+		options.history_file = value;
+	}
+	else if (option == "--profile")
+	{
+		std::string names;
+
+		for (const SocketTuning &profile : profiles)
+		{
+			if (value == profile.profile)
+			{
+				options.tuning = profile;
+				return 1;
+			}
+			names += " " + profile.profile;
+		}
+		fprintf(stderr, "Unknown profile %s, the profiles are:%s\n", value.c_str(), names.c_str());
+		return -1;
+	}
+	else if (option == "--cc")
+	{
+		options.tuning.congestion = value;
+	}
+	else if (option == "--nodelay" || option == "--cork")
+	{
+		int flag = atoi(value.c_str());
+
+		if (value != "0" && value != "1")
+		{
+			fprintf(stderr, "%s must be 0 or 1\n", option.c_str());
+			return -1;
+		}
+		if (option == "--nodelay")
+			options.tuning.nodelay = flag;
+		else
+			options.tuning.cork = flag;
+	}
+	else if (option == "--sndbuf" || option == "--rcvbuf" || option == "--notsent-lowat" || option == "--busy-poll")
+	{
+		int size = atoi(value.c_str());
+
+		if (size < 1)
+		{
+			fprintf(stderr, "%s must be a positive number\n", option.c_str());
+			return -1;
+		}
+		if (option == "--sndbuf")
+			options.tuning.sndbuf = size;
+		else if (option == "--rcvbuf")
+			options.tuning.rcvbuf = size;
+		else if (option == "--notsent-lowat")
+			options.tuning.notsent_lowat = size;
+		else
+			options.tuning.busy_poll = size;
+	}
+	else if (option == "--format")
+	{
+		if (value == "text")
+			options.format = FORMAT_TEXT;
+		else if (value == "json")
+			options.format = FORMAT_JSON;
+		else if (value == "csv")
+			options.format = FORMAT_CSV;
+		else
+		{
+			fprintf(stderr, "Unknown format %s\n", value.c_str());
+			return -1;
+		}
+	}
+	else if (option == "--sink")
+	{
+		if (value == "buffered")
+			options.sink = SINK_BUFFERED;
+		else if (value == "mmap")
+			options.sink = SINK_MMAP;
+		else if (value == "direct")
+			options.sink = SINK_DIRECT;
+		else
+		{
+			fprintf(stderr, "Unknown sink %s\n", value.c_str());
+			return -1;
+		}
+	}
+	else if (option == "--payload-file")
+	{
+		options.payload = PAYLOAD_FILE;
+		options.payload_file = value;
+	}
+	else if (value == "pattern")
+		options.payload = PAYLOAD_PATTERN;
+	else if (value == "simd")
+		options.payload = PAYLOAD_SIMD;
+	else if (value == "random")
+		options.payload = PAYLOAD_RANDOM;
+	else if (value == "zero")
+		options.payload = PAYLOAD_ZERO;
+	else
+	{
+		fprintf(stderr, "Unknown payload %s\n", value.c_str());
+		return -1;
+	}
+
+	return 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		transfer_option_usage
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added --batch]
+--					October 16, 2026 [Added --gso]
+--					October 16, 2026 [Added --sendfile]
+--					October 16, 2026 [Added --save and --sink]
+--					October 16, 2026 [Added --uring]
+--					October 16, 2026 [Added --streams]
+--					October 16, 2026 [Added --loops]
+--					October 16, 2026 [Added --reuseport]
+--					October 16, 2026 [Added --reliable]
+--					October 16, 2026 [Added --stamp]
+--					October 16, 2026 [Added --echo, --concurrency and --rate]
+--					October 16, 2026 [Added --bitrate, --pps, --burst and --ramp]
+--					October 16, 2026 [Added --trace]
+--					October 16, 2026 [Added --format and --history]
+--					October 16, 2026 [Added --profile and the socket option overrides]
+--					October 16, 2026 [Added --zerocopy]
+--					October 16, 2026 [Added --timestamps]
+--					October 17, 2026 [Added --frame]
+--					October 17, 2026 [Added --verify]
+--					October 17, 2026 [--save only saves transfers of one connection]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		transfer_option_usage()
+--
+--	RETURNS:		std::string - the help text of the transfer options.
+--
+--	NOTES:
+--	Appended to the usage of every mode.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string transfer_option_usage()
+{
+	std::string help_text("Transfer Options:\n");
+	help_text += "   --hugepages                             Back the receive buffers with huge pages\n";
+	help_text += "   --payload pattern|simd|random|zero      Data sent by the Client (default pattern)\n";
+	help_text += "   --payload-file path                     Send the contents of a file\n";
+	help_text += "   --batch N                               UDP datagrams per sendmmsg/recvmmsg call (default 1)\n";
+	help_text += "   --sendfile path                         TCP Client streams a file with sendfile/splice\n";
+	help_text += "   --save path                             TCP Server writes every transfer of one connection to a file\n";
+	help_text += "   --sink buffered|mmap|direct             Write strategy of --save (default buffered)\n";
+	help_text += "   --gso N                                 Send UDP packets as N Byte segments, coalesce with GRO\n";
+	help_text += "   --uring N                               Send and receive through io_uring, N operations in flight\n";
+	help_text += "   --zerocopy N                            TCP Client sends with MSG_ZEROCOPY, N sends in flight\n";
+	help_text += "   --streams N                             TCP Client stripes the packets across N connections\n";
+	help_text += "   --loops N                               TCP Server event loops, one per core if 0 (default 0)\n";
+	help_text += "   --reuseport N                           UDP Server receives on N SO_REUSEPORT sockets, one thread each\n";
+	help_text += "   --reliable N                            Reliable UDP (sequence numbers, SACK, retransmission), N in flight\n";
+	help_text += "   --stamp                                 UDP Client stamps datagrams for loss/reorder/jitter analysis\n";
+	help_text += "   --timestamps                            UDP one-way delay from kernel timestamps (implies --stamp)\n";
+	help_text += "   --frame                                 TCP packets carry a header, sent with sendmsg, parsed in place\n";
+	help_text += "   --verify                                TCP Client checksums every packet with CRC32C (implies --frame)\n";
+	help_text += "   --echo                                  Server sends every packet back (for the latency modes)\n";
+	help_text += "   --concurrency N                         Latency modes keep N requests in flight (default 1)\n";
+	help_text += "   --rate N                                Latency modes send N requests/s, closed loop if 0 (default 0)\n";
+	help_text += "   --bitrate N[k|m|g]                      Clients pace the packets to N bits/s with a token bucket\n";
+	help_text += "   --pps N                                 Clients pace the packets to N packets/s\n";
+	help_text += "   --burst N                               Packets the pacing lets out back to back (default 1)\n";
+	help_text += "   --ramp X                                UDP Client searches the highest rate with at most X% loss\n";
+	help_text += "   --trace path                            Record every send/receive call, dump them after each transfer\n";
+	help_text += "   --format text|json|csv                  Print the results as text, JSON lines or CSV (default text)\n";
+	help_text += "   --history path                          Append the JSON line of every transfer to a run history\n";
+	help_text += "   --profile default|throughput|bulk|latency|small  Socket tuning profile of every socket\n";
+	help_text += "   --sndbuf N, --rcvbuf N                  Socket buffer sizes in Bytes (override the profile)\n";
+	help_text += "   --nodelay 0|1, --cork 0|1               TCP_NODELAY and TCP_CORK\n";
+	help_text += "   --notsent-lowat N                       TCP_NOTSENT_LOWAT in Bytes\n";
+	help_text += "   --cc name                               TCP congestion control algorithm (e.g. cubic, bbr)\n";
+	help_text += "   --busy-poll N                           SO_BUSY_POLL in microseconds\n";
+
+	return help_text;
+}
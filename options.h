@@ -0,0 +1,7 @@
+#pragma once
+
+#include "transport.h"
+
+// Transfer Option Parsing (shared by the command line modes and the bench runner)
+int parse_transfer_option(int argc, char *argv[], int &index, TransferOptions &options);
+std::string transfer_option_usage();
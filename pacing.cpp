@@ -0,0 +1,234 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	pacing.cpp - Token bucket pacing of the Clients
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void start(const TransferOptions &options, int packet_size)
+--					void take(int packets)
+--					uint64_t reserve(int packets)
+--					void append_report(std::string &print_output, long long total_bytes, double elapsed_ms)
+--					void pace_until(uint64_t due_ns)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	Without pacing the Clients send as fast as the socket takes the data, so a UDP transfer mostly measures how
+--	many datagrams the receiver drops when it is flooded. With a target bit rate (--bitrate) or packet rate (--pps)
+--	the Client takes a packet's worth of tokens from a TokenBucket before every send. The bucket fills at the target
+--	rate and holds at most --burst packets, so no more than one burst ever leaves back to back, and over any longer
+--	period the rate never exceeds the target. A sender that wakes up late catches up by at most one burst. The rate
+--	counts the packet payload only, not the UDP/IP headers.
+--
+--	The waits are timed on the monotonic clock. Waits longer than PACE_SPIN_NS are slept with an absolute
+--	clock_nanosleep, which wakes up to the kernel's timer slack late, and the rest is spun, so packets leave within
+--	a few microseconds of their due time.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "pacing.h"
+#include "timing.h"
+#include <time.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(const TransferOptions &options, int packet_size)
+--						const TransferOptions &options: Target rate and burst size
+--						int packet_size: Size of a packet in Bytes
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Starts the bucket full, so the first burst leaves at once. Without a target rate the bucket is inactive and
+--	take returns immediately. A packet rate is converted to the bit rate of packet_size Byte packets.
+----------------------------------------------------------------------------------------------------------------------*/
+void TokenBucket::start(const TransferOptions &options, int packet_size)
+{
+	size = packet_size;
+	burst = (options.burst > 0) ? options.burst : 1;
+	rate = (options.pace_bps > 0) ? options.pace_bps / 8.0 : options.pace_pps * packet_size;
+	capacity = (double)burst * packet_size;
+	tokens = capacity;
+	wait_count = 0;
+	last_ns = monotonic_ns();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		take
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Split the token accounting into reserve]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		take(int packets)
+--						int packets: Number of packets about to be sent, at most the burst size
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Waits until the bucket holds the tokens of the packets, then takes them.
+----------------------------------------------------------------------------------------------------------------------*/
+void TokenBucket::take(int packets)
+{
+	uint64_t due_ns = reserve(packets);
+
+	if (due_ns > 0)
+	{
+		pace_until(due_ns);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		reserve
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Keep the schedule across late wakeups]
+--					October 17, 2026 [Cap the catch-up of a late sender at one burst]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		reserve(int packets)
+--						int packets: Number of packets about to be sent, at most the burst size
+--
+--	RETURNS:		uint64_t - the time the packets may be sent, or 0 if they may be sent at once.
+--
+--	NOTES:
+--	Takes the tokens of the packets without waiting, so a coroutine can sleep until the due time on its executor.
+--	The packets must not be sent, nor more reserved, before the due time.
+--	The bucket is refilled from the time elapsed since the last call, so time spent outside take (in the send call)
+--	also earns tokens. A wait moves last_ns to the due time, not to the wakeup, so a late wakeup earns its delay
+--	back, up to the capacity of the bucket: a sender that fell behind the schedule sends at most one burst back to
+--	back to catch up, and anything later than that is lost.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t TokenBucket::reserve(int packets)
+{
+	double needed = (double)packets * size;
+	uint64_t now_ns;
+	uint64_t due_ns = 0;
+
+	if (rate <= 0)
+	{
+		return 0;
+	}
+	if (needed > capacity)
+	{
+		needed = capacity;
+	}
+
+	// Refill on the Schedule, which Runs ahead of the Clock while Packets are Due
+	now_ns = monotonic_ns();
+	if (now_ns > last_ns)
+	{
+		tokens += (now_ns - last_ns) * rate / 1e9;
+		last_ns = now_ns;
+	}
+	if (tokens > capacity)
+	{
+		tokens = capacity;
+	}
+
+	// Wait for the Missing Tokens
+	tokens -= needed;
+	if (tokens < 0)
+	{
+		due_ns = last_ns + (uint64_t)(-tokens / rate * 1e9);
+		wait_count++;
+		tokens = 0;
+		last_ns = due_ns;
+	}
+
+	return due_ns;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output, long long total_bytes, double elapsed_ms)
+--						std::string &print_output: Output string the statistics are appended to
+--						long long total_bytes: Bytes sent through the bucket
+--						double elapsed_ms: Time the sending took
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the target and the achieved rate, and how often the sender had to wait for tokens.
+----------------------------------------------------------------------------------------------------------------------*/
+void TokenBucket::append_report(std::string &print_output, long long total_bytes, double elapsed_ms) const
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nPacing: %.2f Mbit/s target, burst %d (%lld waits), %.2f Mbit/s sent",
+		target_mbps(), burst, wait_count, (elapsed_ms > 0) ? total_bytes * 8.0 / (elapsed_ms * 1000.0) : 0);
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		pace_until
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		pace_until(uint64_t due_ns)
+--						uint64_t due_ns: Time to wait for, on the monotonic clock
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sleeps until PACE_SPIN_NS before the due time, then spins.
+----------------------------------------------------------------------------------------------------------------------*/
+void pace_until(uint64_t due_ns)
+{
+	uint64_t now_ns = monotonic_ns();
+
+	if (due_ns > now_ns + PACE_SPIN_NS)
+	{
+		uint64_t wake_ns = due_ns - PACE_SPIN_NS;
+		struct timespec wake;
+
+		wake.tv_sec = (time_t)(wake_ns / 1000000000ULL);
+		wake.tv_nsec = (long)(wake_ns % 1000000000ULL);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR)
+			;
+	}
+
+	while (monotonic_ns() < due_ns)
+		;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+// Waits Shorter than this are Spun instead of Slept (the kernel's timer slack is 50 us)
+#define PACE_SPIN_NS 60000
+
+// Rate Search of --ramp: Start Rate (bit/s), Bisection Precision and Step Limit
+#define PACE_RAMP_START 10e6
+#define PACE_RAMP_PRECISION 0.05
+#define PACE_RAMP_STEPS 24
+
+// Token Bucket Pacing of a Sender, in Bytes
+class TokenBucket
+{
+	public:
+		TokenBucket() {};
+		~TokenBucket() {};
+		void start(const TransferOptions &options, int packet_size);
+		bool active() const { return rate > 0; };
+		void take(int packets);
+		uint64_t reserve(int packets);
+		long long waits() const { return wait_count; };
+		void add_waits(const TokenBucket &other) { wait_count += other.wait_count; };
+		double target_mbps() const { return rate * 8.0 / 1e6; };
+		int burst_packets() const { return burst; };
+		void append_report(std::string &print_output, long long total_bytes, double elapsed_ms) const;
+	private:
+		double rate = 0;
+		double capacity = 0;
+		double tokens = 0;
+		int size = 0;
+		int burst = 1;
+		uint64_t last_ns = 0;
+		long long wait_count = 0;
+};
+
+void pace_until(uint64_t due_ns);
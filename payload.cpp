@@ -0,0 +1,334 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	payload.cpp - Generates the data the Clients send
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void fill_pattern(char *buf, size_t len)
+--					bool prepare(const TransferOptions &options, int packet_size, int num_packet, bool end_marker)
+--					const char *packet(int index)
+--					const char *mode_name()
+--					std::vector<struct iovec> buffers()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The send loops used to rebuild the A-Z pattern byte by byte, with a modulo per byte, once for every packet. At
+--	large packet sizes that work showed up in the sender's CPU time and made the protocols look slower than they are.
+--	The Payload is prepared once before the transfer starts and hands the send loops read-only views of each packet:
+--
+--		pattern	The A-Z pattern, generated once and sent for every packet.
+--		simd	The A-Z pattern, regenerated for every packet with a 16 byte vector fill. This keeps the original
+--				per-packet generation but at a fraction of its cost.
+--		random	Incompressible pseudo-random data. PAYLOAD_PACKETS different packets are generated and sent in turn.
+--		zero	All zero bytes.
+--		file	The contents of a file, repeated if the file is shorter than the transfer.
+--
+--	When an end marker is requested (UDP), the last byte of the last packet is the EOT character. The marker is
+--	written into a copy, so the shared views are never modified.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "payload.h"
+#include "timing.h"
+#include <string.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PAYLOAD_SSE2
+#endif
+
+#ifdef PAYLOAD_SSE2
+// The A-Z Pattern as a 16 Byte Vector at each of its 26 Phases
+struct PatternVectors
+{
+	__m128i phase[PATTERN_LENGTH];
+
+	PatternVectors()
+	{
+		for (int p = 0; p < PATTERN_LENGTH; p++)
+		{
+			char bytes[16];
+			for (int i = 0; i < 16; i++)
+			{
+				bytes[i] = 'A' + (p + i) % PATTERN_LENGTH;
+			}
+			phase[p] = _mm_loadu_si128((const __m128i *)bytes);
+		}
+	}
+};
+
+static const PatternVectors pattern_vectors;
+#endif
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		fill_pattern
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		fill_pattern(char *buf, size_t len)
+--						char *buf: Buffer to fill
+--						size_t len: Length of the buffer in Bytes
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Writes 'A' + (i % 26) at every offset i, the same bytes as the original send loops. With SSE2 the buffer is
+--	written 16 bytes at a time from the precomputed vector for the current phase of the pattern; the tail (and every
+--	byte on other targets) is written one at a time.
+----------------------------------------------------------------------------------------------------------------------*/
+void fill_pattern(char *buf, size_t len)
+{
+	size_t i = 0;
+
+#ifdef PAYLOAD_SSE2
+	int phase = 0;
+
+	for (; i + 16 <= len; i += 16)
+	{
+		_mm_storeu_si128((__m128i *)(buf + i), pattern_vectors.phase[phase]);
+		phase += 16;
+		if (phase >= PATTERN_LENGTH)
+		{
+			phase -= PATTERN_LENGTH;
+		}
+	}
+#endif
+
+	for (; i < len; i++)
+	{
+		buf[i] = 'A' + (char)(i % PATTERN_LENGTH);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		prepare
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		prepare(const TransferOptions &options, int packet_size, int num_packet, bool end_marker)
+--						const TransferOptions &options: Payload mode and file
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--						bool end_marker: Put the EOT character in the last byte of the last packet
+--
+--	RETURNS:		bool - false if the payload file could not be read.
+--
+--	NOTES:
+--	Generates the payload before the transfer starts, so none of this work is timed. The random and file modes keep
+--	at most PAYLOAD_PACKETS packets (and at most PAYLOAD_REGION_MAX Bytes) and send them in turn.
+----------------------------------------------------------------------------------------------------------------------*/
+bool Payload::prepare(const TransferOptions &options, int packet_size, int num_packet, bool end_marker)
+{
+	mode = options.payload;
+	size = packet_size;
+	count = num_packet;
+	marker = end_marker;
+	region_packets = 1;
+
+	if (mode == PAYLOAD_RANDOM || mode == PAYLOAD_FILE)
+	{
+		region_packets = PAYLOAD_REGION_MAX / packet_size;
+		if (region_packets > PAYLOAD_PACKETS)
+			region_packets = PAYLOAD_PACKETS;
+		if (region_packets > num_packet)
+			region_packets = num_packet;
+		if (region_packets < 1)
+			region_packets = 1;
+	}
+
+	region.assign((size_t)packet_size * region_packets, 0);
+
+	switch (mode)
+	{
+	case PAYLOAD_PATTERN:
+	case PAYLOAD_SIMD:
+		fill_pattern(region.data(), region.size());
+		break;
+	case PAYLOAD_RANDOM:
+	{
+		// xorshift64* Generator, 8 Bytes per Step
+		uint64_t state = monotonic_ns() | 1;
+		size_t i = 0;
+
+		for (; i < region.size(); i += sizeof(uint64_t))
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			uint64_t value = state * 0x2545F4914F6CDD1DULL;
+			memcpy(&region[i], &value, (region.size() - i < sizeof(value)) ? region.size() - i : sizeof(value));
+		}
+		break;
+	}
+	case PAYLOAD_ZERO:
+		break;
+	case PAYLOAD_FILE:
+	{
+		FILE *file;
+		size_t filled = 0;
+		size_t read_bytes;
+
+		if ((file = fopen(options.payload_file.c_str(), "rb")) == NULL)
+		{
+			perror("Cannot open payload file");
+			return false;
+		}
+
+		// Repeat the File until the Region is Full
+		while (filled < region.size())
+		{
+			if ((read_bytes = fread(&region[filled], 1, region.size() - filled, file)) == 0)
+			{
+				if (ferror(file) || filled == 0)
+				{
+					fprintf(stderr, "Cannot read payload file %s\n", options.payload_file.c_str());
+					fclose(file);
+					return false;
+				}
+				rewind(file);
+			}
+			filled += read_bytes;
+		}
+
+		fclose(file);
+		break;
+	}
+	}
+
+	if (marker)
+	{
+		last.resize(packet_size);
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		packet
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		packet(int index)
+--						int index: Index of the packet, from 0 to num_packet - 1
+--
+--	RETURNS:		const char * - read-only view of packet_size Bytes, valid until the next call.
+--
+--	NOTES:
+--	Returns the payload of one packet. Only the simd mode does any work here (it regenerates the packet); the other
+--	modes return a pointer into the prepared region.
+----------------------------------------------------------------------------------------------------------------------*/
+const char *Payload::packet(int index)
+{
+	const char *view = region.data() + (size_t)(index % region_packets) * size;
+
+	if (mode == PAYLOAD_SIMD)
+	{
+		fill_pattern(region.data(), size);
+	}
+
+	if (marker && index == count - 1)
+	{
+		memcpy(last.data(), view, size);
+		last[size - 1] = EOT;
+		return last.data();
+	}
+
+	return view;
+}
+
+#ifndef _WIN32
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		buffers
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		buffers()
+--
+--	RETURNS:		std::vector<struct iovec> - the memory every packet view points into.
+--
+--	NOTES:
+--	Used by the io_uring engine to register the payload with the ring. The buffer of the EOT marker is included.
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<struct iovec> Payload::buffers() const
+{
+	std::vector<struct iovec> iovecs;
+	struct iovec iov;
+
+	iov.iov_base = (void *)region.data();
+	iov.iov_len = region.size();
+	iovecs.push_back(iov);
+
+	if (!last.empty())
+	{
+		iov.iov_base = (void *)last.data();
+		iov.iov_len = last.size();
+		iovecs.push_back(iov);
+	}
+
+	return iovecs;
+}
+
+#endif
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		mode_name
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		mode_name()
+--
+--	RETURNS:		const char * - name of the payload mode, as accepted by --payload.
+--
+--	NOTES:
+--	Used in the Client output.
+----------------------------------------------------------------------------------------------------------------------*/
+const char *Payload::mode_name() const
+{
+	switch (mode)
+	{
+	case PAYLOAD_SIMD:
+		return "simd";
+	case PAYLOAD_RANDOM:
+		return "random";
+	case PAYLOAD_ZERO:
+		return "zero";
+	case PAYLOAD_FILE:
+		return "file";
+	default:
+		return "pattern";
+	}
+}
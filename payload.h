@@ -0,0 +1,35 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
+#define PATTERN_LENGTH 26
+#define PAYLOAD_PACKETS 64
+#define PAYLOAD_REGION_MAX (16 * 1024 * 1024)
+
+// Fill a Buffer with the A-Z Pattern
+void fill_pattern(char *buf, size_t len);
+
+class Payload
+{
+	public:
+		Payload() {};
+		~Payload() {};
+		bool prepare(const TransferOptions &options, int packet_size, int num_packet, bool end_marker);
+		const char *packet(int index);
+		const char *mode_name() const;
+#ifndef _WIN32
+		std::vector<struct iovec> buffers() const;
+#endif
+	private:
+		PayloadMode mode = PAYLOAD_PATTERN;
+		int size = 0;
+		int count = 0;
+		int region_packets = 0;
+		bool marker = false;
+		std::vector<char> region;
+		std::vector<char> last;
+};
@@ -0,0 +1,939 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	record.cpp - Machine readable run records (JSON lines and CSV) and the run history
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					CpuSample cpu_sample()
+--					CpuSample cpu_since(const CpuSample &start)
+--					std::vector<RecordField> record_fields(const RunRecord &record)
+--					std::string record_json(const RunRecord &record)
+--					std::string record_csv_header(const RunRecord &record)
+--					std::string record_csv(const RunRecord &record)
+--					bool append_history(const std::string &path, const RunRecord &record)
+--					bool read_history(const std::string &path, std::vector<HistoryRun> &runs)
+--					int query_history(int argc, char *argv[])
+--					int compare_history(int argc, char *argv[])
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The statistics of a transfer are built up as text for the window or the console, so scripts had to scrape the
+--	numbers back out of the text. A RunRecord holds what was run (mode, protocol, sizes, the transfer and socket
+--	options), what the Client and/or the Server measured, and the CPU time the process used. record_fields flattens
+--	it into named values, which are written as one JSON object per line or as CSV, with --format json|csv.
+--
+--	With --history the JSON line of every transfer is also appended to a history file. The history mode lists the
+--	runs of a history file, filtered by field values, and the compare mode prints two runs side by side with the
+--	change of every number. Both only need the flat JSON objects written here, so the history file can also be read
+--	by any JSON lines tool.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "record.h"
+#include <sys/resource.h>
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		cpu_sample
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		cpu_sample()
+--
+--	RETURNS:		CpuSample - the user and system CPU time used by every thread of the process so far.
+----------------------------------------------------------------------------------------------------------------------*/
+CpuSample cpu_sample()
+{
+	CpuSample sample;
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		sample.user_ms = usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3;
+		sample.sys_ms = usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3;
+	}
+
+	return sample;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		cpu_since
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		cpu_since(const CpuSample &start)
+--						const CpuSample &start: Sample taken when the transfer started
+--
+--	RETURNS:		CpuSample - the CPU time used since the sample.
+----------------------------------------------------------------------------------------------------------------------*/
+CpuSample cpu_since(const CpuSample &start)
+{
+	CpuSample now = cpu_sample();
+
+	now.user_ms -= start.user_ms;
+	now.sys_ms -= start.sys_ms;
+	return now;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		add_number
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		add_number(std::vector<RecordField> &fields, const std::string &name, double value)
+--						std::vector<RecordField> &fields: Fields the value is appended to
+--						const std::string &name: Name of the field
+--						double value: Value of the field
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Whole numbers are written without a fraction, others with three decimals.
+----------------------------------------------------------------------------------------------------------------------*/
+static void add_number(std::vector<RecordField> &fields, const std::string &name, double value)
+{
+	char text[BUFFERSIZE];
+
+	if (value == (double)(long long)value)
+		snprintf(text, sizeof(text), "%lld", (long long)value);
+	else
+		snprintf(text, sizeof(text), "%.3f", value);
+	fields.push_back({ name, text, false });
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		add_result
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added the effective socket settings]
+--					October 16, 2026 [Added the one-way delay]
+--					October 17, 2026 [Added the frames]
+--					October 17, 2026 [Added the checksum errors and time]
+--					October 17, 2026 [Added the pacing waits]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		add_result(std::vector<RecordField> &fields, const std::string &side, const TransferResult &result)
+--						std::vector<RecordField> &fields: Fields the statistics are appended to
+--						const std::string &side: "client" or "server", the prefix of the field names
+--						const TransferResult &result: Statistics measured by the side
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	A side that only timed the transfer gets its throughput from the bytes and the elapsed time.
+----------------------------------------------------------------------------------------------------------------------*/
+static void add_result(std::vector<RecordField> &fields, const std::string &side, const TransferResult &result)
+{
+	add_number(fields, side + "_bytes", (double)result.total_bytes);
+	add_number(fields, side + "_packets", (double)result.packets);
+	add_number(fields, side + "_segments", (double)result.segments);
+	add_number(fields, side + "_streams", result.streams);
+	add_number(fields, side + "_elapsed_ms", result.elapsed_ms);
+	add_number(fields, side + "_ttfb_ms", result.ttfb_ms);
+
+	// The Clients only Time the Transfer
+	if (result.throughput_mbps == 0 && result.elapsed_ms > 0)
+		add_number(fields, side + "_throughput_mbps", result.total_bytes * 8.0 / (result.elapsed_ms * 1000.0));
+	else
+		add_number(fields, side + "_throughput_mbps", result.throughput_mbps);
+	add_number(fields, side + "_gap_p50_us", result.gap_p50_us);
+	add_number(fields, side + "_gap_p99_us", result.gap_p99_us);
+	add_number(fields, side + "_gap_p999_us", result.gap_p999_us);
+	add_number(fields, side + "_touched_per_byte", result.touched_per_byte);
+	add_number(fields, side + "_per_call", result.datagrams_per_call);
+	add_number(fields, side + "_syscalls", (double)result.syscalls);
+	add_number(fields, side + "_pace_waits", (double)result.pace_waits);
+	add_number(fields, side + "_zerocopy", (double)result.zerocopy_completions);
+	add_number(fields, side + "_copied", (double)result.copied_completions);
+	add_number(fields, side + "_frames", (double)result.frames);
+	add_number(fields, side + "_frame_errors", (double)result.frame_errors);
+	add_number(fields, side + "_crc_errors", (double)result.crc_errors);
+	add_number(fields, side + "_verify_ms", result.verify_ms);
+	add_number(fields, side + "_disk_mbps", result.disk_mbps);
+	add_number(fields, side + "_lost", (double)result.datagrams_lost);
+	add_number(fields, side + "_reordered", (double)result.datagrams_reordered);
+	add_number(fields, side + "_duplicated", (double)result.datagrams_duplicated);
+	add_number(fields, side + "_loss_percent", result.loss_rate);
+	add_number(fields, side + "_jitter_us", result.jitter_us);
+	add_number(fields, side + "_rtt_p50_us", result.rtt_p50_us);
+	add_number(fields, side + "_rtt_p99_us", result.rtt_p99_us);
+	add_number(fields, side + "_rtt_p999_us", result.rtt_p999_us);
+	add_number(fields, side + "_rtt_max_us", result.rtt_max_us);
+	add_number(fields, side + "_one_way_p50_us", result.one_way_p50_us);
+	add_number(fields, side + "_one_way_p99_us", result.one_way_p99_us);
+	add_number(fields, side + "_send_stack_p50_us", result.send_stack_p50_us);
+	add_number(fields, side + "_network_p50_us", result.network_p50_us);
+	add_number(fields, side + "_recv_stack_p50_us", result.recv_stack_p50_us);
+
+	// Effective Socket Settings (-1 where not read back)
+	add_number(fields, side + "_sndbuf", result.socket.sndbuf);
+	add_number(fields, side + "_rcvbuf", result.socket.rcvbuf);
+	add_number(fields, side + "_nodelay", result.socket.nodelay);
+	add_number(fields, side + "_cork", result.socket.cork);
+	add_number(fields, side + "_notsent_lowat", result.socket.notsent_lowat);
+	add_number(fields, side + "_busy_poll", result.socket.busy_poll);
+	fields.push_back({ side + "_congestion", result.socket.congestion, true });
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_fields
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Added the socket profile]
+--					October 16, 2026 [Added --timestamps]
+--					October 17, 2026 [Added --frame]
+--					October 17, 2026 [Added --verify]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_fields(const RunRecord &record)
+--						const RunRecord &record: Record of a transfer
+--
+--	RETURNS:		std::vector<RecordField> - the named values of the record, in a fixed order.
+--
+--	NOTES:
+--	The order is the run, the options, the client statistics, the server statistics and the CPU time. The fields of
+--	a side that did not take part are left out, so every record of one mode has the same fields.
+----------------------------------------------------------------------------------------------------------------------*/
+std::vector<RecordField> record_fields(const RunRecord &record)
+{
+	static const char *payload_names[] = { "pattern", "simd", "random", "zero", "file" };
+	static const char *sink_names[] = { "buffered", "mmap", "direct" };
+	const TransferOptions &options = record.options;
+	std::vector<RecordField> fields;
+	time_t timestamp = (time_t)record.timestamp;
+	struct tm utc;
+	char time_text[BUFFERSIZE];
+
+	gmtime_r(&timestamp, &utc);
+	strftime(time_text, sizeof(time_text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+	// The Run
+	fields.push_back({ "time", time_text, true });
+	fields.push_back({ "mode", record.mode, true });
+	fields.push_back({ "protocol", (record.protocol == TCP_PROTOCOL) ? "tcp" : "udp", true });
+	fields.push_back({ "host", record.host, true });
+	add_number(fields, "port", record.port);
+	add_number(fields, "packet_size", record.packet_size);
+	add_number(fields, "num_packets", record.num_packets);
+	add_number(fields, "repetition", record.repetition);
+
+	// Transfer and Socket Options
+	fields.push_back({ "payload", payload_names[options.payload], true });
+	add_number(fields, "batch", options.batch_size);
+	add_number(fields, "gso", options.gso_size);
+	add_number(fields, "uring", options.uring_depth);
+	add_number(fields, "zerocopy", options.zerocopy_depth);
+	add_number(fields, "streams", options.streams);
+	add_number(fields, "loops", options.server_loops);
+	add_number(fields, "reuseport", options.reuseport);
+	add_number(fields, "reliable", options.reliable_window);
+	add_number(fields, "stamp", options.stamp);
+	add_number(fields, "timestamps", options.timestamps);
+	add_number(fields, "frame", options.frame);
+	add_number(fields, "verify", options.verify);
+	add_number(fields, "echo", options.echo);
+	add_number(fields, "hugepages", options.hugepages);
+	add_number(fields, "concurrency", options.concurrency);
+	add_number(fields, "request_rate", options.request_rate);
+	add_number(fields, "bitrate", options.pace_bps);
+	add_number(fields, "pps", options.pace_pps);
+	add_number(fields, "burst", options.burst);
+	fields.push_back({ "sendfile", options.send_file, true });
+	fields.push_back({ "save", options.save_file, true });
+	fields.push_back({ "sink", sink_names[options.sink], true });
+	fields.push_back({ "profile", options.tuning.profile, true });
+
+	// Measurements
+	if (record.has_client)
+	{
+		add_result(fields, "client", record.client);
+	}
+	if (record.has_server)
+	{
+		add_result(fields, "server", record.server);
+	}
+	add_number(fields, "cpu_user_ms", record.cpu.user_ms);
+	add_number(fields, "cpu_sys_ms", record.cpu.sys_ms);
+
+	return fields;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		quote
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		quote(const std::string &text, bool json)
+--						const std::string &text: Text to quote
+--						bool json: Escape for JSON instead of CSV
+--
+--	RETURNS:		std::string - the text in quotation marks.
+--
+--	NOTES:
+--	JSON escapes quotation marks, backslashes and control characters; CSV doubles quotation marks.
+----------------------------------------------------------------------------------------------------------------------*/
+static std::string quote(const std::string &text, bool json)
+{
+	std::string quoted("\"");
+
+	for (char c : text)
+	{
+		if (json && (c == '"' || c == '\\'))
+		{
+			quoted += '\\';
+			quoted += c;
+		}
+		else if (json && (unsigned char)c < 0x20)
+		{
+			char escape[8];
+
+			snprintf(escape, sizeof(escape), "\\u%04x", c);
+			quoted += escape;
+		}
+		else if (!json && c == '"')
+		{
+			quoted += "\"\"";
+		}
+		else
+		{
+			quoted += c;
+		}
+	}
+
+	return quoted + "\"";
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_json
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_json(const RunRecord &record)
+--						const RunRecord &record: Record of a transfer
+--
+--	RETURNS:		std::string - the record as one JSON object, without a line break.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string record_json(const RunRecord &record)
+{
+	std::string json("{");
+
+	for (const RecordField &field : record_fields(record))
+	{
+		if (json.size() > 1)
+		{
+			json += ", ";
+		}
+		json += quote(field.name, true);
+		json += ": ";
+		json += field.text ? quote(field.value, true) : field.value;
+	}
+
+	return json + "}";
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_csv_header
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_csv_header(const RunRecord &record)
+--						const RunRecord &record: Record of a transfer
+--
+--	RETURNS:		std::string - the CSV header row of records like this one, without a line break.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string record_csv_header(const RunRecord &record)
+{
+	std::string header;
+
+	for (const RecordField &field : record_fields(record))
+	{
+		if (!header.empty())
+		{
+			header += ",";
+		}
+		header += field.name;
+	}
+
+	return header;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_csv
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_csv(const RunRecord &record)
+--						const RunRecord &record: Record of a transfer
+--
+--	RETURNS:		std::string - the record as one CSV row, without a line break.
+--
+--	NOTES:
+--	Text values are quoted only if they contain a comma or a quotation mark.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string record_csv(const RunRecord &record)
+{
+	std::string row;
+	bool first = true;
+
+	for (const RecordField &field : record_fields(record))
+	{
+		if (!first)
+		{
+			row += ",";
+		}
+		first = false;
+		row += (field.value.find_first_of(",\"\n") != std::string::npos) ? quote(field.value, false) : field.value;
+	}
+
+	return row;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_history
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_history(const std::string &path, const RunRecord &record)
+--						const std::string &path: History file
+--						const RunRecord &record: Record of a transfer
+--
+--	RETURNS:		bool - true if the record was appended.
+--
+--	NOTES:
+--	Appends the JSON line of the record. The line is written with a single write in O_APPEND mode, so the runs of
+--	concurrent processes are not interleaved within a line.
+----------------------------------------------------------------------------------------------------------------------*/
+bool append_history(const std::string &path, const RunRecord &record)
+{
+	std::string line = record_json(record) + "\n";
+	int file_fd;
+	bool written;
+
+	if ((file_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)) == -1)
+	{
+		perror("Cannot open history file");
+		return false;
+	}
+	if (!(written = (write(file_fd, line.data(), line.size()) == (ssize_t)line.size())))
+	{
+		perror("Cannot write history file");
+	}
+	close(file_fd);
+
+	return written;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_json_line
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_json_line(const std::string &line, HistoryRun &run)
+--						const std::string &line: One line of the history file
+--						HistoryRun &run: Set to the fields of the line
+--
+--	RETURNS:		bool - true if the line is a flat JSON object.
+--
+--	NOTES:
+--	Reads the flat objects written by record_json: string keys with string, number or literal values. Nested
+--	objects and arrays are rejected. Escapes other than \" \\ and \uXXXX below 0x80 are kept as they are.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool parse_json_line(const std::string &line, HistoryRun &run)
+{
+	size_t pos = 0;
+
+	auto skip_space = [&]()
+	{
+		while (pos < line.size() && isspace((unsigned char)line[pos]))
+			pos++;
+	};
+	auto parse_string = [&](std::string &text) -> bool
+	{
+		if (pos >= line.size() || line[pos] != '"')
+			return false;
+		for (pos++; pos < line.size() && line[pos] != '"'; pos++)
+		{
+			if (line[pos] == '\\' && pos + 1 < line.size())
+			{
+				pos++;
+				if (line[pos] == 'u' && pos + 4 < line.size())
+				{
+					long code = strtol(line.substr(pos + 1, 4).c_str(), NULL, 16);
+					text += (code < 0x80) ? (char)code : '?';
+					pos += 4;
+					continue;
+				}
+			}
+			text += line[pos];
+		}
+		return pos++ < line.size();
+	};
+
+	run.clear();
+	skip_space();
+	if (pos >= line.size() || line[pos++] != '{')
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		std::string name;
+		std::string value;
+
+		skip_space();
+		if (pos < line.size() && line[pos] == '}' && run.empty())
+		{
+			return true;
+		}
+		if (!parse_string(name))
+		{
+			return false;
+		}
+		skip_space();
+		if (pos >= line.size() || line[pos++] != ':')
+		{
+			return false;
+		}
+		skip_space();
+		if (pos < line.size() && line[pos] == '"')
+		{
+			if (!parse_string(value))
+				return false;
+		}
+		else
+		{
+			while (pos < line.size() && line[pos] != ',' && line[pos] != '}' && !isspace((unsigned char)line[pos]))
+			{
+				if (line[pos] == '{' || line[pos] == '[')
+					return false;
+				value += line[pos++];
+			}
+			if (value.empty())
+				return false;
+		}
+		run[name] = value;
+
+		skip_space();
+		if (pos < line.size() && line[pos] == ',')
+		{
+			pos++;
+			continue;
+		}
+		return pos < line.size() && line[pos] == '}';
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		read_history
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		read_history(const std::string &path, std::vector<HistoryRun> &runs)
+--						const std::string &path: History file
+--						std::vector<HistoryRun> &runs: Set to the runs of the file, oldest first
+--
+--	RETURNS:		bool - true if the file could be read.
+--
+--	NOTES:
+--	Lines that are not flat JSON objects are skipped with a warning.
+----------------------------------------------------------------------------------------------------------------------*/
+bool read_history(const std::string &path, std::vector<HistoryRun> &runs)
+{
+	std::string line;
+	FILE *file;
+	int c;
+	int line_number = 0;
+
+	if ((file = fopen(path.c_str(), "r")) == NULL)
+	{
+		perror("Cannot open history file");
+		return false;
+	}
+
+	runs.clear();
+	do
+	{
+		c = fgetc(file);
+		if (c != '\n' && c != EOF)
+		{
+			line += (char)c;
+			continue;
+		}
+
+		line_number++;
+		if (line.find_first_not_of(" \t\r") != std::string::npos)
+		{
+			HistoryRun run;
+
+			if (parse_json_line(line, run))
+				runs.push_back(run);
+			else
+				fprintf(stderr, "%s:%d is not a run record, skipped\n", path.c_str(), line_number);
+		}
+		line.clear();
+	} while (c != EOF);
+
+	fclose(file);
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		parse_number
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		parse_number(const std::string &text, double &value)
+--						const std::string &text: Value of a field
+--						double &value: Set to the number
+--
+--	RETURNS:		bool - true if the whole text is a number.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool parse_number(const std::string &text, double &value)
+{
+	char *end;
+
+	value = strtod(text.c_str(), &end);
+	return !text.empty() && *end == '\0';
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		query_history
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Keep the run number out of --fields]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		query_history(int argc, char *argv[])
+--						int argc: Number of arguments after the mode
+--						char *argv[]: history_file [name=value ...] [--fields a,b,c] [--last N]
+--
+--	RETURNS:		int - 0 on success, 1 on a usage or file error.
+--
+--	NOTES:
+--	Prints a table of the runs whose fields match every name=value filter, numbered by their position in the file
+--	(the numbers compare takes). --fields selects the columns after the run number and --last keeps only the latest N
+--	matching runs.
+----------------------------------------------------------------------------------------------------------------------*/
+int query_history(int argc, char *argv[])
+{
+	std::vector<std::string> columns = { "time", "mode", "protocol", "packet_size", "num_packets", "streams",
+		"client_throughput_mbps", "server_throughput_mbps", "server_loss_percent" };
+	std::vector<std::pair<std::string, std::string>> filters;
+	std::vector<HistoryRun> runs;
+	std::vector<size_t> matches;
+	std::vector<size_t> widths;
+	size_t last = 0;
+
+	if (argc < 1)
+	{
+		fprintf(stderr, "Missing history file\n");
+		return 1;
+	}
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		size_t equals = arg.find('=');
+
+		if (arg == "--fields" && i + 1 < argc)
+		{
+			std::string list = argv[++i];
+			size_t start = 0;
+
+			columns.clear();
+			while (start <= list.size())
+			{
+				size_t comma = list.find(',', start);
+				if (comma == std::string::npos)
+					comma = list.size();
+				// The Run Number is Always the First Column
+				if (comma > start && list.compare(start, comma - start, "run") != 0)
+					columns.push_back(list.substr(start, comma - start));
+				start = comma + 1;
+			}
+		}
+		else if (arg == "--last" && i + 1 < argc)
+		{
+			last = (size_t)atoi(argv[++i]);
+		}
+		else if (equals != std::string::npos && equals > 0)
+		{
+			filters.push_back({ arg.substr(0, equals), arg.substr(equals + 1) });
+		}
+		else
+		{
+			fprintf(stderr, "Unknown history argument %s\n", arg.c_str());
+			return 1;
+		}
+	}
+
+	if (!read_history(argv[0], runs))
+	{
+		return 1;
+	}
+
+	// Select the Runs
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		bool match = true;
+
+		for (const auto &filter : filters)
+		{
+			auto field = runs[i].find(filter.first);
+			if (field == runs[i].end() || field->second != filter.second)
+			{
+				match = false;
+				break;
+			}
+		}
+		if (match)
+		{
+			matches.push_back(i);
+		}
+	}
+	if (last > 0 && matches.size() > last)
+	{
+		matches.erase(matches.begin(), matches.end() - last);
+	}
+
+	// Size the Columns to their Widest Value
+	widths.push_back(std::max((size_t)3, std::to_string(runs.size()).size()));
+	for (const std::string &column : columns)
+	{
+		size_t width = column.size();
+
+		for (size_t i : matches)
+		{
+			auto field = runs[i].find(column);
+			if (field != runs[i].end())
+				width = std::max(width, field->second.size());
+		}
+		widths.push_back(width);
+	}
+
+	printf("%-*s", (int)widths[0], "run");
+	for (size_t c = 0; c < columns.size(); c++)
+	{
+		printf("  %-*s", (int)widths[c + 1], columns[c].c_str());
+	}
+	printf("\n");
+	for (size_t i : matches)
+	{
+		printf("%-*zu", (int)widths[0], i + 1);
+		for (size_t c = 0; c < columns.size(); c++)
+		{
+			auto field = runs[i].find(columns[c]);
+			printf("  %-*s", (int)widths[c + 1], (field != runs[i].end()) ? field->second.c_str() : "-");
+		}
+		printf("\n");
+	}
+	printf("\n%zu of %zu runs\n", matches.size(), runs.size());
+
+	return 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		compare_history
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Compare the last two runs of the same mode by default]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		compare_history(int argc, char *argv[])
+--						int argc: Number of arguments after the mode
+--						char *argv[]: history_file [run_a] [run_b]
+--
+--	RETURNS:		int - 0 on success, 1 on a usage or file error.
+--
+--	NOTES:
+--	Compares two runs of a history file, numbered as the history mode lists them; negative numbers count back from
+--	the latest run. Without run numbers the latest run is compared with the run of the same mode before it, so a
+--	Server record is not compared with a Client record. Every number is printed with its change from run_a to run_b
+--	(numbers that are 0 in both are left out), and text fields only when they differ.
+----------------------------------------------------------------------------------------------------------------------*/
+int compare_history(int argc, char *argv[])
+{
+	std::vector<HistoryRun> runs;
+	std::vector<std::string> names;
+	long long numbers[2] = { -2, -1 };
+
+	if (argc < 1 || argc > 3)
+	{
+		fprintf(stderr, "Usage: compare history_file [run_a] [run_b]\n");
+		return 1;
+	}
+	if (!read_history(argv[0], runs))
+	{
+		return 1;
+	}
+
+	// Default to the Latest Run and the Run of the same Mode before it
+	if (argc == 1 && !runs.empty())
+	{
+		auto mode = runs.back().find("mode");
+
+		numbers[0] = 0;
+		for (size_t i = runs.size() - 1; i-- > 0 && mode != runs.back().end();)
+		{
+			auto other = runs[i].find("mode");
+			if (other != runs[i].end() && other->second == mode->second)
+			{
+				numbers[0] = (long long)i + 1;
+				break;
+			}
+		}
+	}
+
+	// Resolve the Run Numbers
+	for (int i = 0; i < 2; i++)
+	{
+		if (argc > i + 1)
+			numbers[i] = atoll(argv[i + 1]);
+		if (numbers[i] < 0)
+			numbers[i] += (long long)runs.size() + 1;
+		if (numbers[i] < 1 || numbers[i] > (long long)runs.size())
+		{
+			fprintf(stderr, "%s has no run %s\n", argv[0], (argc > i + 1) ? argv[i + 1] : "to compare");
+			return 1;
+		}
+	}
+
+	const HistoryRun &run_a = runs[numbers[0] - 1];
+	const HistoryRun &run_b = runs[numbers[1] - 1];
+
+	// Fields of either Run, by Name
+	for (const auto &field : run_a)
+	{
+		names.push_back(field.first);
+	}
+	for (const auto &field : run_b)
+	{
+		if (run_a.find(field.first) == run_a.end())
+			names.push_back(field.first);
+	}
+
+	printf("%-26s %18s %18s %10s\n", "field", ("run " + std::to_string(numbers[0])).c_str(),
+		("run " + std::to_string(numbers[1])).c_str(), "change");
+	for (const std::string &name : names)
+	{
+		auto field_a = run_a.find(name);
+		auto field_b = run_b.find(name);
+		std::string value_a = (field_a != run_a.end()) ? field_a->second : "-";
+		std::string value_b = (field_b != run_b.end()) ? field_b->second : "-";
+		double number_a, number_b;
+
+		if (parse_number(value_a, number_a) && parse_number(value_b, number_b))
+		{
+			char change[BUFFERSIZE] = "";
+
+			if (number_a == 0 && number_b == 0)
+				continue;
+			if (number_a != 0)
+				snprintf(change, sizeof(change), "%+.1f%%", 100.0 * (number_b - number_a) / fabs(number_a));
+			else if (number_b != 0)
+				snprintf(change, sizeof(change), "new");
+			printf("%-26s %18s %18s %10s\n", name.c_str(), value_a.c_str(), value_b.c_str(), change);
+		}
+		else if (value_a != value_b)
+		{
+			printf("%-26s %18s %18s\n", name.c_str(), value_a.c_str(), value_b.c_str());
+		}
+	}
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "transport.h"
+#include <map>
+#include <time.h>
+
+// One Named Value of a Run Record (text values are quoted in JSON)
+struct RecordField
+{
+	std::string name;
+	std::string value;
+	bool text;
+};
+
+// CPU Time Used by the Process (user and system)
+struct CpuSample
+{
+	double user_ms = 0;
+	double sys_ms = 0;
+};
+
+// Everything Known about one Transfer: what was run, with which options, and what each side measured
+struct RunRecord
+{
+	long long timestamp = (long long)time(NULL);
+	std::string mode;
+	Protocol protocol = TCP_PROTOCOL;
+	std::string host;
+	int port = PORT;
+	int packet_size = 0;
+	int num_packets = 0;
+	int repetition = 0;
+	TransferOptions options;
+	bool has_client = false;
+	bool has_server = false;
+	TransferResult client;
+	TransferResult server;
+	CpuSample cpu;
+};
+
+// A Run Loaded from the History File, by Field Name
+typedef std::map<std::string, std::string> HistoryRun;
+
+CpuSample cpu_sample();
+CpuSample cpu_since(const CpuSample &start);
+std::vector<RecordField> record_fields(const RunRecord &record);
+std::string record_json(const RunRecord &record);
+std::string record_csv_header(const RunRecord &record);
+std::string record_csv(const RunRecord &record);
+bool append_history(const std::string &path, const RunRecord &record);
+bool read_history(const std::string &path, std::vector<HistoryRun> &runs);
+int query_history(int argc, char *argv[]);
+int compare_history(int argc, char *argv[]);
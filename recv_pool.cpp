@@ -0,0 +1,400 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	recv_pool.cpp - A pool of reusable, page aligned receive buffers
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					RecvBufferPool(size_t size, int num_buffers, bool use_hugepages)
+--					~RecvBufferPool()
+--					char *acquire()
+--					void release(char *buf)
+--					RecvPoolStats stats()
+--					double touched_per_received(const RecvPoolStats &begin, const RecvPoolStats &end)
+--					void report(TransferResult &result, const RecvPoolStats &begin)
+--					void append_report(std::string &print_output, const RecvPoolStats &begin)
+--					void recv_pool_init(bool use_hugepages)
+--					RecvBufferPool &recv_pool()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The receive paths used to put a 1 MB buffer on the stack for every read event, and the TCP receiver cleared the
+--	whole buffer after every read. The pool allocates page aligned buffers once (backed by huge pages when requested
+--	and available), prefaults them, and hands them out to the receive paths, which never clear them between reads.
+--
+--	The pool also keeps count of the bytes the receivers write: the bytes received from the network into its buffers,
+--	and the bytes the Server copies or clears again in user space after that (the staging copies of the mmap and
+--	O_DIRECT DiskSinks and their padding, the frame headers split between two reads). Their ratio, bytes touched per
+--	byte received, is reported with each transfer and is 1.00 when the receiver only writes the data it receives; the
+--	copy a buffered write makes in the kernel is not counted.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "recv_pool.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		RecvBufferPool
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		RecvBufferPool(size_t size, int num_buffers, bool use_hugepages)
+--						size_t size: Usable size of every buffer in Bytes
+--						int num_buffers: Number of buffers allocated up front
+--						bool use_hugepages: Back the buffers with huge pages if possible
+--
+--	NOTES:
+--	Allocates the initial buffers. The mapped size of each buffer is rounded up to a whole number of pages (or huge
+--	pages), so buffers are always page aligned.
+----------------------------------------------------------------------------------------------------------------------*/
+RecvBufferPool::RecvBufferPool(size_t size, int num_buffers, bool use_hugepages)
+	: size(size), hugepages(use_hugepages), bytes_received(0), bytes_copied(0)
+{
+	size_t page = hugepages ? HUGEPAGE_SIZE : PAGE_SIZE_BYTES;
+
+	mapped_size = (size + page - 1) / page * page;
+
+	for (int i = 0; i < num_buffers; i++)
+	{
+		char *buf = allocate();
+		if (buf != NULL)
+		{
+			free_buffers.push_back(buf);
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		~RecvBufferPool
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		~RecvBufferPool()
+--
+--	NOTES:
+--	Frees every buffer the pool allocated, including buffers that were never released.
+----------------------------------------------------------------------------------------------------------------------*/
+RecvBufferPool::~RecvBufferPool()
+{
+	for (char *buf : all_buffers)
+	{
+#ifdef _WIN32
+		VirtualFree(buf, 0, MEM_RELEASE);
+#else
+		munmap(buf, mapped_size);
+#endif
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		allocate
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		allocate()
+--
+--	RETURNS:		char * - a new page aligned buffer, or NULL if the allocation failed.
+--
+--	NOTES:
+--	Maps a new buffer and prefaults it so that the first transfer does not pay for page faults. When huge pages were
+--	requested, explicit huge pages (MAP_HUGETLB) are tried first, then transparent huge pages. If neither is
+--	available the pool falls back to normal pages and hugepage_backed() reports false.
+----------------------------------------------------------------------------------------------------------------------*/
+char *RecvBufferPool::allocate()
+{
+	char *buf = NULL;
+
+#ifdef _WIN32
+	buf = (char *)VirtualAlloc(NULL, mapped_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	hugepages = false;
+#else
+	void *mapping = MAP_FAILED;
+
+	if (hugepages)
+	{
+		mapping = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+		if (mapping == MAP_FAILED)
+		{
+			mapping = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mapping != MAP_FAILED && madvise(mapping, mapped_size, MADV_HUGEPAGE) == -1)
+			{
+				hugepages = false;
+			}
+			for (size_t offset = 0; mapping != MAP_FAILED && offset < mapped_size; offset += PAGE_SIZE_BYTES)
+			{
+				// Prefault (MAP_POPULATE would fault in small pages before the advice applies)
+				((volatile char *)mapping)[offset] = 0;
+			}
+		}
+	}
+	else
+	{
+		mapping = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	}
+
+	if (mapping == MAP_FAILED)
+	{
+		perror("mmap() failed");
+		return NULL;
+	}
+	buf = (char *)mapping;
+#endif
+
+	if (buf != NULL)
+	{
+		all_buffers.push_back(buf);
+	}
+
+	return buf;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		acquire
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		acquire()
+--
+--	RETURNS:		char * - a buffer of buffer_size() Bytes, or NULL if the pool is empty and cannot grow.
+--
+--	NOTES:
+--	Takes a buffer from the pool. The contents are whatever the previous user left in it. The pool grows if more
+--	receivers are active at once than there are buffers.
+----------------------------------------------------------------------------------------------------------------------*/
+char *RecvBufferPool::acquire()
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	if (free_buffers.empty())
+	{
+		return allocate();
+	}
+
+	char *buf = free_buffers.back();
+	free_buffers.pop_back();
+	return buf;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		release
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		release(char *buf)
+--						char *buf: A buffer returned by acquire()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Returns a buffer to the pool without clearing it.
+----------------------------------------------------------------------------------------------------------------------*/
+void RecvBufferPool::release(char *buf)
+{
+	if (buf == NULL)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	free_buffers.push_back(buf);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		stats
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		stats()
+--
+--	RETURNS:		RecvPoolStats - a snapshot of the pool counters.
+--
+--	NOTES:
+--	The counters are shared by every receiver, so a transfer takes a snapshot when it starts and another when it
+--	ends, and passes both to touched_per_received.
+----------------------------------------------------------------------------------------------------------------------*/
+RecvPoolStats RecvBufferPool::stats() const
+{
+	RecvPoolStats snapshot;
+
+	snapshot.bytes_received = bytes_received;
+	snapshot.bytes_copied = bytes_copied;
+	return snapshot;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		touched_per_received
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Count the copies the receivers make]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		touched_per_received(const RecvPoolStats &begin, const RecvPoolStats &end)
+--						const RecvPoolStats &begin: Snapshot taken when the transfer started
+--						const RecvPoolStats &end: Snapshot taken when the transfer ended
+--
+--	RETURNS:		double - bytes written by the receiver per byte received, or 0 if nothing was received.
+--
+--	NOTES:
+--	1.00 means the receiver wrote nothing but the received data; every copy of it adds 1.00 more.
+----------------------------------------------------------------------------------------------------------------------*/
+double RecvBufferPool::touched_per_received(const RecvPoolStats &begin, const RecvPoolStats &end)
+{
+	long long received = end.bytes_received - begin.bytes_received;
+	long long copied = end.bytes_copied - begin.bytes_copied;
+
+	return (received > 0) ? (double)(received + copied) / received : 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result, const RecvPoolStats &begin)
+--						TransferResult &result: Receives the buffer statistics
+--						const RecvPoolStats &begin: Snapshot taken when the transfer started
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Copies the bytes touched per byte received since the snapshot into the result of a transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void RecvBufferPool::report(TransferResult &result, const RecvPoolStats &begin) const
+{
+	result.touched_per_byte = touched_per_received(begin, stats());
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output, const RecvPoolStats &begin)
+--						std::string &print_output: Output string the statistics are appended to
+--						const RecvPoolStats &begin: Snapshot taken when the transfer started
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the bytes touched per byte received since the snapshot, and whether the buffers are huge pages.
+----------------------------------------------------------------------------------------------------------------------*/
+void RecvBufferPool::append_report(std::string &print_output, const RecvPoolStats &begin) const
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nBytes Touched per Byte Received: %.2f%s",
+		touched_per_received(begin, stats()), hugepages ? " (huge pages)" : "");
+	print_output += line;
+}
+
+// Shared Pool Configuration
+static bool pool_hugepages = false;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		recv_pool_init
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		recv_pool_init(bool use_hugepages)
+--						bool use_hugepages: Back the shared pool with huge pages if possible
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Configures the shared pool. Must be called before the first call to recv_pool() to have any effect.
+----------------------------------------------------------------------------------------------------------------------*/
+void recv_pool_init(bool use_hugepages)
+{
+	pool_hugepages = use_hugepages;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		recv_pool
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		recv_pool()
+--
+--	RETURNS:		RecvBufferPool & - the pool shared by every receive path.
+--
+--	NOTES:
+--	The pool is created on first use with RECV_POOL_BUFFERS buffers of RECVBUFSIZE Bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+RecvBufferPool &recv_pool()
+{
+	static RecvBufferPool pool(RECVBUFSIZE, RECV_POOL_BUFFERS, pool_hugepages);
+
+	return pool;
+}
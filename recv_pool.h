@@ -0,0 +1,47 @@
+#pragma once
+
+#include "transport.h"
+#include <atomic>
+#include <mutex>
+
+#define RECV_POOL_BUFFERS 4
+#define PAGE_SIZE_BYTES 4096
+#define HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+// Receive Buffer Accounting
+struct RecvPoolStats
+{
+	long long bytes_received = 0;
+	long long bytes_copied = 0;
+};
+
+class RecvBufferPool
+{
+	public:
+		RecvBufferPool(size_t size, int num_buffers, bool use_hugepages);
+		~RecvBufferPool();
+		char *acquire();
+		void release(char *buf);
+		size_t buffer_size() const { return size; };
+		bool hugepage_backed() const { return hugepages; };
+		void record_received(long long bytes) { bytes_received += bytes; };
+		void record_copied(long long bytes) { bytes_copied += bytes; };
+		RecvPoolStats stats() const;
+		static double touched_per_received(const RecvPoolStats &begin, const RecvPoolStats &end);
+		void report(TransferResult &result, const RecvPoolStats &begin) const;
+		void append_report(std::string &print_output, const RecvPoolStats &begin) const;
+	private:
+		char *allocate();
+		size_t size;
+		size_t mapped_size;
+		bool hugepages;
+		std::mutex lock;
+		std::vector<char *> free_buffers;
+		std::vector<char *> all_buffers;
+		std::atomic<long long> bytes_received;
+		std::atomic<long long> bytes_copied;
+};
+
+// Shared Receive Buffer Pool (recv_pool.cpp)
+void recv_pool_init(bool use_hugepages);
+RecvBufferPool &recv_pool();
@@ -0,0 +1,725 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	rudp.cpp - Reliable UDP: sequence numbers, selective acknowledgements and retransmission
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void rudp_header(RudpHeader &header, int type, uint32_t session, uint32_t seq, uint32_t total)
+--					bool rudp_parse(const char *datagram, ssize_t len, RudpHeader &header)
+--					bool rudp_send(SOCKET sock, Payload &payload, int packet_size, int num_packet, int window,
+--						RudpSendStats &stats)
+--					void start(uint32_t session, uint32_t total)
+--					bool record(uint32_t seq)
+--					size_t build_ack(RudpAck &ack)
+--					void append_report(std::string &print_output)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The reliable UDP mode (--reliable) puts a RudpHeader in front of every datagram. The Client sends DATA datagrams
+--	numbered from 0, each carrying one packet of the Payload, with up to window datagrams in flight beyond the
+--	oldest unacknowledged one. The Server answers with ACK datagrams carrying the next sequence number it expects
+--	(cumulative) and a bitmap of the RUDP_SACK_BITS datagrams after it that have already arrived (selective). The
+--	Server decides when to acknowledge: every RUDP_ACK_EVERY new datagrams, on every datagram that arrives out of
+--	order or twice, and whenever its socket has been drained.
+--
+--	A datagram is retransmitted when a datagram sent after it has been acknowledged, allowing a quarter of the
+--	smoothed round trip time for reordering, or when its retransmission timeout expires. The timeout follows the
+--	round trip time as in TCP (smoothed RTT plus four times its variation, sampled only from datagrams sent once)
+--	and doubles on every expiry. The bitmap covers RUDP_MAX_WINDOW datagrams, so every datagram in flight can be
+--	acknowledged selectively. Once every datagram is acknowledged the Client sends FIN until the Server answers
+--	with FIN_ACK, which ends the transfer on both sides without relying on an EOT marker in the data.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "rudp.h"
+
+#ifndef _WIN32
+
+#include "payload.h"
+#include "timing.h"
+#include <endian.h>
+#include <sys/uio.h>
+
+// Send State of one Datagram
+struct RudpSlot
+{
+	uint64_t sent_ns = 0;
+	int sends = 0;
+	bool acked = false;
+};
+
+// Send State of a Reliable Transfer
+struct RudpSender
+{
+	SOCKET sock;
+	Payload *payload;
+	int packet_size;
+	uint32_t session;
+	uint32_t total;
+	uint32_t base;
+	uint32_t next;
+	uint64_t delivered_ns;
+	uint64_t progress_ns;
+	double rttvar_us;
+	std::vector<RudpSlot> slots;
+	RudpSendStats *stats;
+};
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		rudp_header
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		rudp_header(RudpHeader &header, int type, uint32_t session, uint32_t seq, uint32_t total)
+--						RudpHeader &header: Set to the header in network byte order
+--						int type: RudpType of the datagram
+--						uint32_t session: Session of the transfer, chosen by the Client
+--						uint32_t seq: Sequence number (DATA), next expected (ACK) or datagram count (FIN)
+--						uint32_t total: Number of datagrams in the transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Builds the header of a reliable UDP datagram.
+----------------------------------------------------------------------------------------------------------------------*/
+void rudp_header(RudpHeader &header, int type, uint32_t session, uint32_t seq, uint32_t total)
+{
+	memset(&header, 0, sizeof(header));
+	header.magic = htonl(RUDP_MAGIC);
+	header.type = (uint8_t)type;
+	header.session = htonl(session);
+	header.seq = htonl(seq);
+	header.total = htonl(total);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		rudp_parse
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Reject totals above RUDP_MAX_DATAGRAMS]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		rudp_parse(const char *datagram, ssize_t len, RudpHeader &header)
+--						const char *datagram: Received datagram
+--						ssize_t len: Length of the datagram
+--						RudpHeader &header: Set to the header in host byte order
+--
+--	RETURNS:		bool - true if the datagram starts with a reliable UDP header.
+--
+--	NOTES:
+--	The header is copied out of the datagram, since the receive buffer may not be aligned for it. A header claiming
+--	more than RUDP_MAX_DATAGRAMS datagrams is rejected before the Server sizes its receive state by it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool rudp_parse(const char *datagram, ssize_t len, RudpHeader &header)
+{
+	if (len < (ssize_t)sizeof(RudpHeader))
+	{
+		return false;
+	}
+
+	memcpy(&header, datagram, sizeof(header));
+	header.magic = ntohl(header.magic);
+	header.session = ntohl(header.session);
+	header.seq = ntohl(header.seq);
+	header.total = ntohl(header.total);
+
+	// The Receiver Allocates the State of every Datagram of the Transfer
+	return header.magic == RUDP_MAGIC && header.total <= RUDP_MAX_DATAGRAMS;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_data
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Take the send time before sendmsg]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_data(RudpSender &sender, uint32_t seq)
+--						RudpSender &sender: Send state of the transfer
+--						uint32_t seq: Sequence number of the datagram
+--
+--	RETURNS:		int - 1 if the datagram was sent, 0 if the socket is full, or -1 on error.
+--
+--	NOTES:
+--	Sends one DATA datagram with sendmsg. The header and the packet are separate iovecs, so the packet is sent
+--	straight from the Payload. The send time is taken before the call, which may not return before the Server has
+--	already acknowledged the datagram.
+----------------------------------------------------------------------------------------------------------------------*/
+static int send_data(RudpSender &sender, uint32_t seq)
+{
+	RudpHeader header;
+	struct iovec iov[2];
+	struct msghdr msg;
+	ssize_t sent_bytes;
+	uint64_t send_ns;
+
+	rudp_header(header, RUDP_DATA, sender.session, seq, sender.total);
+	iov[0].iov_base = &header;
+	iov[0].iov_len = sizeof(header);
+	iov[1].iov_base = (void *)sender.payload->packet(seq);
+	iov[1].iov_len = sender.packet_size;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+
+	// Loopback can Deliver the Acknowledgement before sendmsg Returns
+	send_ns = monotonic_ns();
+	sender.stats->syscalls++;
+	if ((sent_bytes = sendmsg(sender.sock, &msg, 0)) == -1)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS || errno == ECONNREFUSED)
+		{
+			return 0;
+		}
+		perror("sendmsg() failed");
+		return -1;
+	}
+
+	sender.slots[seq].sent_ns = send_ns;
+	sender.slots[seq].sends++;
+	sender.stats->datagrams_sent++;
+	sender.stats->bytes_sent += sent_bytes;
+	if (sender.slots[seq].sends > 1)
+	{
+		sender.stats->retransmits++;
+	}
+	return 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		reset_rto
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		reset_rto(RudpSender &sender)
+--						RudpSender &sender: Send state of the transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sets the retransmission timeout from the smoothed round trip time, dropping any backoff (RFC 6298). Before the
+--	first sample the initial timeout is kept.
+----------------------------------------------------------------------------------------------------------------------*/
+static void reset_rto(RudpSender &sender)
+{
+	RudpSendStats &stats = *sender.stats;
+
+	if (stats.srtt_us == 0)
+	{
+		stats.rto_us = RUDP_RTO_INITIAL_US;
+		return;
+	}
+
+	stats.rto_us = stats.srtt_us + 4 * sender.rttvar_us;
+	if (stats.rto_us < RUDP_RTO_MIN_US)
+	{
+		stats.rto_us = RUDP_RTO_MIN_US;
+	}
+	if (stats.rto_us > RUDP_RTO_MAX_US)
+	{
+		stats.rto_us = RUDP_RTO_MAX_US;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		sample_rtt
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Set the timeout with reset_rto]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		sample_rtt(RudpSender &sender, double rtt_us)
+--						RudpSender &sender: Send state of the transfer
+--						double rtt_us: Round trip time of a datagram that was sent once
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Updates the smoothed round trip time and the retransmission timeout (RFC 6298).
+----------------------------------------------------------------------------------------------------------------------*/
+static void sample_rtt(RudpSender &sender, double rtt_us)
+{
+	RudpSendStats &stats = *sender.stats;
+
+	if (stats.srtt_us == 0)
+	{
+		stats.srtt_us = rtt_us;
+		sender.rttvar_us = rtt_us / 2;
+	}
+	else
+	{
+		sender.rttvar_us = 0.75 * sender.rttvar_us + 0.25 * ((stats.srtt_us > rtt_us) ? stats.srtt_us - rtt_us : rtt_us - stats.srtt_us);
+		stats.srtt_us = 0.875 * stats.srtt_us + 0.125 * rtt_us;
+	}
+
+	reset_rto(sender);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_acks
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Reset the backoff when retransmissions move the window]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_acks(RudpSender &sender)
+--						RudpSender &sender: Send state of the transfer
+--
+--	RETURNS:		bool - true if a FIN_ACK was received.
+--
+--	NOTES:
+--	Reads every queued acknowledgement. The cumulative part moves the window, and the bitmap marks the datagrams
+--	after it that have arrived. The latest send time of any acknowledged datagram is kept, so that datagrams sent
+--	before it can be detected as lost, and the datagram sent most recently gives the round trip time sample. When
+--	only retransmitted datagrams move the window, the backed off timeout is reset without a sample.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool receive_acks(RudpSender &sender)
+{
+	RudpAck ack;
+	RudpHeader header;
+	ssize_t len;
+	uint64_t now_ns = monotonic_ns();
+	uint64_t newest_sent = 0;
+	uint32_t old_base = sender.base;
+	bool fin_acked = false;
+
+	// Marks one Datagram as Delivered
+	auto deliver = [&](uint32_t seq)
+	{
+		RudpSlot &slot = sender.slots[seq];
+
+		if (slot.acked || slot.sends == 0)
+		{
+			return;
+		}
+		slot.acked = true;
+		sender.progress_ns = now_ns;
+		if (slot.sent_ns > sender.delivered_ns)
+		{
+			sender.delivered_ns = slot.sent_ns;
+		}
+		if (slot.sends == 1 && slot.sent_ns > newest_sent)
+		{
+			newest_sent = slot.sent_ns;
+		}
+	};
+
+	while (true)
+	{
+		sender.stats->syscalls++;
+		if ((len = recv(sender.sock, (char *)&ack, sizeof(ack), 0)) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+		if (!rudp_parse((const char *)&ack, len, header) || header.session != sender.session)
+		{
+			continue;
+		}
+		if (header.type == RUDP_FIN_ACK)
+		{
+			fin_acked = true;
+			continue;
+		}
+		if (header.type != RUDP_ACK || len < (ssize_t)sizeof(RudpAck))
+		{
+			continue;
+		}
+		sender.stats->acks++;
+
+		// Cumulative Acknowledgement
+		uint32_t cumulative = (header.seq < sender.next) ? header.seq : sender.next;
+		for (uint32_t seq = sender.base; seq < cumulative; seq++)
+		{
+			deliver(seq);
+		}
+		if (cumulative > sender.base)
+		{
+			sender.base = cumulative;
+		}
+
+		// Selective Acknowledgements
+		for (int i = 0; i < RUDP_SACK_BITS && cumulative + 1 + i < sender.next; i++)
+		{
+			if (be64toh(ack.sack[i / 64]) & (1ULL << (i % 64)))
+			{
+				deliver(cumulative + 1 + i);
+			}
+		}
+	}
+
+	// A Retransmitted Datagram gives no Sample, but its Acknowledgement Ends the Backoff
+	if (newest_sent != 0)
+	{
+		sample_rtt(sender, (now_ns - newest_sent) / 1000.0);
+	}
+	else if (sender.base > old_base)
+	{
+		reset_rto(sender);
+	}
+	return fin_acked;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		wait_for_acks
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		wait_for_acks(RudpSender &sender, uint64_t timeout_ns, bool writable)
+--						RudpSender &sender: Send state of the transfer
+--						uint64_t timeout_ns: Longest time to wait
+--						bool writable: Also wake up when the socket can send again
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Waits with ppoll, which takes the timeout in nanoseconds; retransmission timeouts on a LAN are shorter than the
+--	millisecond resolution of poll.
+----------------------------------------------------------------------------------------------------------------------*/
+static void wait_for_acks(RudpSender &sender, uint64_t timeout_ns, bool writable)
+{
+	struct pollfd fds;
+	struct timespec timeout;
+
+	fds.fd = sender.sock;
+	fds.events = POLLIN | (writable ? POLLOUT : 0);
+	fds.revents = 0;
+	timeout.tv_sec = timeout_ns / 1000000000ULL;
+	timeout.tv_nsec = timeout_ns % 1000000000ULL;
+
+	sender.stats->syscalls++;
+	ppoll(&fds, 1, &timeout, NULL);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		rudp_send
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Back off once per retransmission that was sent]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		rudp_send(SOCKET sock, Payload &payload, int packet_size, int num_packet, int window,
+--						RudpSendStats &stats)
+--						SOCKET sock: Non-blocking datagram socket connected to the Server
+--						Payload &payload: Data of the transfer
+--						int packet_size: Size of a packet in Bytes (the header is added in front)
+--						int num_packet: Number of packets to send
+--						int window: Largest number of datagrams in flight
+--						RudpSendStats &stats: Set to the statistics of the send
+--
+--	RETURNS:		bool - true if every datagram was acknowledged and the Server answered the FIN.
+--
+--	NOTES:
+--	Sends every packet reliably, then ends the transfer with FIN. Each round retransmits the datagrams found lost
+--	(oldest first), sends new datagrams while the window allows, then waits for acknowledgements until the
+--	retransmission deadline. As in TCP there is one retransmission timer, on the oldest unacknowledged datagram;
+--	every other loss is found by the acknowledgement of a datagram sent after it. The timeout doubles only when the
+--	oldest datagram is actually sent again, so a full socket buffer does not back the timer off on every pass. The
+--	send is abandoned if nothing is acknowledged for RUDP_GIVE_UP_MS.
+----------------------------------------------------------------------------------------------------------------------*/
+bool rudp_send(SOCKET sock, Payload &payload, int packet_size, int num_packet, int window, RudpSendStats &stats)
+{
+	RudpSender sender;
+	RudpHeader fin;
+	uint64_t now_ns;
+	uint64_t rto_ns;
+	uint64_t reorder_ns;
+	uint64_t deadline_ns;
+	bool blocked;
+	bool expired;
+	int status;
+
+	stats = RudpSendStats();
+	stats.rto_us = RUDP_RTO_INITIAL_US;
+	sender.sock = sock;
+	sender.payload = &payload;
+	sender.packet_size = packet_size;
+	sender.session = (uint32_t)(monotonic_ns() ^ ((uint64_t)getpid() << 16));
+	sender.total = (uint32_t)num_packet;
+	sender.base = 0;
+	sender.next = 0;
+	sender.delivered_ns = 0;
+	sender.progress_ns = monotonic_ns();
+	sender.rttvar_us = 0;
+	sender.slots.resize(num_packet);
+	sender.stats = &stats;
+
+	while (sender.base < sender.total)
+	{
+		now_ns = monotonic_ns();
+		rto_ns = (uint64_t)(stats.rto_us * 1000);
+		reorder_ns = (uint64_t)(stats.srtt_us * 250);
+		blocked = false;
+		expired = false;
+
+		if (now_ns - sender.progress_ns > RUDP_GIVE_UP_MS * 1000000ULL)
+		{
+			fprintf(stderr, "No acknowledgement for %d ms, giving up\n", RUDP_GIVE_UP_MS);
+			return false;
+		}
+
+		// The Retransmission Timer Runs on the Oldest Unacknowledged Datagram
+		expired = sender.base < sender.next && now_ns >= sender.slots[sender.base].sent_ns + rto_ns;
+
+		// Retransmit the Lost Datagrams, Oldest First
+		for (uint32_t seq = sender.base; seq < sender.next && !blocked; seq++)
+		{
+			RudpSlot &slot = sender.slots[seq];
+
+			if (slot.acked || (sender.delivered_ns <= slot.sent_ns + reorder_ns && !(expired && seq == sender.base)))
+			{
+				continue;
+			}
+			if ((status = send_data(sender, seq)) == -1)
+			{
+				return false;
+			}
+			blocked = (status == 0);
+
+			// Back off once per Retransmission of the Oldest Datagram (a blocked send leaves the timer expired)
+			if (status == 1 && expired && seq == sender.base)
+			{
+				stats.timeouts++;
+				stats.rto_us = (stats.rto_us * 2 > RUDP_RTO_MAX_US) ? RUDP_RTO_MAX_US : stats.rto_us * 2;
+			}
+		}
+
+		// Send New Datagrams while the Window Allows
+		while (!blocked && sender.next < sender.total && sender.next - sender.base < (uint32_t)window)
+		{
+			if ((status = send_data(sender, sender.next)) == -1)
+			{
+				return false;
+			}
+			blocked = (status == 0);
+			sender.next += status;
+		}
+
+		// Wait for Acknowledgements until the Retransmission Deadline
+		deadline_ns = sender.slots[sender.base].sent_ns + (uint64_t)(stats.rto_us * 1000);
+		now_ns = monotonic_ns();
+		wait_for_acks(sender, (deadline_ns > now_ns) ? deadline_ns - now_ns : 0, blocked);
+		receive_acks(sender);
+	}
+
+	// End the Transfer
+	rudp_header(fin, RUDP_FIN, sender.session, sender.total, sender.total);
+	for (int attempt = 0; attempt < RUDP_FIN_RETRIES && !stats.fin_acked; attempt++)
+	{
+		stats.syscalls++;
+		send(sock, (const char *)&fin, sizeof(fin), 0);
+		wait_for_acks(sender, (uint64_t)(stats.rto_us * 1000) << attempt, false);
+		stats.fin_acked = receive_acks(sender);
+	}
+
+	return stats.fin_acked;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(uint32_t session, uint32_t total)
+--						uint32_t session: Session of the transfer, chosen by the Client
+--						uint32_t total: Number of datagrams in the transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Resets the receiver for a new session.
+----------------------------------------------------------------------------------------------------------------------*/
+void RudpReceiver::start(uint32_t session, uint32_t total_datagrams)
+{
+	session_id = session;
+	total = total_datagrams;
+	next_expected = 0;
+	highest = 0;
+	unacked = 0;
+	ack_now = false;
+	duplicates = 0;
+	acks_sent = 0;
+	received.assign(total, false);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record(uint32_t seq)
+--						uint32_t seq: Sequence number of a received DATA datagram
+--
+--	RETURNS:		bool - true if the datagram had not been received before.
+--
+--	NOTES:
+--	Records a DATA datagram and decides whether the Server should acknowledge right away: after RUDP_ACK_EVERY new
+--	datagrams, when a datagram is received twice (its acknowledgement was lost), when there is a gap in the
+--	sequence (the Client needs the bitmap to repair it), and when the last datagram completes the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+bool RudpReceiver::record(uint32_t seq)
+{
+	if (seq >= total)
+	{
+		return false;
+	}
+	if (received[seq])
+	{
+		duplicates++;
+		ack_now = true;
+		return false;
+	}
+
+	received[seq] = true;
+	unacked++;
+	if (seq > highest)
+	{
+		highest = seq;
+	}
+	while (next_expected < total && received[next_expected])
+	{
+		next_expected++;
+	}
+
+	if (unacked >= RUDP_ACK_EVERY || highest >= next_expected || complete())
+	{
+		ack_now = true;
+	}
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		build_ack
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		build_ack(RudpAck &ack)
+--						RudpAck &ack: Set to the acknowledgement
+--
+--	RETURNS:		size_t - the size of the acknowledgement in Bytes.
+--
+--	NOTES:
+--	Builds an ACK with the next expected sequence number and the bitmap of the datagrams after it.
+----------------------------------------------------------------------------------------------------------------------*/
+size_t RudpReceiver::build_ack(RudpAck &ack)
+{
+	uint64_t words[RUDP_SACK_WORDS] = { 0 };
+
+	for (int i = 0; i < RUDP_SACK_BITS && next_expected + 1 + i <= highest; i++)
+	{
+		if (received[next_expected + 1 + i])
+		{
+			words[i / 64] |= 1ULL << (i % 64);
+		}
+	}
+
+	rudp_header(ack.header, RUDP_ACK, session_id, next_expected, total);
+	for (int i = 0; i < RUDP_SACK_WORDS; i++)
+	{
+		ack.sack[i] = htobe64(words[i]);
+	}
+
+	unacked = 0;
+	ack_now = false;
+	acks_sent++;
+	return sizeof(ack);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the statistics are appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the receiver side statistics of the reliable session.
+----------------------------------------------------------------------------------------------------------------------*/
+void RudpReceiver::append_report(std::string &print_output) const
+{
+	print_output += "\nReliable UDP: ";
+	print_output += std::to_string(next_expected);
+	print_output += " of ";
+	print_output += std::to_string(total);
+	print_output += " Datagrams";
+	print_output += "\nDuplicate Datagrams: ";
+	print_output += std::to_string(duplicates);
+	print_output += "\nACKs Sent: ";
+	print_output += std::to_string(acks_sent);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+#define RUDP_MAGIC 0x52554450
+#define RUDP_SACK_WORDS (RUDP_MAX_WINDOW / 64)
+#define RUDP_SACK_BITS (RUDP_SACK_WORDS * 64)
+#define RUDP_ACK_EVERY 16
+#define RUDP_RTO_INITIAL_US 50000
+#define RUDP_RTO_MIN_US 1000
+#define RUDP_RTO_MAX_US 1000000
+#define RUDP_FIN_RETRIES 10
+#define RUDP_GIVE_UP_MS 5000
+#define RUDP_MAX_DATAGRAMS (1 << 28)
+
+class Payload;
+
+// Datagram Types of the Reliable UDP Protocol
+enum RudpType
+{
+	RUDP_DATA = 1,
+	RUDP_ACK = 2,
+	RUDP_FIN = 3,
+	RUDP_FIN_ACK = 4
+};
+
+// Header in Front of every Reliable UDP Datagram (sent in network byte order)
+struct RudpHeader
+{
+	uint32_t magic;
+	uint8_t type;
+	uint8_t reserved[3];
+	uint32_t session;
+	uint32_t seq;
+	uint32_t total;
+};
+
+// Selective Acknowledgement (bit i set: datagram seq + 1 + i was received)
+struct RudpAck
+{
+	RudpHeader header;
+	uint64_t sack[RUDP_SACK_WORDS];
+};
+
+// Statistics of a Reliable Send
+struct RudpSendStats
+{
+	long long bytes_sent = 0;
+	long long datagrams_sent = 0;
+	long long retransmits = 0;
+	long long timeouts = 0;
+	long long acks = 0;
+	long long syscalls = 0;
+	double srtt_us = 0;
+	double rto_us = 0;
+	bool fin_acked = false;
+};
+
+void rudp_header(RudpHeader &header, int type, uint32_t session, uint32_t seq, uint32_t total);
+bool rudp_parse(const char *datagram, ssize_t len, RudpHeader &header);
+
+#ifndef _WIN32
+bool rudp_send(SOCKET sock, Payload &payload, int packet_size, int num_packet, int window, RudpSendStats &stats);
+#endif
+
+// Receive State of one Reliable UDP Session (Server side)
+class RudpReceiver
+{
+	public:
+		RudpReceiver() {};
+		~RudpReceiver() {};
+		void start(uint32_t session, uint32_t total);
+		bool record(uint32_t seq);
+		uint32_t session() const { return session_id; };
+		bool complete() const { return next_expected >= total; };
+		bool ack_due() const { return ack_now; };
+		bool ack_pending() const { return ack_now || unacked > 0; };
+		size_t build_ack(RudpAck &ack);
+		void append_report(std::string &print_output) const;
+	private:
+		uint32_t session_id = 0;
+		uint32_t total = 0;
+		uint32_t next_expected = 0;
+		uint32_t highest = 0;
+		int unacked = 0;
+		bool ack_now = false;
+		long long duplicates = 0;
+		long long acks_sent = 0;
+		std::vector<bool> received;
+};
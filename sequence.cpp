@@ -0,0 +1,412 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	sequence.cpp - Sequence stamps of UDP datagrams, and the loss, reordering, duplication and jitter
+--								they reveal on the Server
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void sequence_stamp(SequenceStamp &stamp, uint32_t seq, uint32_t total, uint64_t send_ns)
+--					bool sequence_parse(const char *datagram, ssize_t len, uint32_t &seq, uint32_t &total,
+--						uint64_t &send_ns)
+--					void start()
+--					void record(uint32_t seq, uint32_t total, uint64_t send_ns, uint64_t recv_ns)
+--					void merge(const SequenceStats &other)
+--					void report(TransferResult &result)
+--					void append_report(std::string &print_output)
+--					void build_report(SequenceReport &report)
+--					bool sequence_parse_report(const char *datagram, ssize_t len, uint32_t &received,
+--						uint32_t &expected)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	With --stamp, the UDP Client overwrites the first Bytes of every datagram with a SequenceStamp: its sequence
+--	number, the number of datagrams in the transfer and the time it was sent. The datagram keeps its size, so the
+--	throughput is comparable with an unstamped transfer. The Server recognises the stamp by its magic number and
+--	counts the datagrams that never arrived (lost), arrived after a later one (reordered, with the depth being how
+--	many sequence numbers later), or arrived more than once (duplicated).
+--
+--	The jitter is the interarrival jitter of RFC 3550: the smoothed (gain 1/16) difference between the transit times
+--	of consecutive datagrams. The two hosts' clocks only need to run at the same rate, since their offset cancels
+--	out of the difference.
+--
+--	At the end of a stamped transfer the Server sends a SequenceReport (datagrams received and expected) back to
+--	the Client, so the Client learns the loss of its transfer without reading the Server's output. The rate search
+--	of the paced Client (--ramp) is driven by these reports.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "sequence.h"
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		sequence_stamp
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		sequence_stamp(SequenceStamp &stamp, uint32_t seq, uint32_t total, uint64_t send_ns)
+--						SequenceStamp &stamp: Set to the stamp in network byte order
+--						uint32_t seq: Sequence number of the datagram, from 0
+--						uint32_t total: Number of datagrams in the transfer
+--						uint64_t send_ns: Send time of the datagram on the Client's monotonic clock
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Builds the stamp of one datagram.
+----------------------------------------------------------------------------------------------------------------------*/
+void sequence_stamp(SequenceStamp &stamp, uint32_t seq, uint32_t total, uint64_t send_ns)
+{
+	stamp.magic = htonl(SEQUENCE_MAGIC);
+	stamp.seq = htonl(seq);
+	stamp.total = htonl(total);
+	stamp.send_ns_high = htonl((uint32_t)(send_ns >> 32));
+	stamp.send_ns_low = htonl((uint32_t)send_ns);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		sequence_parse
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		sequence_parse(const char *datagram, ssize_t len, uint32_t &seq, uint32_t &total,
+--						uint64_t &send_ns)
+--						const char *datagram: Received datagram
+--						ssize_t len: Length of the datagram
+--						uint32_t &seq: Set to the sequence number
+--						uint32_t &total: Set to the number of datagrams in the transfer
+--						uint64_t &send_ns: Set to the send time
+--
+--	RETURNS:		bool - true if the datagram starts with a sequence stamp.
+--
+--	NOTES:
+--	The stamp is copied out of the datagram, since the receive buffer may not be aligned for it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool sequence_parse(const char *datagram, ssize_t len, uint32_t &seq, uint32_t &total, uint64_t &send_ns)
+{
+	SequenceStamp stamp;
+
+	if (len < (ssize_t)sizeof(SequenceStamp))
+	{
+		return false;
+	}
+
+	memcpy(&stamp, datagram, sizeof(stamp));
+	if (ntohl(stamp.magic) != SEQUENCE_MAGIC)
+	{
+		return false;
+	}
+
+	seq = ntohl(stamp.seq);
+	total = ntohl(stamp.total);
+	send_ns = ((uint64_t)ntohl(stamp.send_ns_high) << 32) | ntohl(stamp.send_ns_low);
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Clears the statistics at the start of a transfer. The statistics stay inactive until a stamped datagram is
+--	recorded, so an unstamped transfer reports nothing.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::start()
+{
+	*this = SequenceStats();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record(uint32_t seq, uint32_t total, uint64_t send_ns, uint64_t recv_ns)
+--						uint32_t seq: Sequence number of the datagram
+--						uint32_t total: Number of datagrams in the transfer
+--						uint64_t send_ns: Send time of the datagram on the Client's clock
+--						uint64_t recv_ns: Arrival time of the datagram on the Server's clock
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Records one stamped datagram in arrival order. A duplicate is only counted, so it neither moves the highest
+--	sequence number nor feeds the jitter. Stamps with a sequence number outside the transfer are ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::record(uint32_t seq, uint32_t total, uint64_t send_ns, uint64_t recv_ns)
+{
+	int64_t transit = (int64_t)(recv_ns - send_ns);
+
+	if (total == 0 || total > SEQUENCE_MAX_DATAGRAMS || seq >= total)
+	{
+		return;
+	}
+
+	if (total > expected)
+	{
+		expected = total;
+		received.resize(total, false);
+	}
+
+	if (received[seq])
+	{
+		duplicates++;
+		return;
+	}
+	received[seq] = true;
+
+	// Arrived after a Later Datagram
+	if (unique > 0 && seq < highest)
+	{
+		reordered++;
+		if ((long long)(highest - seq) > reorder_depth)
+		{
+			reorder_depth = highest - seq;
+		}
+	}
+	if (unique == 0 || seq > highest)
+	{
+		highest = seq;
+	}
+	unique++;
+
+	// RFC 3550 Interarrival Jitter
+	if (has_transit)
+	{
+		int64_t difference = transit - last_transit;
+
+		jitter_ns += ((double)((difference < 0) ? -difference : difference) - jitter_ns) / 16.0;
+		jitter_samples++;
+	}
+	last_transit = transit;
+	has_transit = true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		merge
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Merge the sources of one socket]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		merge(const SequenceStats &other)
+--						const SequenceStats &other: Statistics recorded by another socket or source during the same transfer
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Used by the SO_REUSEPORT Server, where every socket records its own datagrams, and by the Server that records
+--	every source on its own. A datagram received by both is a duplicate. The reordering is only seen within a part,
+--	and the jitter is the average of the parts' jitter weighted by their number of samples.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::merge(const SequenceStats &other)
+{
+	if (!other.active())
+	{
+		return;
+	}
+	if (!active())
+	{
+		*this = other;
+		return;
+	}
+
+	if (other.expected > expected)
+	{
+		expected = other.expected;
+		received.resize(expected, false);
+	}
+
+	for (uint32_t seq = 0; seq < other.expected; seq++)
+	{
+		if (!other.received[seq])
+		{
+			continue;
+		}
+		if (received[seq])
+		{
+			duplicates++;
+			continue;
+		}
+		received[seq] = true;
+		unique++;
+	}
+
+	if (jitter_samples + other.jitter_samples > 0)
+	{
+		jitter_ns = (jitter_ns * jitter_samples + other.jitter_ns * other.jitter_samples)
+			/ (double)(jitter_samples + other.jitter_samples);
+	}
+	jitter_samples += other.jitter_samples;
+	duplicates += other.duplicates;
+	reordered += other.reordered;
+	if (other.reorder_depth > reorder_depth)
+	{
+		reorder_depth = other.reorder_depth;
+	}
+	if (other.highest > highest)
+	{
+		highest = other.highest;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Set to the loss, reordering, duplication and jitter
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::report(TransferResult &result) const
+{
+	result.datagrams_lost = (long long)expected - unique;
+	result.datagrams_reordered = reordered;
+	result.datagrams_duplicated = duplicates;
+	result.loss_rate = (expected > 0) ? (double)result.datagrams_lost / expected : 0;
+	result.jitter_us = jitter_ns / 1000.0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the statistics are appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the loss, reordering, duplication and jitter of the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::append_report(std::string &print_output) const
+{
+	char line[128];
+	long long lost = (long long)expected - unique;
+
+	snprintf(line, sizeof(line), "\nSequenced Datagrams: %lld of %u (%lld lost, %.3f%% loss)",
+		unique, expected, lost, (expected > 0) ? 100.0 * lost / expected : 0);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nReordered Datagrams: %lld (max depth %lld)", reordered, reorder_depth);
+	print_output += line;
+	print_output += "\nDuplicate Datagrams: ";
+	print_output += std::to_string(duplicates);
+	snprintf(line, sizeof(line), "\nJitter (RFC 3550): %.1f us", jitter_ns / 1000.0);
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		build_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		build_report(SequenceReport &report)
+--						SequenceReport &report: Set to the loss report in network byte order
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void SequenceStats::build_report(SequenceReport &report) const
+{
+	report.magic = htonl(SEQUENCE_REPORT_MAGIC);
+	report.received = htonl((uint32_t)unique);
+	report.expected = htonl(expected);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		sequence_parse_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		sequence_parse_report(const char *datagram, ssize_t len, uint32_t &received, uint32_t &expected)
+--						const char *datagram: Received datagram
+--						ssize_t len: Length of the datagram
+--						uint32_t &received: Set to the number of datagrams the Server received
+--						uint32_t &expected: Set to the number of datagrams in the transfer
+--
+--	RETURNS:		bool - true if the datagram is a loss report.
+----------------------------------------------------------------------------------------------------------------------*/
+bool sequence_parse_report(const char *datagram, ssize_t len, uint32_t &received, uint32_t &expected)
+{
+	SequenceReport report;
+
+	if (len < (ssize_t)sizeof(SequenceReport))
+	{
+		return false;
+	}
+
+	memcpy(&report, datagram, sizeof(report));
+	if (ntohl(report.magic) != SEQUENCE_REPORT_MAGIC)
+	{
+		return false;
+	}
+
+	received = ntohl(report.received);
+	expected = ntohl(report.expected);
+
+	return true;
+}
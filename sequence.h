@@ -0,0 +1,57 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+#define SEQUENCE_MAGIC 0x53455131
+#define SEQUENCE_REPORT_MAGIC 0x53455152
+#define SEQUENCE_MAX_DATAGRAMS (1 << 28)
+
+// Stamp at the Start of a Sequenced Datagram (sent in network byte order)
+struct SequenceStamp
+{
+	uint32_t magic;
+	uint32_t seq;
+	uint32_t total;
+	uint32_t send_ns_high;
+	uint32_t send_ns_low;
+};
+
+// Loss Report the Server Sends back at the End of a Stamped Transfer (sent in network byte order)
+struct SequenceReport
+{
+	uint32_t magic;
+	uint32_t received;
+	uint32_t expected;
+};
+
+void sequence_stamp(SequenceStamp &stamp, uint32_t seq, uint32_t total, uint64_t send_ns);
+bool sequence_parse(const char *datagram, ssize_t len, uint32_t &seq, uint32_t &total, uint64_t &send_ns);
+bool sequence_parse_report(const char *datagram, ssize_t len, uint32_t &received, uint32_t &expected);
+
+// Loss, Reordering, Duplication and Jitter of the Sequenced Datagrams of a Transfer (Server side)
+class SequenceStats
+{
+	public:
+		SequenceStats() {};
+		~SequenceStats() {};
+		void start();
+		void record(uint32_t seq, uint32_t total, uint64_t send_ns, uint64_t recv_ns);
+		void merge(const SequenceStats &other);
+		bool active() const { return expected > 0; };
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output) const;
+		void build_report(SequenceReport &report) const;
+	private:
+		uint32_t expected = 0;
+		uint32_t highest = 0;
+		long long unique = 0;
+		long long duplicates = 0;
+		long long reordered = 0;
+		long long reorder_depth = 0;
+		long long jitter_samples = 0;
+		bool has_transit = false;
+		int64_t last_transit = 0;
+		double jitter_ns = 0;
+		std::vector<bool> received;
+};
@@ -26,9 +26,14 @@
 ----------------------------------------------------------------------------------------------------------------------*/
 
 #include "tcp.h"
+#include "timing.h"
+#include "recv_pool.h"
+#include "payload.h"
+#include "trace.h"
+#include <map>
 
-// Global Connection Socket
-SOCKET tcp_sock;
+// Transfer Timer of every Accepted Connection (the Server serves several Clients at once)
+static std::map<SOCKET, TransferTimer> recv_timers;
 
 /*----------------------------------------------------------------------------------------------------------------------
 --	FUNCTION:		start_server
@@ -103,7 +108,8 @@ void TCP::start_server(int port, HWND hwnd)
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Start the monotonic transfer timer]
+--					October 16, 2026 [Keep the other connections open, one timer per connection]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -118,20 +124,22 @@ void TCP::start_server(int port, HWND hwnd)
 --	NOTES:
 --	Accepts a connection from a client in TCP. This function is called by WndProc when the WM_SOCKET's FD_ACCEPT event
 --	is triggered. Once the FD_ACCEPT event is triggered a new SOCKET is created where the communication of data will
---	be taking place.
+--	be taking place. Connections that are already open are kept, each with its own transfer timer.
 ----------------------------------------------------------------------------------------------------------------------*/
 void TCP::accept_connection(WPARAM wParam, HWND hwnd)
 {
-	// Close Old Socket Connections before Accepting
-	closesocket(tcp_sock);
+	SOCKET sock;
 
-	if ((tcp_sock = accept(wParam, NULL, NULL)) == INVALID_SOCKET)
+	if ((sock = accept(wParam, NULL, NULL)) == INVALID_SOCKET)
 	{
 		printf("accept() failed with error %d\n", WSAGetLastError());
 		return;
 	}
 
-	WSAAsyncSelect(tcp_sock, hwnd, WM_SOCKET, FD_READ | FD_WRITE | FD_CLOSE);
+	// Start Timer
+	recv_timers[sock].start();
+
+	WSAAsyncSelect(sock, hwnd, WM_SOCKET, FD_READ | FD_WRITE | FD_CLOSE);
 }
 
 /*----------------------------------------------------------------------------------------------------------------------
@@ -139,7 +147,9 @@ void TCP::accept_connection(WPARAM wParam, HWND hwnd)
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Record TransferResult]
+--					October 16, 2026 [Send read-only views of a prepared Payload]
+--					October 16, 2026 [Reuse one event and wait for each overlapped send to complete]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -160,22 +170,31 @@ void TCP::accept_connection(WPARAM wParam, HWND hwnd)
 ----------------------------------------------------------------------------------------------------------------------*/
 std::string TCP::send_packet(char *host, int port, int packet_size, int num_packet)
 {
-	INT result;
+	INT wsa_result;
 	DWORD sent_bytes;
+	DWORD flags;
 	DWORD total_bytes = 0;
 	struct	hostent	*hp;
 	struct	sockaddr_in server;
 	WSAOVERLAPPED overlapped;
 	SOCKET connection;
 	WSABUF data_buf;
-	char *packet_buf;
+	Payload payload;
 	WSADATA wsaData;
 	std::string print_output;
 
+	result = TransferResult();
+
+	// Generate the Data before Connecting
+	if (!payload.prepare(options, packet_size, num_packet, false))
+	{
+		return "Error payload";
+	}
+
 	// Open up a Winsock Session
-	if ((result = WSAStartup(0x0202, &wsaData)) != 0)
+	if ((wsa_result = WSAStartup(0x0202, &wsaData)) != 0)
 	{
-		perror("WSAStartup failed with error %d\n" + result);
+		perror("WSAStartup failed with error %d\n" + wsa_result);
 		WSACleanup();
 		return "Error WSAStartup()";
 	}
@@ -210,37 +229,39 @@ std::string TCP::send_packet(char *host, int port, int packet_size, int num_pack
 		return "Error connect()";
 	}
 
-	// Allocate Single Packet Buffer
-	packet_buf = (char *)malloc(packet_size * sizeof(char));
-
-	// Create WSA Event for Asynchronous I/O
+	// Create WSA Event for Asynchronous I/O, Reused by every Send
+	memset(&overlapped, 0, sizeof(overlapped));
 	if ((overlapped.hEvent = WSACreateEvent()) == WSA_INVALID_EVENT) {
 		perror("WSACreateEvent failed");
 		WSACleanup();
 		return "Error WSACreateEvent()";
 	}
 
-	// Create and Send Packets
+	// Send Packets
 	for (int i = 0; i < num_packet; i++) {
-		int k = 0;
-		for (int j = 0; j < packet_size; j++) {
-			// Insert characters from A-Z
-			k = (j < 26) ? j : j % 26;
-			packet_buf[j] = 'A' + k;
-		}
-
-		data_buf.buf = packet_buf;
+		data_buf.buf = (char *)payload.packet(i);
 		data_buf.len = packet_size;
 
-		// Send and wait for event
-		WSASend(connection, &data_buf, 1, &sent_bytes, 0, &overlapped, NULL);
+		// Send and wait for the send to complete
+		if (WSASend(connection, &data_buf, 1, &sent_bytes, 0, &overlapped, NULL) == SOCKET_ERROR)
+		{
+			if (WSAGetLastError() != WSA_IO_PENDING
+				|| !WSAGetOverlappedResult(connection, &overlapped, &sent_bytes, TRUE, &flags))
+			{
+				perror("WSASend() failed");
+				break;
+			}
+		}
 		total_bytes += sent_bytes;
-		WaitForSingleObject(&overlapped.hEvent, 1000);
-
-		// Create New Event
-		overlapped.hEvent = WSACreateEvent();
+		WSAResetEvent(overlapped.hEvent);
 	}
 
+	WSACloseEvent(overlapped.hEvent);
+
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = num_packet;
+
 	// Append Data Information to print_output
 	print_output += "[TCP CLIENT]";
 	print_output += "\nHost: ";
@@ -252,6 +273,8 @@ std::string TCP::send_packet(char *host, int port, int packet_size, int num_pack
 	print_output += " Bytes";
 	print_output += "\nNumber of Packets: ";
 	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
 	print_output += "\nTotal Data Transferred: ";
 	print_output += std::to_string(total_bytes);
 	print_output += " Bytes";
@@ -269,7 +292,12 @@ std::string TCP::send_packet(char *host, int port, int packet_size, int num_pack
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Record TransferResult]
+--					October 16, 2026 [Monotonic TransferTimer instead of GetSystemTime]
+--					October 16, 2026 [Reuse pooled receive buffers without clearing them]
+--					October 16, 2026 [Receive on the socket of the event, keep the other connections]
+--					October 16, 2026 [Trace the reads instead of OutputDebugString]
+--					October 17, 2026 [Acquire the receive buffer after the connection lookup]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -288,26 +316,37 @@ std::string TCP::send_packet(char *host, int port, int packet_size, int num_pack
 ----------------------------------------------------------------------------------------------------------------------*/
 void TCP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 {
-	char packet_buf[RECVBUFSIZE];
+	SOCKET sock = (SOCKET)wParam;
+	std::map<SOCKET, TransferTimer>::iterator connection = recv_timers.find(sock);
+	RecvBufferPool &pool = recv_pool();
+	RecvPoolStats pool_start = pool.stats();
 	WSABUF data_buf;
-	data_buf.len = RECVBUFSIZE;
-	data_buf.buf = packet_buf;
 	DWORD received_bytes = 0;
 	DWORD flags = 0;
+	TraceRing &trace = trace_ring();
 	DWORD total_bytes = 0;
+	long long reads = 0;
 	int timeout = 0;
-	SYSTEMTIME sys_time;
 	std::string print_output;
 
-	// Start Timer
-	GetSystemTime(&sys_time);
-	WORD start_millis = (sys_time.wSecond * 1000) + sys_time.wMilliseconds;
+	if (connection == recv_timers.end())
+	{
+		return;
+	}
+	TransferTimer &recv_timer = connection->second;
+
+	data_buf.len = (ULONG)pool.buffer_size();
+	if ((data_buf.buf = pool.acquire()) == NULL)
+	{
+		return;
+	}
 
 	// Receive Data from Socket
 	do 
 	{
 		received_bytes = 0;
-		if (WSARecv(tcp_sock, &data_buf, 1, &received_bytes, &flags, NULL, NULL) == SOCKET_ERROR) {
+		if (WSARecv(sock, &data_buf, 1, &received_bytes, &flags, NULL, NULL) == SOCKET_ERROR) {
+			trace.record(TRACE_RECV, (uint32_t)reads, data_buf.len, -1, WSAGetLastError());
 			if (WSAGetLastError() != WSAEWOULDBLOCK) 
 			{
 				break;
@@ -315,50 +354,50 @@ void TCP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 		}
 		else 
 		{
-			OutputDebugString("Received Bytes: ");
-			OutputDebugString(std::to_string(received_bytes).c_str());
-			OutputDebugString("\n");
-			OutputDebugString("Total Bytes: ");
-			OutputDebugString(std::to_string(total_bytes).c_str());
-			OutputDebugString("\n");
+			trace.record(TRACE_RECV, (uint32_t)reads, data_buf.len, (int32_t)received_bytes, 0);
 			if (received_bytes == 0) {
 				// Timeout after 5 Loops
 				if (timeout < 5) {
 					timeout++;
 					continue;
 				}
-				OutputDebugString("TIMEOUT");
 				break;
 			}
 			timeout = 0;
+			recv_timer.record_chunk(received_bytes);
 			total_bytes += received_bytes;
-			memset(data_buf.buf, 0, RECVBUFSIZE);
+			reads++;
+			pool.record_received(received_bytes);
 		}
 	} while (true);
 
+	pool.release(data_buf.buf);
+
 	if (total_bytes == 0)
 	{
 		return;
 	}
 
-	// Stop Timer
-	GetSystemTime(&sys_time);
-	DWORD end_millis = (sys_time.wSecond * 1000) + sys_time.wMilliseconds;
+	// Record Server Statistics
+	result.total_bytes = total_bytes;
+	result.packets = reads;
+	recv_timer.report(result);
+	pool.report(result, pool_start);
 
 	// Append Received Data Statistics to print_output
 	print_output += "[TCP SERVER]";
-	print_output += "\nTotal Transfer Time: ";
-	print_output += std::to_string(end_millis - start_millis);
-	print_output += " ms";
+	recv_timer.append_report(print_output);
 	print_output += "\nTotal Data Transferred: ";
 	print_output += std::to_string(total_bytes);
 	print_output += " Bytes";
+	pool.append_report(print_output, pool_start);
 
 	// Wait for server to finish
 	SleepEx(100, FALSE);
 
 	// Close connection
-	closesocket(tcp_sock);
+	closesocket(sock);
+	recv_timers.erase(connection);
 
 	print_string = print_output;
 }
@@ -368,7 +407,7 @@ void TCP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Close every connection]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -385,5 +424,9 @@ void TCP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 ----------------------------------------------------------------------------------------------------------------------*/
 void TCP::end_connection()
 {
-	closesocket(tcp_sock);
+	for (std::pair<const SOCKET, TransferTimer> &connection : recv_timers)
+	{
+		closesocket(connection.first);
+	}
+	recv_timers.clear();
 }
@@ -1,15 +1,34 @@
 #pragma once
 
 #include "transport.h"
+#ifndef _WIN32
+#include "event_loop.h"
+#endif
 
 class TCP
 {
 	public:
 		TCP() {};
 		~TCP() {};
+#ifdef _WIN32
 		void start_server(int port, HWND hwnd);
 		void accept_connection(WPARAM wParam, HWND hwnd);
-		std::string send_packet(char *host, int port, int packet_size, int num_packet);
 		void receive_packet(int port, WPARAM wParam, std::string &print_string);
+#else
+		void start_server(int port, EventLoop &loop);
+		void accept_connection(SOCKET listen_sock, EventLoop &loop);
+		void receive_packet(int port, SOCKET sock, std::string &print_string);
+		std::string measure_latency(char *host, int port, int packet_size, int num_request);
+#endif
+		std::string send_packet(char *host, int port, int packet_size, int num_packet);
 		void end_connection();
+		const TransferResult &get_result() const { return result; };
+		void set_options(const TransferOptions &transfer_options) { options = transfer_options; };
+	private:
+#ifndef _WIN32
+		std::string send_file(char *host, int port);
+		std::string send_streams(char *host, int port, int packet_size, int num_packet);
+#endif
+		TransferResult result;
+		TransferOptions options;
 };
\ No newline at end of file
@@ -0,0 +1,1953 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	tcp_posix.cpp - TCP Protocol operations for POSIX systems. Operations for both Client and Server
+--								side are included in this source file
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void start_server(int port, EventLoop &loop)
+--					void accept_connection(SOCKET listen_sock, EventLoop &loop)
+--					std::string send_packet(char *host, int port, int packet_size, int num_packet)
+--					std::string send_file(char *host, int port)
+--					std::string send_streams(char *host, int port, int packet_size, int num_packet)
+--					std::string measure_latency(char *host, int port, int packet_size, int num_request)
+--					void receive_packet(int port, SOCKET sock, std::string &print_string)
+--					void end_connection()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The POSIX backend of the TCP class. It has the same operations as tcp.cpp, but is built on non-blocking BSD
+--	sockets and the epoll EventLoop instead of WinSock and the window message pump. The server registers its sockets
+--	with the EventLoop, and receive_packet drains the connection every time it becomes readable until the client
+--	closes the connection, at which point the transfer statistics are reported.
+--
+--	With the send_file option (--sendfile) the Client streams a file to the Server with sendfile (or splice) instead
+--	of sending generated packets. With the save_file option (--save) the Server writes every transfer to a file
+--	through a DiskSink and reports the disk write throughput next to the network throughput.
+--
+--	With a queue depth (--uring), the Client sends and the Server receives through an io_uring ring instead of one
+--	send or recv call at a time (see uring.cpp). Both sides report the number of system calls the transfer took.
+--
+--	With a stream count (--streams), the Client stripes the packets across that many connections, each sent by a
+--	coroutine, all driven by one thread (see coro.cpp). The Server keeps the receive state of every connection:
+--	connections that overlap in time, whether the streams of one Client or several Clients, are one transfer, which
+--	ends when the last of them is closed. The Server reports the aggregate and the per-connection throughput. A
+--	transfer of several connections is not saved with --save: the Server cannot tell where the data of each connection
+--	belongs in the file, so it discards the file when the second connection arrives.
+--
+--	The Server receives on several event loops (--loops, one per core by default). The main EventLoop accepts the
+--	connections and hands them to the loops in turn, each loop running on its own core with its own io_uring ring.
+--	A closed connection is passed back to the main thread, which adds it to the transfer.
+--
+--	With --frame every packet travels behind a FrameHeader. The Client gathers the header and the packet with one
+--	sendmsg and the Server parses the frames of every bulk read in place, so neither side copies a packet to frame
+--	it. With --verify the headers carry the CRC32C of their packet, which the Server checks as it reads the packet.
+--
+--	With --echo the Server sends everything it reads back on the same connection, for the tcp-latency mode of the
+--	Client (measure_latency), which times every request/response round trip (see latency.cpp).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "tcp.h"
+#include "timing.h"
+#include "recv_pool.h"
+#include "payload.h"
+#include "disk_sink.h"
+#include "uring.h"
+#include "loop_shards.h"
+#include "latency.h"
+#include "pacing.h"
+#include "trace.h"
+#include "tuning.h"
+#include "zerocopy.h"
+#include "coro.h"
+#include "frame.h"
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Bytes Moved per splice Call (the default pipe capacity)
+#define SPLICE_CHUNK 65536
+
+// Streams or Connections Listed one per Line in a Report
+#define STREAM_REPORT_LINES 16
+
+// Global Listening Socket
+static SOCKET listen_socket = INVALID_SOCKET;
+
+// Receive State of one Connection (a client, or a stream of a striped transfer)
+struct RecvStream
+{
+	SOCKET sock = INVALID_SOCKET;
+	int id = 0;
+	int shard = 0;
+	std::string peer;
+	long long total_bytes = 0;
+	long long reads = 0;
+	long long syscalls = 0;
+	TransferTimer timer;
+	FrameReader frames;
+};
+
+// Event Loop of the Server and the Connections it Receives (the main EventLoop is shard 0)
+struct RecvShard
+{
+	EventLoop *loop = NULL;
+	IoUring ring;
+	std::vector<char *> ring_buffers;
+	std::vector<char *> slots;
+	std::mutex lock;
+	std::map<SOCKET, RecvStream *> streams;
+};
+
+// Receive State of the Transfer in Progress (main thread)
+static bool receiving = false;
+static long long recv_total_bytes = 0;
+static long long recv_reads = 0;
+static TransferTimer recv_timer;
+static RecvPoolStats recv_pool_start;
+static long long recv_syscalls = 0;
+static std::vector<std::unique_ptr<RecvStream>> recv_streams;
+static int recv_open_streams = 0;
+static size_t recv_next_shard = 0;
+static bool recv_echo = false;
+static bool recv_frame = false;
+static FrameReader recv_frames;
+static SocketSettings recv_settings;
+
+// Every Connection of the Transfer is Saved to one DiskSink
+static DiskSink recv_sink;
+static std::mutex recv_sink_lock;
+
+// Event Loops of the Server, the Additional Loops Run on their own Cores
+static std::vector<std::unique_ptr<RecvShard>> recv_shards;
+static LoopShards recv_loops;
+
+// Connections Closed by their Event Loop, Waiting for the Main Thread
+static std::mutex closed_lock;
+static std::vector<RecvStream *> closed_streams;
+static int closed_notify = -1;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_all
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Count system calls]
+--					October 16, 2026 [Trace every send]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_all(SOCKET sock, const char *buf, int len, long long &total_bytes, long long &calls)
+--						SOCKET sock: Non-blocking connection socket
+--						const char *buf: Data to send
+--						int len: Number of bytes to send
+--						long long &total_bytes: Running total of bytes sent
+--						long long &calls: Running total of send calls
+--
+--	RETURNS:		bool - true if every byte was sent.
+--
+--	NOTES:
+--	Sends the whole buffer on a non-blocking stream socket, waiting for the socket to become writable whenever the
+--	send buffer is full.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool send_all(SOCKET sock, const char *buf, int len, long long &total_bytes, long long &calls)
+{
+	ssize_t sent_bytes;
+	int offset = 0;
+
+	while (offset < len)
+	{
+		calls++;
+		sent_bytes = send(sock, buf + offset, len - offset, MSG_NOSIGNAL);
+		trace_ring().record(TRACE_SEND, (uint32_t)calls, len - offset, (int32_t)sent_bytes,
+			(sent_bytes == -1) ? errno : 0);
+		if (sent_bytes == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(sock, POLLOUT, SEND_TIMEOUT))
+			{
+				continue;
+			}
+			return false;
+		}
+		offset += sent_bytes;
+		total_bytes += sent_bytes;
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start_transfer
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Reset the streams]
+--					October 16, 2026 [Assign connections to the event loops from the first]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start_transfer(const TransferOptions &options)
+--						const TransferOptions &options: Options of the Server
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Resets the receive state and starts the timer for a new transfer. With the save_file option the DiskSink is
+--	opened so the transfer is written to disk as it arrives.
+----------------------------------------------------------------------------------------------------------------------*/
+static void start_transfer(const TransferOptions &options)
+{
+	receiving = true;
+	recv_total_bytes = 0;
+	recv_reads = 0;
+	recv_syscalls = 0;
+	recv_streams.clear();
+	recv_open_streams = 0;
+	recv_next_shard = 0;
+	recv_frames = FrameReader();
+	recv_timer.start();
+	recv_pool_start = recv_pool().stats();
+
+	if (!options.save_file.empty())
+	{
+		recv_sink.open(options.save_file, options.sink);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		deliver_data
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Save only transfers of one connection]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		deliver_data(RecvStream &stream, const char *data, ssize_t len)
+--						RecvStream &stream: Connection the data was read from
+--						const char *data: Data of the connection
+--						ssize_t len: Number of bytes
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Echoes the data with --echo and writes it to the DiskSink if one is open. Only the DiskSink is locked. The DiskSink
+--	is only open while the transfer has one connection (see accept_connection).
+----------------------------------------------------------------------------------------------------------------------*/
+static void deliver_data(RecvStream &stream, const char *data, ssize_t len)
+{
+	// Send the Data back to the Client
+	if (recv_echo)
+	{
+		long long echoed = 0;
+
+		if (!send_all(stream.sock, data, (int)len, echoed, stream.syscalls))
+		{
+			perror("send() failed");
+		}
+	}
+
+	// Save Data to Disk
+	if (recv_sink.is_open())
+	{
+		std::lock_guard<std::mutex> guard(recv_sink_lock);
+		recv_sink.write(data, len);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_read
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Record into the connection only, the main thread adds it to the transfer]
+--					October 16, 2026 [Echo the data with --echo]
+--					October 17, 2026 [Deliver the data with deliver_data, framed reads through their FrameReader]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_read(RecvStream &stream, const char *data, ssize_t received_bytes)
+--						RecvStream &stream: Connection the data was read from
+--						const char *data: Data returned by one read (NULL for a framed read)
+--						ssize_t received_bytes: Number of bytes read
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Records one read of a connection and delivers its data (see deliver_data). Called on the thread of the
+--	connection's event loop. A framed read has no data of its own: its FrameReader delivers the packet data between
+--	the headers.
+----------------------------------------------------------------------------------------------------------------------*/
+static void record_read(RecvStream &stream, const char *data, ssize_t received_bytes)
+{
+	stream.timer.record_chunk(received_bytes);
+	stream.total_bytes += received_bytes;
+	stream.reads++;
+	recv_pool().record_received(received_bytes);
+
+	if (data != NULL)
+	{
+		deliver_data(stream, data, received_bytes);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_stream
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Trace every recv]
+--					October 17, 2026 [Read frames in bulk and parse them in place with --frame]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_stream(RecvShard &shard, SOCKET sock)
+--						RecvShard &shard: Event loop the connection was assigned to
+--						SOCKET sock: The connection socket passed by the EventLoop
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Reads until the connection has no more data, on the thread of the connection's event loop. The data is read
+--	into a buffer from the shared receive pool, or into the registered slots of the loop's own io_uring ring. With
+--	--frame the FrameReader of the connection parses the frames of every read in place (see frame.cpp). Once
+--	the Client closes the connection the socket is closed and the connection is handed to the main thread through
+--	closed_streams, which adds it to the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+static void receive_stream(RecvShard &shard, SOCKET sock)
+{
+	RecvBufferPool &pool = recv_pool();
+	TraceRing &trace = trace_ring();
+	RecvStream *stream;
+	char *packet_buf;
+	ssize_t received_bytes;
+	uint64_t notify = 1;
+
+	// Find the Connection of the Socket
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		std::map<SOCKET, RecvStream *>::iterator found = shard.streams.find(sock);
+
+		if (found == shard.streams.end())
+		{
+			return;
+		}
+		stream = found->second;
+	}
+
+	// Receive Data through io_uring
+	if (shard.ring.is_ready())
+	{
+		long long enters = shard.ring.enter_calls();
+		int status;
+
+		if (shard.ring.registered_file() != sock)
+		{
+			shard.ring.register_file(sock);
+		}
+		status = uring_receive(shard.ring, shard.slots, URING_SLOT_SIZE,
+			[stream](const char *data, ssize_t len, int)
+			{
+				record_read(*stream, recv_frame ? NULL : data, len);
+				if (recv_frame)
+					stream->frames.consume(len, data, [stream](const char *packet, size_t packet_len)
+						{ deliver_data(*stream, packet, packet_len); });
+				return true;
+			});
+
+		stream->syscalls += shard.ring.enter_calls() - enters;
+		if (status == 1)
+		{
+			// Wait for the next EVENT_READ
+			return;
+		}
+	}
+	else
+	{
+		if ((packet_buf = pool.acquire()) == NULL)
+		{
+			return;
+		}
+
+		// Receive Data from Socket (Frames are Parsed where they Land in the Buffer)
+		do
+		{
+			stream->syscalls++;
+			received_bytes = recv(sock, packet_buf, pool.buffer_size(), 0);
+			trace.record(TRACE_RECV, (uint32_t)stream->syscalls, (uint32_t)pool.buffer_size(), (int32_t)received_bytes,
+				(received_bytes == -1) ? errno : 0);
+			if (received_bytes == -1)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					// Wait for the next EVENT_READ
+					pool.release(packet_buf);
+					return;
+				}
+				perror("recv() failed");
+				break;
+			}
+			if (received_bytes == 0)
+			{
+				// Client closed the connection
+				break;
+			}
+			if (recv_frame)
+			{
+				record_read(*stream, NULL, received_bytes);
+				stream->frames.consume(received_bytes, packet_buf,
+					[stream](const char *data, size_t len) { deliver_data(*stream, data, len); });
+			}
+			else
+			{
+				record_read(*stream, packet_buf, received_bytes);
+			}
+		} while (true);
+
+		pool.release(packet_buf);
+	}
+
+	// Close Connection (leaves the loop before the next accept can reuse its descriptor)
+	if (shard.ring.registered_file() == sock)
+	{
+		shard.ring.unregister_file();
+	}
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.streams.erase(sock);
+	}
+	closesocket(sock);
+
+	// Hand the Connection to the Main Thread
+	{
+		std::lock_guard<std::mutex> guard(closed_lock);
+		stream->sock = INVALID_SOCKET;
+		closed_streams.push_back(stream);
+	}
+	if (write(closed_notify, &notify, sizeof(notify)) == -1)
+	{
+		perror("write() failed");
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_stream_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Label the line, the Server reports connections]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_stream_report(std::string &print_output, const std::string &label, long long bytes,
+--										double elapsed_ms)
+--						std::string &print_output: Output string the statistics are appended to
+--						const std::string &label: Name of the stream or connection
+--						long long bytes: Bytes carried by the stream
+--						double elapsed_ms: Time the stream took
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the statistics of one stream of a striped transfer (Client) or of one connection (Server).
+----------------------------------------------------------------------------------------------------------------------*/
+static void append_stream_report(std::string &print_output, const std::string &label, long long bytes,
+	double elapsed_ms)
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), ": %lld Bytes in %.3f ms (%.2f Mbit/s)", bytes, elapsed_ms,
+		(elapsed_ms > 0) ? bytes * 8.0 / (elapsed_ms * 1000.0) : 0);
+	print_output += "\n";
+	print_output += label;
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		connect_to_server
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		connect_to_server(char *host, int port, const SocketTuning &tuning, std::string &error_string)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						const SocketTuning &tuning: Socket options applied before connecting
+--						std::string &error_string: Set to the error output if the connection fails
+--
+--	RETURNS:		SOCKET - the connected non-blocking socket, or INVALID_SOCKET.
+--
+--	NOTES:
+--	Connects to the TCP server with a non-blocking connect, waiting up to CONNECT_TIMEOUT ms for the connection to
+--	be established.
+----------------------------------------------------------------------------------------------------------------------*/
+static SOCKET connect_to_server(char *host, int port, const SocketTuning &tuning, std::string &error_string)
+{
+	struct sockaddr_in server;
+	SOCKET connection;
+
+	// Create Non-Blocking Stream Socket
+	if ((connection = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
+	{
+		perror("Cannot create socket");
+		error_string = "Error socket()";
+		return INVALID_SOCKET;
+	}
+	set_nonblocking(connection);
+	apply_tuning(connection, tuning, true);
+
+	// Resolve Host
+	memset(&server, 0, sizeof(struct sockaddr_in));
+	if (!resolve_host(host, port, server))
+	{
+		perror("Unknown server address");
+		closesocket(connection);
+		error_string = "Error getaddrinfo()";
+		return INVALID_SOCKET;
+	}
+
+	// Connecting to the server
+	if (connect(connection, (struct sockaddr *)&server, sizeof(server)) == -1)
+	{
+		int error = errno;
+		socklen_t error_len = sizeof(error);
+
+		if (error == EINPROGRESS && wait_for_socket(connection, POLLOUT, CONNECT_TIMEOUT))
+		{
+			getsockopt(connection, SOL_SOCKET, SO_ERROR, &error, &error_len);
+		}
+
+		if (error != 0)
+		{
+			errno = error;
+			perror("Can't connect to server");
+			closesocket(connection);
+			error_string = "Error connect()";
+			return INVALID_SOCKET;
+		}
+	}
+
+	return connection;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		splice_file
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		splice_file(SOCKET sock, int file_fd, long long &total_bytes, long long &calls)
+--						SOCKET sock: Non-blocking connection socket
+--						int file_fd: File to send, positioned where sending starts
+--						long long &total_bytes: Running total of bytes sent
+--						long long &calls: Running total of splice calls into the socket
+--
+--	RETURNS:		bool - true if the file was sent up to its end.
+--
+--	NOTES:
+--	Moves the file to the socket through a pipe with splice: file to pipe, then pipe to socket. The data stays in
+--	kernel pages the whole way. Used for files sendfile does not accept.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool splice_file(SOCKET sock, int file_fd, long long &total_bytes, long long &calls)
+{
+	int pipe_fds[2];
+	ssize_t in_pipe;
+	ssize_t moved;
+	bool success = true;
+
+	if (pipe(pipe_fds) == -1)
+	{
+		perror("pipe() failed");
+		return false;
+	}
+
+	while (success)
+	{
+		// File to Pipe
+		if ((in_pipe = splice(file_fd, NULL, pipe_fds[1], NULL, SPLICE_CHUNK, SPLICE_F_MOVE | SPLICE_F_MORE)) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("splice() from file failed");
+			success = false;
+			break;
+		}
+		if (in_pipe == 0)
+		{
+			break;
+		}
+
+		// Pipe to Socket
+		while (in_pipe > 0)
+		{
+			if ((moved = splice(pipe_fds[0], NULL, sock, NULL, in_pipe, SPLICE_F_MOVE | SPLICE_F_MORE | SPLICE_F_NONBLOCK)) == -1)
+			{
+				if (errno == EAGAIN || errno == EINTR)
+				{
+					wait_for_socket(sock, POLLOUT, SEND_TIMEOUT);
+					continue;
+				}
+				perror("splice() to socket failed");
+				success = false;
+				break;
+			}
+			in_pipe -= moved;
+			total_bytes += moved;
+			calls++;
+		}
+	}
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+	return success;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start_server
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Set up the io_uring engine]
+--					October 16, 2026 [Keep the EventLoop for late stream accepts]
+--					October 16, 2026 [Listen backlog of SOMAXCONN]
+--					October 16, 2026 [Start the event loops of the connections]
+--					October 16, 2026 [Echo with --echo]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Raise the descriptor limit for thousands of connections]
+--					October 17, 2026 [Receive frames with --frame]
+--					October 17, 2026 [Receive frames through io_uring as well]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start_server(int port, EventLoop &loop)
+--						int port: The Port the server will be listening on
+--						EventLoop &loop: Event loop that dispatches the socket events
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Starts the TCP Server and listens for connections on the given port. The listening socket is registered with the
+--	EventLoop for EVENT_ACCEPT. The connections are received by server_loops event loops (one per core by default):
+--	the given EventLoop is the first, and the others run on their own threads, pinned to the following cores. With a
+--	queue depth every event loop gets its own io_uring ring and receive slots, set up here once for every connection
+--	of the Server.
+----------------------------------------------------------------------------------------------------------------------*/
+void TCP::start_server(int port, EventLoop &loop)
+{
+	int reuse = 1;
+	int loops;
+	struct sockaddr_in internet_addr;
+
+	// Create Socket
+	if ((listen_socket = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
+	{
+		perror("socket() failed");
+		return;
+	}
+
+	setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	apply_tuning(listen_socket, options.tuning, true);
+
+	// Allocate the Receive Buffers before the First Transfer
+	recv_pool();
+	set_nonblocking(listen_socket);
+
+	// Initialize Address Structure
+	memset(&internet_addr, 0, sizeof(internet_addr));
+	internet_addr.sin_family = AF_INET;
+	internet_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	internet_addr.sin_port = htons(port);
+
+	// Bind socket to address structure
+	if (bind(listen_socket, (struct sockaddr *)&internet_addr, sizeof(internet_addr)) == SOCKET_ERROR)
+	{
+		perror("bind() failed");
+		closesocket(listen_socket);
+		listen_socket = INVALID_SOCKET;
+		return;
+	}
+
+	// Listen for connections (every stream of a striped transfer connects at once)
+	raise_file_limit(TCP_MAX_STREAMS + FILE_LIMIT_SPARE);
+	if (listen(listen_socket, SOMAXCONN))
+	{
+		perror("listen() failed");
+		closesocket(listen_socket);
+		listen_socket = INVALID_SOCKET;
+		return;
+	}
+
+	// Connections Closed on the Other Event Loops are Collected by this One
+	if ((closed_notify = eventfd(0, EFD_NONBLOCK)) == -1)
+	{
+		perror("eventfd() failed");
+		closesocket(listen_socket);
+		listen_socket = INVALID_SOCKET;
+		return;
+	}
+	loop.async_select(closed_notify, EVENT_READ);
+
+	// Frames are Parsed out of whatever Buffer or io_uring Slot the Stream was Read into
+	recv_frame = options.frame;
+
+	// Event Loops of the Connections, one per Core by Default
+	loops = (options.server_loops > 0) ? options.server_loops : LoopShards::core_count();
+	for (int i = 0; i < loops; i++)
+	{
+		recv_shards.push_back(std::unique_ptr<RecvShard>(new RecvShard()));
+
+		// Receive through io_uring (a ring is used by one thread, every loop has its own)
+		if (options.uring_depth > 0 && !uring_receiver_setup(recv_shards[i]->ring, options.uring_depth,
+			recv_shards[i]->ring_buffers, recv_shards[i]->slots) && i == 0)
+		{
+			fprintf(stderr, "io_uring is not available, receiving with recv()\n");
+		}
+	}
+	recv_shards[0]->loop = &loop;
+	recv_echo = options.echo;
+	recv_loops.start(loops - 1, 1, [](int shard, SOCKET sock, int event)
+	{
+		if (event == EVENT_READ || event == EVENT_CLOSE)
+		{
+			receive_stream(*recv_shards[shard + 1], sock);
+		}
+	});
+	for (int i = 1; i < loops; i++)
+	{
+		recv_shards[i]->loop = &recv_loops.loop(i - 1);
+	}
+
+	loop.async_select(listen_socket, EVENT_ACCEPT);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		accept_connection
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Start transfers with start_transfer]
+--					October 16, 2026 [Register the connection with the io_uring ring]
+--					October 16, 2026 [Keep every connection as a stream of the transfer]
+--					October 16, 2026 [Assign the connections to the event loops in turn]
+--					October 16, 2026 [Disable Nagle's algorithm with --echo]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Discard the save file when a second connection joins the transfer]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		accept_connection(SOCKET listen_sock, EventLoop &loop)
+--						SOCKET listen_sock: The listening socket passed by the EventLoop
+--						EventLoop &loop: Event loop that dispatches the socket events
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Accepts every pending connection from a client. This function is called by the EventLoop handler on
+--	EVENT_ACCEPT. Each new connection gets its own receive state and becomes part of the transfer in progress, and
+--	its socket is registered for EVENT_READ and EVENT_CLOSE with the next event loop in turn. The first connection
+--	starts the transfer timer, so that the time to first byte covers the wait for the Client's first packet. A second
+--	connection discards the save file of the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void TCP::accept_connection(SOCKET listen_sock, EventLoop &loop)
+{
+	struct sockaddr_in peer_addr;
+	socklen_t peer_len = sizeof(peer_addr);
+	char peer_ip[INET_ADDRSTRLEN];
+	SOCKET sock;
+
+	// Clients and the Streams of a Striped Transfer Connect Together
+	while ((sock = accept(listen_sock, (struct sockaddr *)&peer_addr, &peer_len)) != INVALID_SOCKET)
+	{
+		RecvStream *stream = new RecvStream();
+		int shard;
+
+		// Start Timer
+		if (!receiving)
+		{
+			start_transfer(options);
+		}
+		shard = (int)(recv_next_shard++ % recv_shards.size());
+
+		set_nonblocking(sock);
+		apply_tuning(sock, options.tuning, true);
+		if (recv_echo)
+		{
+			// Answer every Request at once
+			int nodelay = 1;
+			setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+		}
+		if (recv_streams.empty())
+		{
+			recv_settings = read_settings(sock, options.tuning, true);
+		}
+		else if (recv_sink.is_open())
+		{
+			// The Connections would Interleave their Data in the File
+			fprintf(stderr, "--save needs one connection per transfer, discarding %s\n", options.save_file.c_str());
+			std::lock_guard<std::mutex> guard(recv_sink_lock);
+			recv_sink.discard();
+		}
+		inet_ntop(AF_INET, &peer_addr.sin_addr, peer_ip, sizeof(peer_ip));
+		stream->sock = sock;
+		stream->id = (int)recv_streams.size() + 1;
+		stream->shard = shard;
+		stream->peer = std::string(peer_ip) + ":" + std::to_string(ntohs(peer_addr.sin_port));
+		stream->timer.start();
+		recv_streams.push_back(std::unique_ptr<RecvStream>(stream));
+		recv_open_streams++;
+		peer_len = sizeof(peer_addr);
+
+		// The Event Loop of the Connection Owns it from here
+		{
+			std::lock_guard<std::mutex> guard(recv_shards[shard]->lock);
+			recv_shards[shard]->streams[sock] = stream;
+		}
+		((shard == 0) ? loop : *recv_shards[shard]->loop).async_select(sock, EVENT_READ | EVENT_CLOSE);
+	}
+
+	if (errno != EAGAIN && errno != EWOULDBLOCK)
+	{
+		perror("accept() failed");
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_stream
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Frame the packets with --frame]
+--					October 17, 2026 [Checksum the packets with --verify]
+--					October 17, 2026 [Shut the connection down instead of closing a registered socket]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_stream(Executor &executor, AsyncSocket &conn, Payload &payload, int packet_size, int count,
+--						TokenBucket &bucket, FrameWriter *frames, long long &bytes, double &elapsed_ms,
+--						uint64_t start_ns)
+--						Executor &executor: Executor driving the streams
+--						AsyncSocket &conn: Connection of the stream
+--						Payload &payload: Prepared data of the stream
+--						int packet_size: Size of a packet in Bytes
+--						int count: Number of packets the stream sends
+--						TokenBucket &bucket: Pacing of the stream (inactive without a target rate)
+--						FrameWriter *frames: Framing of the stream's packets, or NULL to send them bare
+--						long long &bytes: Running total of bytes sent on the stream
+--						double &elapsed_ms: Set to the time the stream took
+--						uint64_t start_ns: Start of the transfer
+--
+--	RETURNS:		Task<bool> - true if every packet was sent.
+--
+--	NOTES:
+--	One stream of send_streams as a coroutine: sends its packets, sleeping on the executor for its tokens, and
+--	shuts down the sending side of the connection when done, so the Server sees the stream end. The socket stays
+--	open and registered; the owner closes it after destroying the AsyncSocket. A framed packet and its header are
+--	gathered by one sendmsg.
+----------------------------------------------------------------------------------------------------------------------*/
+static Task<bool> send_stream(Executor &executor, AsyncSocket &conn, Payload &payload, int packet_size, int count,
+	TokenBucket &bucket, FrameWriter *frames, long long &bytes, double &elapsed_ms, uint64_t start_ns)
+{
+	uint64_t due_ns;
+	long long sent_bytes;
+	struct iovec iov[2];
+	bool success = true;
+
+	for (int i = 0; i < count; i++)
+	{
+		if ((due_ns = bucket.reserve(1)) > 0)
+		{
+			co_await executor.sleep_until(due_ns);
+		}
+		if (frames != NULL)
+		{
+			sent_bytes = co_await conn.send(iov, frames->prepare(iov, payload.packet(i), packet_size));
+		}
+		else
+		{
+			sent_bytes = co_await conn.send(payload.packet(i), packet_size);
+		}
+		if (sent_bytes == -1)
+		{
+			perror("send() failed");
+			success = false;
+			break;
+		}
+		bytes += sent_bytes;
+	}
+
+	// End a Checksummed Stream with the Digest of its Packets
+	if (success && frames != NULL && frames->finish(iov) > 0)
+	{
+		if ((sent_bytes = co_await conn.send(iov, 1)) == -1)
+		{
+			perror("send() failed");
+			success = false;
+		}
+		else
+		{
+			bytes += sent_bytes;
+		}
+	}
+
+	shutdown(conn.socket(), SHUT_WR);
+	elapsed_ms = (monotonic_ns() - start_ns) / 1e6;
+
+	co_return success;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_packet
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Send read-only views of a prepared Payload]
+--					October 16, 2026 [Stream a file with --sendfile]
+--					October 16, 2026 [Send through io_uring with --uring]
+--					October 16, 2026 [Stripe across connections with --streams]
+--					October 16, 2026 [Pace with --bitrate and --pps]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 16, 2026 [Send with MSG_ZEROCOPY with --zerocopy]
+--					October 17, 2026 [Frame the packets with --frame]
+--					October 17, 2026 [Checksum the packets with --verify]
+--					October 17, 2026 [Send as one send_stream coroutine on an Executor]
+--					October 17, 2026 [Close the connection after its AsyncSocket is destroyed]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_packet(char *host, int port, int packet_size, int num_packet)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Sends packets of data to the Server. The Client connects to the TCP server with a non-blocking connect, then sends
+--	the packets as one send_stream coroutine on an Executor, the same stream send_streams runs many of, which
+--	suspends whenever the socket send buffer is full. With a queue depth the packets are sent through an io_uring
+--	ring instead. With a target rate every packet first waits for its tokens (see pacing.cpp). With a zero-copy pool
+--	size the packets are sent with MSG_ZEROCOPY (see zerocopy.cpp), which keeps its own loop since the completions
+--	are read back from the socket's error queue. With --frame every packet is sent behind a FrameHeader, the two
+--	gathered by one sendmsg (see frame.cpp). With --verify the headers carry the CRC32C of their packet, and a last
+--	frame the digest of the connection.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string TCP::send_packet(char *host, int port, int packet_size, int num_packet)
+{
+	long long total_bytes = 0;
+	long long syscalls = 0;
+	SOCKET connection;
+	Payload payload;
+	IoUring ring;
+	TokenBucket bucket;
+	ZeroCopySender zerocopy;
+	FrameWriter frames;
+	double stream_ms = 0;
+	long long wakeups = 0;
+	bool use_uring = false;
+	bool use_zerocopy = false;
+	std::string error_string;
+	std::string print_output;
+
+	result = TransferResult();
+
+	// Stream a File instead of Generated Packets (its Data never Reaches the Client to be Framed)
+	if (!options.send_file.empty())
+	{
+		if (options.frame)
+		{
+			fprintf(stderr, "sendfile sends the file unframed and unchecked, --payload-file frames it\n");
+		}
+		return send_file(host, port);
+	}
+
+	// Stripe the Packets across several Connections
+	if (options.streams > 1)
+	{
+		return send_streams(host, port, packet_size, num_packet);
+	}
+
+	// Generate the Data before Connecting
+	if (!payload.prepare(options, packet_size, num_packet, false))
+	{
+		return "Error payload";
+	}
+
+	// Connecting to the server
+	if ((connection = connect_to_server(host, port, options.tuning, error_string)) == INVALID_SOCKET)
+	{
+		return error_string;
+	}
+	result.socket = read_settings(connection, options.tuning, true);
+
+	// Send through io_uring
+	bucket.start(options, packet_size);
+	if (options.uring_depth > 0 && bucket.active())
+	{
+		fprintf(stderr, "io_uring keeps the queue full, pacing with send()\n");
+	}
+	else if (options.uring_depth > 0 && options.frame)
+	{
+		fprintf(stderr, "io_uring sends the registered payload unchanged, framing with sendmsg()\n");
+	}
+	else if (options.uring_depth > 0)
+	{
+		if (!(use_uring = uring_sender_setup(ring, options.uring_depth, connection, payload)))
+		{
+			fprintf(stderr, "io_uring is not available, sending with send()\n");
+		}
+	}
+
+	// Send with MSG_ZEROCOPY
+	if (options.zerocopy_depth > 0 && use_uring)
+	{
+		fprintf(stderr, "io_uring is in use, sending without MSG_ZEROCOPY\n");
+	}
+	else if (options.zerocopy_depth > 0 && options.frame)
+	{
+		fprintf(stderr, "Frames are sent with sendmsg(), sending without MSG_ZEROCOPY\n");
+	}
+	else if (options.zerocopy_depth > 0)
+	{
+		if (!(use_zerocopy = zerocopy.setup(connection, options.zerocopy_depth)))
+		{
+			fprintf(stderr, "MSG_ZEROCOPY is not available, sending with send()\n");
+		}
+	}
+
+	frames.start(0, 0, options.verify);
+	uint64_t send_start = monotonic_ns();
+
+	if (use_uring)
+	{
+		uring_send_stream(ring, payload, packet_size, num_packet, options.uring_depth, total_bytes);
+		syscalls = ring.enter_calls();
+	}
+	else if (use_zerocopy)
+	{
+		for (int i = 0; i < num_packet; i++)
+		{
+			bucket.take(1);
+			if (!zerocopy.send(payload.packet(i), packet_size, total_bytes, syscalls))
+			{
+				perror("send(MSG_ZEROCOPY) failed");
+				break;
+			}
+		}
+	}
+	else
+	{
+		// Otherwise the Connection is a Single send_stream Coroutine, which Ends it when Done
+		Executor executor;
+
+		if (!executor.is_ready())
+		{
+			closesocket(connection);
+			return "Error epoll";
+		}
+
+		AsyncSocket stream(executor, connection);
+		Task<bool> flow = send_stream(executor, stream, payload, packet_size, num_packet, bucket,
+			options.frame ? &frames : NULL, total_bytes, stream_ms, send_start);
+
+		executor.spawn(flow);
+		executor.run();
+		syscalls = stream.calls();
+		wakeups = executor.wakeups();
+	}
+
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = num_packet;
+	result.elapsed_ms = (monotonic_ns() - send_start) / 1e6;
+	result.syscalls = syscalls;
+	result.frames = frames.frames();
+	result.verify_ms = frames.verify_ms();
+
+	// The Payload must Outlive every Zero-Copy Send
+	if (use_zerocopy)
+	{
+		zerocopy.finish(SEND_TIMEOUT);
+		zerocopy.report(result);
+	}
+
+	// Append Data Information to print_output
+	print_output += "[TCP CLIENT]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Packets: ";
+	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
+	if (use_uring)
+	{
+		print_output += "\nEngine: io_uring (queue depth ";
+		print_output += std::to_string(options.uring_depth);
+		print_output += ")";
+	}
+	else if (!use_zerocopy)
+	{
+		print_output += "\nEngine: coroutine (";
+		print_output += std::to_string(wakeups);
+		print_output += " wakeups)";
+	}
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(total_bytes);
+	print_output += " Bytes";
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(syscalls);
+	if (options.frame)
+	{
+		frames.append_report(print_output, result.elapsed_ms);
+	}
+	if (use_zerocopy)
+	{
+		zerocopy.append_report(print_output);
+	}
+	if (bucket.active())
+	{
+		bucket.append_report(print_output, total_bytes, result.elapsed_ms);
+	}
+	append_settings(print_output, result.socket);
+
+	ring.close();
+	if (connection != INVALID_SOCKET)
+	{
+		closesocket(connection);
+	}
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_file
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Report the system calls]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_file(char *host, int port)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Streams the file named by the send_file option to the Server. The file is sent from the page cache with sendfile,
+--	so its contents never pass through a user space buffer. If sendfile does not support the file, it is moved with
+--	splice through a pipe instead. The client statistics report the file size, the bytes sent and the elapsed time.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string TCP::send_file(char *host, int port)
+{
+	int file_fd;
+	struct stat file_stat;
+	SOCKET connection;
+	off_t offset = 0;
+	ssize_t sent_bytes;
+	long long total_bytes = 0;
+	long long calls = 0;
+	bool success = true;
+	bool use_splice;
+	std::string error_string;
+	std::string print_output;
+
+	if ((file_fd = open(options.send_file.c_str(), O_RDONLY)) == -1 || fstat(file_fd, &file_stat) == -1)
+	{
+		perror("Cannot open file");
+		if (file_fd != -1)
+			close(file_fd);
+		return "Error open()";
+	}
+
+	// Connecting to the server
+	if ((connection = connect_to_server(host, port, options.tuning, error_string)) == INVALID_SOCKET)
+	{
+		close(file_fd);
+		return error_string;
+	}
+	result.socket = read_settings(connection, options.tuning, true);
+
+	uint64_t send_start = monotonic_ns();
+
+	// Files without a Known Size (pipes, /proc) can only be Moved with splice
+	use_splice = !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0;
+
+	// Send the File from the Page Cache
+	while (!use_splice && offset < file_stat.st_size)
+	{
+		if ((sent_bytes = sendfile(connection, file_fd, &offset, file_stat.st_size - offset)) == -1)
+		{
+			if (errno == EAGAIN || errno == EINTR)
+			{
+				wait_for_socket(connection, POLLOUT, SEND_TIMEOUT);
+				continue;
+			}
+			if ((errno == EINVAL || errno == ENOSYS) && total_bytes == 0)
+			{
+				// Not Supported for this File
+				use_splice = true;
+				break;
+			}
+			perror("sendfile() failed");
+			success = false;
+			break;
+		}
+		if (sent_bytes == 0)
+		{
+			// File Shrank while Sending
+			break;
+		}
+		total_bytes += sent_bytes;
+		calls++;
+	}
+
+	// Move the File through a Pipe
+	if (use_splice)
+	{
+		success = splice_file(connection, file_fd, total_bytes, calls);
+	}
+
+	close(file_fd);
+	closesocket(connection);
+
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = calls;
+	result.syscalls = calls;
+	result.elapsed_ms = (monotonic_ns() - send_start) / 1e6;
+
+	// Append Data Information to print_output
+	print_output += "[TCP CLIENT]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nFile: ";
+	print_output += options.send_file;
+	print_output += "\nFile Size: ";
+	print_output += std::to_string((long long)file_stat.st_size);
+	print_output += " Bytes";
+	print_output += "\nMethod: ";
+	print_output += use_splice ? "splice" : "sendfile";
+	print_output += " (";
+	print_output += std::to_string(calls);
+	print_output += " calls)";
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(total_bytes);
+	print_output += " Bytes";
+
+	char line[BUFFERSIZE];
+	snprintf(line, sizeof(line), "\nElapsed Time: %.3f ms", result.elapsed_ms);
+	print_output += line;
+	append_settings(print_output, result.socket);
+	if (!success)
+	{
+		print_output += "\nTransfer Incomplete";
+	}
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_streams
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Pace every stream to its share of the rate]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Drive the streams as coroutines on one Executor]
+--					October 17, 2026 [Frame the packets with --frame]
+--					October 17, 2026 [Checksum the packets with --verify]
+--					October 17, 2026 [Close the connections after deregistering them]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_streams(char *host, int port, int packet_size, int num_packet)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Stripes the packets across options.streams connections. Each stream sends a contiguous share of the packets from
+--	its own Payload, so a single flow's congestion window no longer limits the transfer. Every stream is a coroutine
+--	(send_stream) and one Executor drives them all on this thread, so thousands of streams need no more threads than
+--	one; only with io_uring every stream sends on a thread of its own. Every connection is established before any
+--	stream starts sending, so the Server sees the streams of the transfer overlap. The client statistics report the
+--	aggregate and the per-stream throughput. With a target rate every stream paces itself to its share of the rate.
+--	With --frame the frames carry the stream and the sequence number in the whole transfer, so the Server could put
+--	the striped packets back in order.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string TCP::send_streams(char *host, int port, int packet_size, int num_packet)
+{
+	int num_streams = options.streams;
+	std::vector<SOCKET> connections;
+	std::vector<Payload> payloads(num_streams);
+	std::vector<int> counts(num_streams);
+	std::vector<long long> stream_bytes(num_streams, 0);
+	std::vector<long long> stream_calls(num_streams, 0);
+	std::vector<double> stream_ms(num_streams, 0);
+	std::vector<std::thread> senders;
+	std::vector<TokenBucket> buckets(num_streams);
+	std::vector<FrameWriter> frames(num_streams);
+	std::string error_string;
+	std::string print_output;
+	long long total_bytes = 0;
+	long long syscalls = 0;
+	long long wakeups = 0;
+	SOCKET connection;
+	TransferOptions stream_options = options;
+	bool use_uring = (options.uring_depth > 0 && options.pace_bps == 0 && options.pace_pps == 0 && !options.frame);
+	uint32_t first_seq = 0;
+
+	// Every Stream Paces its Share of the Rate
+	stream_options.pace_bps /= num_streams;
+	stream_options.pace_pps /= num_streams;
+
+	// Share the Packets between the Streams
+	for (int k = 0; k < num_streams; k++)
+	{
+		counts[k] = num_packet / num_streams + ((k < num_packet % num_streams) ? 1 : 0);
+		if (counts[k] > 0 && !payloads[k].prepare(options, packet_size, counts[k], false))
+		{
+			return "Error payload";
+		}
+		frames[k].start(k, first_seq, options.verify);
+		first_seq += counts[k];
+	}
+
+	// Connect every Stream before Sending
+	raise_file_limit(num_streams + FILE_LIMIT_SPARE);
+	for (int k = 0; k < num_streams; k++)
+	{
+		if ((connection = connect_to_server(host, port, options.tuning, error_string)) == INVALID_SOCKET)
+		{
+			for (SOCKET open_connection : connections)
+				closesocket(open_connection);
+			return error_string;
+		}
+		connections.push_back(connection);
+	}
+	result.socket = read_settings(connections[0], options.tuning, true);
+
+	uint64_t send_start = monotonic_ns();
+
+	// io_uring Rings are per Thread, so every Stream gets its own Thread
+	for (int k = 0; k < num_streams && use_uring; k++)
+	{
+		senders.emplace_back([&, k]()
+		{
+			IoUring ring;
+
+			if (uring_sender_setup(ring, options.uring_depth, connections[k], payloads[k]))
+			{
+				uring_send_stream(ring, payloads[k], packet_size, counts[k], options.uring_depth, stream_bytes[k]);
+				stream_calls[k] = ring.enter_calls();
+				ring.close();
+			}
+			else
+			{
+				for (int i = 0; i < counts[k]; i++)
+				{
+					if (!send_all(connections[k], payloads[k].packet(i), packet_size, stream_bytes[k], stream_calls[k]))
+					{
+						perror("send() failed");
+						break;
+					}
+				}
+			}
+
+			closesocket(connections[k]);
+			stream_ms[k] = (monotonic_ns() - send_start) / 1e6;
+		});
+	}
+
+	for (std::thread &sender : senders)
+	{
+		sender.join();
+	}
+
+	// Otherwise every Stream is a Coroutine, all Driven by this Thread
+	if (!use_uring)
+	{
+		Executor executor;
+		std::vector<std::unique_ptr<AsyncSocket>> streams;
+		std::vector<Task<bool>> flows;
+
+		if (!executor.is_ready())
+		{
+			for (SOCKET open_connection : connections)
+				closesocket(open_connection);
+			return "Error epoll";
+		}
+
+		for (int k = 0; k < num_streams; k++)
+		{
+			buckets[k].start(stream_options, packet_size);
+			streams.emplace_back(new AsyncSocket(executor, connections[k]));
+			flows.push_back(send_stream(executor, *streams[k], payloads[k], packet_size, counts[k], buckets[k],
+				options.frame ? &frames[k] : NULL, stream_bytes[k], stream_ms[k], send_start));
+		}
+		for (Task<bool> &flow : flows)
+		{
+			executor.spawn(flow);
+		}
+		executor.run();
+
+		for (int k = 0; k < num_streams; k++)
+		{
+			stream_calls[k] = streams[k]->calls();
+		}
+		wakeups = executor.wakeups();
+
+		// Deregister the Sockets before Closing them
+		streams.clear();
+		for (SOCKET connection : connections)
+		{
+			closesocket(connection);
+		}
+	}
+
+	for (int k = 0; k < num_streams; k++)
+	{
+		total_bytes += stream_bytes[k];
+		syscalls += stream_calls[k];
+		result.frames += frames[k].frames();
+		result.verify_ms += frames[k].verify_ms();
+	}
+
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = num_packet;
+	result.elapsed_ms = (monotonic_ns() - send_start) / 1e6;
+	result.syscalls = syscalls;
+	result.streams = num_streams;
+
+	// Append Data Information to print_output
+	print_output += "[TCP CLIENT]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Packets: ";
+	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payloads[0].mode_name();
+	if (use_uring)
+	{
+		print_output += "\nEngine: io_uring (queue depth ";
+		print_output += std::to_string(options.uring_depth);
+		print_output += "), one thread per stream";
+	}
+	else
+	{
+		print_output += "\nEngine: coroutines on one thread (";
+		print_output += std::to_string(wakeups);
+		print_output += " wakeups)";
+	}
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(total_bytes);
+	print_output += " Bytes";
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(syscalls);
+	if (options.frame)
+	{
+		FrameWriter transfer_frames;
+
+		for (int k = 0; k < num_streams; k++)
+		{
+			transfer_frames.merge(frames[k]);
+		}
+		transfer_frames.append_report(print_output, result.elapsed_ms);
+	}
+
+	char line[BUFFERSIZE];
+	snprintf(line, sizeof(line), "\nElapsed Time: %.3f ms (%.2f Mbit/s)", result.elapsed_ms,
+		(result.elapsed_ms > 0) ? total_bytes * 8.0 / (result.elapsed_ms * 1000.0) : 0);
+	print_output += line;
+	if (options.pace_bps > 0 || options.pace_pps > 0)
+	{
+		TokenBucket bucket;
+
+		bucket.start(options, packet_size);
+		for (int k = 0; k < num_streams; k++)
+		{
+			bucket.add_waits(buckets[k]);
+		}
+		bucket.append_report(print_output, total_bytes, result.elapsed_ms);
+	}
+	append_settings(print_output, result.socket);
+	print_output += "\nStreams: ";
+	print_output += std::to_string(num_streams);
+	for (int k = 0; k < num_streams && k < STREAM_REPORT_LINES; k++)
+	{
+		append_stream_report(print_output, "Stream " + std::to_string(k + 1), stream_bytes[k], stream_ms[k]);
+	}
+	if (num_streams > STREAM_REPORT_LINES)
+	{
+		print_output += "\n... and ";
+		print_output += std::to_string(num_streams - STREAM_REPORT_LINES);
+		print_output += " more streams";
+	}
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		echo_request
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Give up after LATENCY_TIMEOUT ms]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		echo_request(AsyncSocket &conn, const char *request, char *reply, int packet_size)
+--						AsyncSocket &conn: Connection of the worker
+--						const char *request: Request to send
+--						char *reply: Buffer the response is read into
+--						int packet_size: Size of the request and of its response in Bytes
+--
+--	RETURNS:		Task<RequestStatus> - REQUEST_DONE once the whole response was read, REQUEST_FAILED otherwise.
+--
+--	NOTES:
+--	One request of measure_latency as a coroutine: sends the request, then reads until the whole echo is back or
+--	LATENCY_TIMEOUT ms have passed. TCP does not lose a response, so one that does not come back fails the worker.
+----------------------------------------------------------------------------------------------------------------------*/
+static Task<RequestStatus> echo_request(AsyncSocket &conn, const char *request, char *reply, int packet_size)
+{
+	uint64_t deadline_ns = monotonic_ns() + LATENCY_TIMEOUT * 1000000ULL;
+	long long received_bytes;
+	int received = 0;
+
+	if (co_await conn.send(request, packet_size) == -1)
+	{
+		perror("send() failed");
+		co_return REQUEST_FAILED;
+	}
+
+	// Read the Whole Response
+	while (received < packet_size)
+	{
+		if ((received_bytes = co_await conn.recv(reply + received, packet_size - received, deadline_ns)) <= 0)
+		{
+			fprintf(stderr, "No response from the server (is it running with --echo?)\n");
+			co_return REQUEST_FAILED;
+		}
+		received += (int)received_bytes;
+	}
+
+	co_return REQUEST_DONE;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		measure_latency
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Read the responses with AsyncSocket::recv on an Executor per worker]
+--					October 17, 2026 [Run every worker on one Executor]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		measure_latency(char *host, int port, int packet_size, int num_request)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a request in Bytes
+--						int num_request: Number of requests to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Sends num_request requests of packet_size Bytes to a Server started with --echo, and reads each response in
+--	full before the connection sends its next request. Every one of the concurrency workers has its own connection
+--	with Nagle's algorithm off, so no request waits for the acknowledgement of the one before it. Every request is
+--	an echo_request coroutine, and the connections of all workers are driven by one Executor on this thread.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string TCP::measure_latency(char *host, int port, int packet_size, int num_request)
+{
+	LatencyRun run;
+	std::vector<SOCKET> socks;
+	Executor executor;
+	std::vector<std::unique_ptr<AsyncSocket>> conns;
+	std::vector<std::vector<char>> replies;
+	Payload payload;
+	const char *request;
+	std::string print_output;
+	std::string error_string;
+	int nodelay = 1;
+
+	result = TransferResult();
+	run.concurrency = options.concurrency;
+	run.num_request = num_request;
+	run.rate = options.request_rate;
+
+	if (!payload.prepare(options, packet_size, 1, false))
+	{
+		return "Error payload";
+	}
+	request = payload.packet(0);
+	if (!executor.is_ready())
+	{
+		return "Error epoll";
+	}
+
+	// Connect every Worker
+	raise_file_limit(run.concurrency + FILE_LIMIT_SPARE);
+	for (int w = 0; w < run.concurrency; w++)
+	{
+		SOCKET sock = connect_to_server(host, port, options.tuning, error_string);
+
+		if (sock == INVALID_SOCKET)
+		{
+			for (SOCKET open_sock : socks)
+			{
+				closesocket(open_sock);
+			}
+			return error_string;
+		}
+		setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+		if (w == 0)
+		{
+			result.socket = read_settings(sock, options.tuning, true);
+		}
+		socks.push_back(sock);
+		replies.emplace_back(packet_size);
+		conns.emplace_back(new AsyncSocket(executor, sock));
+	}
+
+	run_latency(run, executor, [&](int w, uint32_t) -> Task<RequestStatus>
+	{
+		return echo_request(*conns[w], request, replies[w].data(), packet_size);
+	});
+
+	// Deregister the Sockets before Closing them
+	conns.clear();
+	for (SOCKET sock : socks)
+	{
+		closesocket(sock);
+	}
+	result.total_bytes = run.completed * packet_size;
+
+	// Append Latency Information to print_output
+	print_output += "[TCP LATENCY]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Requests: ";
+	print_output += std::to_string(num_request);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
+	append_latency_report(print_output, run, result);
+	append_settings(print_output, result.socket);
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_packet
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Save transfers with a DiskSink]
+--					October 16, 2026 [Receive through io_uring with --uring]
+--					October 16, 2026 [Receive the streams of a striped transfer]
+--					October 16, 2026 [Collect the connections of every event loop]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [List at most STREAM_REPORT_LINES connections]
+--					October 17, 2026 [Report the frames with --frame]
+--					October 17, 2026 [Report the checksums with --verify]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_packet(int port, SOCKET sock, std::string &print_string)
+--						int port: The Port the server is listening on
+--						SOCKET sock: The connection socket passed by the EventLoop
+--						std::string &print_string: Set to the transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Receives data from the Client. This function is called by the EventLoop handler on EVENT_READ and EVENT_CLOSE.
+--	The connections of the main EventLoop are drained here with receive_stream, the others on the threads of their
+--	own event loops. Every connection that is closed is added to the transfer in progress (its timer is merged into
+--	the transfer timer), and once every connection of the transfer is closed the aggregate and per-connection
+--	statistics are written to print_string. The closed_notify eventfd wakes the main EventLoop when another loop
+--	closes a connection. The packet count of the result is the number of reads, since TCP does not keep the packet
+--	boundaries of the Client, unless the packets were framed (--frame), in which case it is the number of frames.
+----------------------------------------------------------------------------------------------------------------------*/
+void TCP::receive_packet([[maybe_unused]] int port, SOCKET sock, std::string &print_string)
+{
+	RecvBufferPool &pool = recv_pool();
+	std::vector<RecvStream *> closed;
+	uint64_t notified;
+	std::string print_output;
+
+	if (recv_shards.empty())
+	{
+		return;
+	}
+
+	// Connections Closed on the Other Event Loops
+	if (sock == closed_notify)
+	{
+		if (read(closed_notify, &notified, sizeof(notified)) == -1 && errno != EAGAIN)
+		{
+			perror("read() failed");
+		}
+	}
+	else
+	{
+		receive_stream(*recv_shards[0], sock);
+	}
+
+	// Add the Closed Connections to the Transfer
+	{
+		std::lock_guard<std::mutex> guard(closed_lock);
+		closed.swap(closed_streams);
+	}
+	for (RecvStream *stream : closed)
+	{
+		recv_timer.merge(stream->timer);
+		recv_total_bytes += stream->total_bytes;
+		recv_reads += stream->reads;
+		recv_syscalls += stream->syscalls;
+		recv_frames.merge(stream->frames);
+		recv_open_streams--;
+	}
+	if (closed.empty())
+	{
+		return;
+	}
+
+	// Connections still Waiting to be Accepted Belong to this Transfer
+	if (recv_open_streams == 0)
+	{
+		accept_connection(listen_socket, *recv_shards[0]->loop);
+	}
+	if (recv_open_streams > 0)
+	{
+		return;
+	}
+
+	receiving = false;
+	recv_sink.close();
+
+	if (recv_total_bytes == 0)
+	{
+		return;
+	}
+
+	// Record Server Statistics
+	result.total_bytes = recv_total_bytes;
+	result.packets = recv_reads;
+	result.syscalls = recv_syscalls;
+	result.streams = (int)recv_streams.size();
+	result.socket = recv_settings;
+	recv_timer.report(result);
+	pool.report(result, recv_pool_start);
+	if (!options.save_file.empty())
+	{
+		recv_sink.report(result);
+	}
+	if (recv_frame)
+	{
+		// Framing Keeps the Packet Boundaries of the Client
+		recv_frames.report(result);
+		if (result.frames > 0)
+		{
+			result.packets = result.frames;
+		}
+	}
+
+	// Append Received Data Statistics to print_output
+	print_output += "[TCP SERVER]";
+	recv_timer.append_report(print_output);
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(recv_total_bytes);
+	print_output += " Bytes";
+	if (recv_shards[0]->ring.is_ready())
+	{
+		print_output += "\nEngine: io_uring (queue depth ";
+		print_output += std::to_string(recv_shards[0]->slots.size());
+		print_output += ")";
+	}
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(recv_syscalls);
+	if (recv_frame)
+	{
+		recv_frames.append_report(print_output, recv_timer.elapsed_ms());
+	}
+	if (recv_shards.size() > 1)
+	{
+		print_output += "\nEvent Loops: ";
+		print_output += std::to_string(recv_shards.size());
+	}
+	if (recv_streams.size() > 1)
+	{
+		print_output += "\nConnections: ";
+		print_output += std::to_string(recv_streams.size());
+		for (size_t i = 0; i < recv_streams.size() && i < STREAM_REPORT_LINES; i++)
+		{
+			RecvStream *stream = recv_streams[i].get();
+
+			append_stream_report(print_output, "Connection " + std::to_string(stream->id) + " (" + stream->peer
+				+ ", Loop " + std::to_string(stream->shard + 1) + ")", stream->total_bytes, stream->timer.elapsed_ms());
+		}
+		if (recv_streams.size() > STREAM_REPORT_LINES)
+		{
+			print_output += "\n... and ";
+			print_output += std::to_string(recv_streams.size() - STREAM_REPORT_LINES);
+			print_output += " more connections";
+		}
+	}
+	pool.append_report(print_output, recv_pool_start);
+	append_settings(print_output, recv_settings);
+	if (!options.save_file.empty())
+	{
+		recv_sink.append_report(print_output);
+	}
+
+	print_string = print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		end_connection
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Release the io_uring ring]
+--					October 16, 2026 [Close every stream]
+--					October 16, 2026 [Stop the event loops of the connections]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		end_connection()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Stops the event loops of the connections, closes the connection sockets and the listening socket so that the
+--	server can be started again on the same port, and releases the io_uring rings.
+----------------------------------------------------------------------------------------------------------------------*/
+void TCP::end_connection()
+{
+	// Stop the Other Event Loops before Closing their Connections
+	recv_loops.stop();
+
+	for (std::unique_ptr<RecvShard> &shard : recv_shards)
+	{
+		shard->ring.unregister_file();
+	}
+	for (std::unique_ptr<RecvStream> &stream : recv_streams)
+	{
+		if (stream->sock != INVALID_SOCKET)
+		{
+			closesocket(stream->sock);
+		}
+	}
+	recv_streams.clear();
+	closed_streams.clear();
+	recv_open_streams = 0;
+	if (listen_socket != INVALID_SOCKET)
+	{
+		closesocket(listen_socket);
+		listen_socket = INVALID_SOCKET;
+	}
+	if (closed_notify != -1)
+	{
+		close(closed_notify);
+		closed_notify = -1;
+	}
+	for (std::unique_ptr<RecvShard> &shard : recv_shards)
+	{
+		uring_receiver_release(shard->ring, shard->ring_buffers, shard->slots);
+	}
+	recv_shards.clear();
+	receiving = false;
+}
+
+#endif
@@ -0,0 +1,656 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	timestamp.cpp - Kernel and hardware timestamps of UDP datagrams, and the one-way delay they reveal
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					uint64_t realtime_ns()
+--					bool timestamping_enable(SOCKET sock, bool transmit)
+--					bool timestamp_read(const struct msghdr &msg, uint64_t &ns, bool &hardware)
+--					bool timestamp_parse(const char *datagram, ssize_t len, uint32_t &tx_seq, uint64_t &app_ns,
+--						uint64_t &tx_ns, bool &hardware)
+--					bool start(SOCKET sock)
+--					void sent(uint64_t app_ns)
+--					void reap()
+--					void finish(int timeout_ms)
+--					void follow_up(TimestampFollowUp &follow_up)
+--					void append_report(std::string &print_output)
+--					void start()
+--					void received(const char *datagram, ssize_t len, uint32_t seq, const struct msghdr &msg,
+--						uint64_t app_ns)
+--					void report(TransferResult &result)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The Server times a datagram when recvmsg returns it, which is after the scheduler and the event loop got round
+--	to the socket. With --timestamps both sides turn on SO_TIMESTAMPING. The kernel stamps every datagram the
+--	Client sends as it leaves for the device (TX) and every datagram the Server receives as it arrives from the
+--	device (RX), with the NIC's hardware clock where the device supports it and its timestamping is turned on.
+--
+--	The TX timestamp of a datagram is only known after it has been sent, so the Client reads it from the error
+--	queue and sends it on in a later datagram: a TimestampFollowUp after the SequenceStamp carries the sequence
+--	number, the time of the send call and the TX timestamp of the latest datagram the kernel has stamped. The Server
+--	keeps the arrival of the last TIMESTAMP_WINDOW datagrams until their follow-up arrives, and splits the one-way
+--	delay from the send call to the read into:
+--
+--		Sender Stack	send call to TX timestamp (the Client's socket, qdisc and driver queues)
+--		Network			TX timestamp to RX timestamp (wire, switches, NIC and interrupt)
+--		Receiver		RX timestamp to read (socket queue, scheduler and event loop delay)
+--
+--	Software timestamps and the send and read times are CLOCK_REALTIME, so across hosts the network and one-way
+--	delays are only as good as the clock synchronisation (NTP or PTP); a negative delay means the clocks are off and
+--	the sample is skipped. Hardware timestamps are the NIC clocks, which must be synchronised to the system clock
+--	(phc2sys) for the stack delays. The follow-ups of the last datagrams never arrive, so those are not split.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "timestamp.h"
+#include "sequence.h"
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		realtime_ns
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		realtime_ns()
+--
+--	RETURNS:		uint64_t - nanoseconds since the epoch on the clock the software timestamps are taken with.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t realtime_ns()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		timestamping_enable
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		timestamping_enable(SOCKET sock, bool transmit)
+--						SOCKET sock: Datagram socket
+--						bool transmit: true for the TX timestamps of the Client, false for the RX timestamps
+--
+--	RETURNS:		bool - false if the kernel does not support SO_TIMESTAMPING.
+--
+--	NOTES:
+--	Asks for software and raw hardware timestamps. The TX timestamps are numbered per send call (OPT_ID) and
+--	queued without the packet (OPT_TSONLY).
+----------------------------------------------------------------------------------------------------------------------*/
+bool timestamping_enable(SOCKET sock, bool transmit)
+{
+	int flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+	if (transmit)
+		flags |= SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_OPT_ID
+			| SOF_TIMESTAMPING_OPT_TSONLY;
+	else
+		flags |= SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_RX_HARDWARE;
+
+	if (setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == -1)
+	{
+		perror("setsockopt(SO_TIMESTAMPING) failed");
+		return false;
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		timestamp_read
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		timestamp_read(const struct msghdr &msg, uint64_t &ns, bool &hardware)
+--						const struct msghdr &msg: Message returned by recvmsg, with its control data
+--						uint64_t &ns: Set to the timestamp
+--						bool &hardware: Set to true if the timestamp is from the NIC clock
+--
+--	RETURNS:		bool - true if the message carries a timestamp.
+----------------------------------------------------------------------------------------------------------------------*/
+bool timestamp_read(const struct msghdr &msg, uint64_t &ns, bool &hardware)
+{
+	struct scm_timestamping stamps;
+
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR((struct msghdr *)&msg, cmsg))
+	{
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING)
+		{
+			continue;
+		}
+
+		memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+
+		// ts[2] is the Hardware Timestamp, ts[0] the Software One
+		hardware = (stamps.ts[2].tv_sec != 0 || stamps.ts[2].tv_nsec != 0);
+		const struct timespec &stamp = hardware ? stamps.ts[2] : stamps.ts[0];
+		if (stamp.tv_sec == 0 && stamp.tv_nsec == 0)
+		{
+			return false;
+		}
+		ns = (uint64_t)stamp.tv_sec * 1000000000ULL + stamp.tv_nsec;
+		return true;
+	}
+
+	return false;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		timestamp_parse
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		timestamp_parse(const char *datagram, ssize_t len, uint32_t &tx_seq, uint64_t &app_ns,
+--						uint64_t &tx_ns, bool &hardware)
+--						const char *datagram: Received datagram, starting with a SequenceStamp
+--						ssize_t len: Length of the datagram
+--						uint32_t &tx_seq: Set to the sequence number of the datagram the follow-up is about
+--						uint64_t &app_ns: Set to the time of its send call
+--						uint64_t &tx_ns: Set to its TX timestamp
+--						bool &hardware: Set to true if the TX timestamp is from the NIC clock
+--
+--	RETURNS:		bool - true if the datagram carries a follow-up with a TX timestamp.
+----------------------------------------------------------------------------------------------------------------------*/
+bool timestamp_parse(const char *datagram, ssize_t len, uint32_t &tx_seq, uint64_t &app_ns, uint64_t &tx_ns,
+	bool &hardware)
+{
+	TimestampFollowUp follow_up;
+	uint32_t flags;
+
+	if (len < (ssize_t)(sizeof(SequenceStamp) + sizeof(TimestampFollowUp)))
+	{
+		return false;
+	}
+
+	memcpy(&follow_up, datagram + sizeof(SequenceStamp), sizeof(follow_up));
+	flags = ntohl(follow_up.flags);
+	if (ntohl(follow_up.magic) != TIMESTAMP_MAGIC || !(flags & TIMESTAMP_VALID))
+	{
+		return false;
+	}
+
+	tx_seq = ntohl(follow_up.tx_seq);
+	app_ns = ((uint64_t)ntohl(follow_up.app_ns_high) << 32) | ntohl(follow_up.app_ns_low);
+	tx_ns = ((uint64_t)ntohl(follow_up.tx_ns_high) << 32) | ntohl(follow_up.tx_ns_low);
+	hardware = (flags & TIMESTAMP_HARDWARE) != 0;
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start(SOCKET sock)
+--						SOCKET sock: Datagram socket of the Client, before its first send
+--
+--	RETURNS:		bool - false if TX timestamps are not available.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TxTimestamps::start(SOCKET sock)
+{
+	if (!timestamping_enable(sock, true))
+	{
+		return false;
+	}
+
+	socket = sock;
+	next_id = 0;
+	has_latest = false;
+	stamped = 0;
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		sent
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		sent(uint64_t app_ns)
+--						uint64_t app_ns: Time of the send call
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called after every successful send. The kernel numbers the sends from 0, so the number is the sequence number
+--	of the datagram as long as every datagram takes one send call.
+----------------------------------------------------------------------------------------------------------------------*/
+void TxTimestamps::sent(uint64_t app_ns)
+{
+	app_times[next_id % TIMESTAMP_WINDOW] = app_ns;
+	next_id++;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		reap
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		reap()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Reads every TX timestamp queued on the error queue without waiting, and keeps the latest for the next follow-up.
+----------------------------------------------------------------------------------------------------------------------*/
+void TxTimestamps::reap()
+{
+	char control[TIMESTAMP_CONTROL_SIZE + BUFFERSIZE];
+	struct msghdr msg;
+	struct sock_extended_err *error;
+	uint64_t tx_ns;
+	uint32_t id;
+	bool tx_hardware;
+
+	while (true)
+	{
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		if (recvmsg(socket, &msg, MSG_ERRQUEUE) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return;
+		}
+
+		if (!timestamp_read(msg, tx_ns, tx_hardware))
+		{
+			continue;
+		}
+
+		// The Number of the Send is in the Extended Error
+		error = NULL;
+		for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+				|| (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+			{
+				error = (struct sock_extended_err *)CMSG_DATA(cmsg);
+			}
+		}
+		if (error == NULL || error->ee_origin != SO_EE_ORIGIN_TIMESTAMPING || error->ee_info != SCM_TSTAMP_SND)
+		{
+			continue;
+		}
+
+		// Skip Timestamps that are Older than the Latest, or whose Send Time is Gone
+		id = error->ee_data;
+		if ((has_latest && (int32_t)(id - latest_seq) <= 0) || next_id - id > TIMESTAMP_WINDOW)
+		{
+			continue;
+		}
+
+		latest_seq = id;
+		latest_app_ns = app_times[id % TIMESTAMP_WINDOW];
+		latest_tx_ns = tx_ns;
+		has_latest = true;
+		hardware = tx_hardware;
+		stamped++;
+		if (tx_ns >= latest_app_ns)
+		{
+			send_stack.record(tx_ns - latest_app_ns);
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		finish
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		finish(int timeout_ms)
+--						int timeout_ms: Maximum time to wait for the next timestamp
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Waits for the timestamp of the last send, for the report.
+----------------------------------------------------------------------------------------------------------------------*/
+void TxTimestamps::finish(int timeout_ms)
+{
+	reap();
+	while (next_id > 0 && (!has_latest || latest_seq != next_id - 1))
+	{
+		if (!wait_for_socket(socket, 0, timeout_ms))
+		{
+			return;
+		}
+		reap();
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		follow_up
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		follow_up(TimestampFollowUp &follow_up)
+--						TimestampFollowUp &follow_up: Set to the follow-up of the latest stamped datagram
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Until the first timestamp has been read the follow-up is not flagged valid.
+----------------------------------------------------------------------------------------------------------------------*/
+void TxTimestamps::follow_up(TimestampFollowUp &follow_up) const
+{
+	follow_up.magic = htonl(TIMESTAMP_MAGIC);
+	follow_up.flags = htonl((has_latest ? TIMESTAMP_VALID : 0) | (hardware ? TIMESTAMP_HARDWARE : 0));
+	follow_up.tx_seq = htonl(latest_seq);
+	follow_up.app_ns_high = htonl((uint32_t)(latest_app_ns >> 32));
+	follow_up.app_ns_low = htonl((uint32_t)latest_app_ns);
+	follow_up.tx_ns_high = htonl((uint32_t)(latest_tx_ns >> 32));
+	follow_up.tx_ns_low = htonl((uint32_t)latest_tx_ns);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the report is appended to
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void TxTimestamps::append_report(std::string &print_output) const
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nTX Timestamps: %lld of %u Datagrams (%s)", stamped, next_id,
+		hardware ? "hardware" : "software");
+	print_output += line;
+	if (send_stack.count() > 0)
+	{
+		snprintf(line, sizeof(line), "\nSend Call to TX Timestamp p50/p99/max: %.1f / %.1f / %.1f us",
+			send_stack.percentile_ns(50) / 1e3, send_stack.percentile_ns(99) / 1e3, send_stack.max_ns() / 1e3);
+		print_output += line;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Clears the statistics for a new transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void OneWayDelay::start()
+{
+	*this = OneWayDelay();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		received
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		received(const char *datagram, ssize_t len, uint32_t seq, const struct msghdr &msg,
+--						uint64_t app_ns)
+--						const char *datagram: Received datagram, starting with a SequenceStamp
+--						ssize_t len: Length of the datagram
+--						uint32_t seq: Sequence number of the datagram
+--						const struct msghdr &msg: Message returned by recvmsg, with the RX timestamp
+--						uint64_t app_ns: Time recvmsg returned
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Records the receiver delay of the datagram and keeps its arrival. If the datagram carries the follow-up of an
+--	earlier datagram still in the window, the delay of that one is split.
+----------------------------------------------------------------------------------------------------------------------*/
+void OneWayDelay::received(const char *datagram, ssize_t len, uint32_t seq, const struct msghdr &msg,
+	uint64_t app_ns)
+{
+	RxTimestamp arrival;
+	uint32_t tx_seq;
+	uint64_t send_ns, tx_ns;
+	bool tx_hardware;
+
+	// Arrival
+	if (timestamp_read(msg, arrival.rx_ns, arrival.hardware))
+	{
+		rx_stamped++;
+		arrival.seq = seq;
+		arrival.app_ns = app_ns;
+		hardware = hardware || arrival.hardware;
+		window[seq % TIMESTAMP_WINDOW] = arrival;
+		if (app_ns >= arrival.rx_ns)
+			recv_stack.record(app_ns - arrival.rx_ns);
+		else
+			skewed++;
+	}
+	else
+	{
+		rx_missing++;
+	}
+
+	// Follow-Up of an Earlier Datagram
+	if (!timestamp_parse(datagram, len, tx_seq, send_ns, tx_ns, tx_hardware))
+	{
+		return;
+	}
+
+	RxTimestamp &earlier = window[tx_seq % TIMESTAMP_WINDOW];
+	if (earlier.seq != tx_seq)
+	{
+		return;
+	}
+	earlier.seq = UINT32_MAX;
+	matched++;
+
+	if (tx_ns >= send_ns)
+	{
+		send_stack.record(tx_ns - send_ns);
+	}
+	if (earlier.app_ns >= send_ns)
+	{
+		one_way.record(earlier.app_ns - send_ns);
+	}
+	if (tx_hardware != earlier.hardware)
+	{
+		mixed++;
+	}
+	else if (earlier.rx_ns >= tx_ns)
+	{
+		network.record(earlier.rx_ns - tx_ns);
+	}
+	else
+	{
+		skewed++;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Statistics of the transfer
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void OneWayDelay::report(TransferResult &result) const
+{
+	result.one_way_p50_us = one_way.percentile_ns(50) / 1e3;
+	result.one_way_p99_us = one_way.percentile_ns(99) / 1e3;
+	result.send_stack_p50_us = send_stack.percentile_ns(50) / 1e3;
+	result.network_p50_us = network.percentile_ns(50) / 1e3;
+	result.recv_stack_p50_us = recv_stack.percentile_ns(50) / 1e3;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_delay
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_delay(std::string &print_output, const char *label, const LatencyHistogram &histogram)
+--						std::string &print_output: Output string the line is appended to
+--						const char *label: Name of the delay
+--						const LatencyHistogram &histogram: Samples of the delay
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+static void append_delay(std::string &print_output, const char *label, const LatencyHistogram &histogram)
+{
+	char line[BUFFERSIZE * 2];
+
+	if (histogram.count() == 0)
+	{
+		return;
+	}
+
+	snprintf(line, sizeof(line), "\n%s p50/p99/p99.9/max: %.1f / %.1f / %.1f / %.1f us (%lld)", label,
+		histogram.percentile_ns(50) / 1e3, histogram.percentile_ns(99) / 1e3, histogram.percentile_ns(99.9) / 1e3,
+		histogram.max_ns() / 1e3, histogram.count());
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the report is appended to
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void OneWayDelay::append_report(std::string &print_output) const
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nRX Timestamps: %lld of %lld Datagrams (%s), %lld with their TX timestamp",
+		rx_stamped, rx_stamped + rx_missing, hardware ? "hardware" : "software", matched);
+	print_output += line;
+	append_delay(print_output, "One-Way Delay (send call to read)", one_way);
+	append_delay(print_output, "  Sender Stack (send call to TX)", send_stack);
+	append_delay(print_output, "  Network (TX to RX)", network);
+	append_delay(print_output, "  Receiver (RX to read)", recv_stack);
+	if (skewed > 0)
+	{
+		print_output += "\nNegative Delays Skipped (clocks not synchronised): ";
+		print_output += std::to_string(skewed);
+	}
+	if (mixed > 0)
+	{
+		print_output += "\nHardware/Software Timestamp Pairs Skipped: ";
+		print_output += std::to_string(mixed);
+	}
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "transport.h"
+#include "latency.h"
+#include <stdint.h>
+#include <time.h>
+
+#define TIMESTAMP_MAGIC 0x54535431
+#define TIMESTAMP_WINDOW 4096
+
+// Flags of a Follow-Up
+#define TIMESTAMP_VALID 1
+#define TIMESTAMP_HARDWARE 2
+
+// Control Buffer Space of an SCM_TIMESTAMPING Message (software, deprecated and hardware timespec)
+#define TIMESTAMP_CONTROL_SIZE CMSG_SPACE(sizeof(struct timespec) * 3)
+
+// Follow-Up after the SequenceStamp: when an Earlier Datagram was Sent (sent in network byte order)
+struct TimestampFollowUp
+{
+	uint32_t magic;
+	uint32_t flags;
+	uint32_t tx_seq;
+	uint32_t app_ns_high;
+	uint32_t app_ns_low;
+	uint32_t tx_ns_high;
+	uint32_t tx_ns_low;
+};
+
+// Arrival of a Datagram, Kept until its Follow-Up Arrives
+struct RxTimestamp
+{
+	uint32_t seq = UINT32_MAX;
+	uint64_t rx_ns = 0;
+	uint64_t app_ns = 0;
+	bool hardware = false;
+};
+
+uint64_t realtime_ns();
+bool timestamping_enable(SOCKET sock, bool transmit);
+bool timestamp_read(const struct msghdr &msg, uint64_t &ns, bool &hardware);
+bool timestamp_parse(const char *datagram, ssize_t len, uint32_t &tx_seq, uint64_t &app_ns, uint64_t &tx_ns,
+	bool &hardware);
+
+// Kernel Transmit Timestamps of a UDP Client's Datagrams, Sent on in Later Datagrams
+class TxTimestamps
+{
+	public:
+		TxTimestamps() : app_times(TIMESTAMP_WINDOW, 0) {};
+		~TxTimestamps() {};
+		bool start(SOCKET sock);
+		void sent(uint64_t app_ns);
+		void reap();
+		void finish(int timeout_ms);
+		void follow_up(TimestampFollowUp &follow_up) const;
+		void append_report(std::string &print_output) const;
+	private:
+		SOCKET socket = INVALID_SOCKET;
+		std::vector<uint64_t> app_times;
+		uint32_t next_id = 0;
+		uint32_t latest_seq = 0;
+		uint64_t latest_app_ns = 0;
+		uint64_t latest_tx_ns = 0;
+		bool has_latest = false;
+		bool hardware = false;
+		long long stamped = 0;
+		LatencyHistogram send_stack;
+};
+
+// One-Way Delay of the Timestamped Datagrams of a Transfer, Split into its Parts (Server side)
+class OneWayDelay
+{
+	public:
+		OneWayDelay() : window(TIMESTAMP_WINDOW) {};
+		~OneWayDelay() {};
+		void start();
+		void received(const char *datagram, ssize_t len, uint32_t seq, const struct msghdr &msg, uint64_t app_ns);
+		bool active() const { return rx_stamped > 0; };
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output) const;
+	private:
+		std::vector<RxTimestamp> window;
+		long long rx_stamped = 0;
+		long long rx_missing = 0;
+		long long matched = 0;
+		long long skewed = 0;
+		long long mixed = 0;
+		bool hardware = false;
+		LatencyHistogram send_stack;
+		LatencyHistogram network;
+		LatencyHistogram recv_stack;
+		LatencyHistogram one_way;
+};
@@ -0,0 +1,383 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	timing.cpp - Monotonic high resolution timing of transfers
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					uint64_t monotonic_ns()
+--					void start()
+--					void record_chunk(long long bytes)
+--					void merge(const TransferTimer &other)
+--					double elapsed_ms()
+--					double ttfb_ms()
+--					double throughput_mbps()
+--					double gap_percentile_us(double percentile)
+--					void report(TransferResult &result)
+--					void append_report(std::string &print_output)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The receive paths used to time transfers with GetSystemTime, which has millisecond resolution and wraps every
+--	minute. The TransferTimer uses a monotonic nanosecond clock (clock_gettime(CLOCK_MONOTONIC) on POSIX,
+--	QueryPerformanceCounter on Windows). It records when the transfer started, when the first and last bytes arrived,
+--	and the gap between every pair of consecutive chunks, and reports the transfer time, time to first byte,
+--	throughput in Mbit/s and the p50/p99/p999 inter-arrival gaps.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "timing.h"
+#include <algorithm>
+#include <time.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		monotonic_ns
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		monotonic_ns()
+--
+--	RETURNS:		uint64_t - nanoseconds since an arbitrary fixed point.
+--
+--	NOTES:
+--	Reads the monotonic clock. Only differences between two readings are meaningful.
+----------------------------------------------------------------------------------------------------------------------*/
+uint64_t monotonic_ns()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0)
+	{
+		QueryPerformanceFrequency(&frequency);
+	}
+	QueryPerformanceCounter(&counter);
+
+	// Split the conversion to avoid overflowing 64 bits
+	return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ULL
+		+ (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ULL / frequency.QuadPart;
+#else
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start()
+--					start(uint64_t now_ns)
+--						uint64_t now_ns: Start time, if the caller has already read the clock
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Resets the timer and marks the start of a transfer. For TCP this is when the connection is accepted, so that the
+--	time to first byte includes the wait for the Client's first packet.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferTimer::start()
+{
+	start(monotonic_ns());
+}
+
+void TransferTimer::start(uint64_t now_ns)
+{
+	start_ns = now_ns;
+	first_ns = 0;
+	last_ns = now_ns;
+	total_bytes = 0;
+	chunks = 0;
+	gaps.clear();
+	gaps.reserve(GAP_RESERVE);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_chunk
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_chunk(long long bytes)
+--					record_chunk(long long bytes, uint64_t now_ns)
+--						long long bytes: Number of bytes returned by the read
+--						uint64_t now_ns: Arrival time, if the caller has already read the clock
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Records the arrival of one chunk (one successful read or one datagram). The gap since the previous chunk is kept
+--	for the inter-arrival percentiles.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferTimer::record_chunk(long long bytes)
+{
+	record_chunk(bytes, monotonic_ns());
+}
+
+void TransferTimer::record_chunk(long long bytes, uint64_t now_ns)
+{
+	if (chunks == 0)
+	{
+		first_ns = now_ns;
+	}
+	else
+	{
+		gaps.push_back(now_ns - last_ns);
+	}
+
+	last_ns = now_ns;
+	total_bytes += bytes;
+	chunks++;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		merge
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		merge(const TransferTimer &other)
+--						const TransferTimer &other: Timer of one part of the transfer (a connection)
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Adds the chunks recorded by another timer, so that connections timed on different threads can be reported as
+--	one transfer. The start of this timer is kept. The first and last bytes are the earliest and latest of both
+--	timers, and the gaps are the gaps within each connection.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferTimer::merge(const TransferTimer &other)
+{
+	if (other.chunks == 0)
+	{
+		return;
+	}
+
+	if (chunks == 0 || other.first_ns < first_ns)
+	{
+		first_ns = other.first_ns;
+	}
+	if (chunks == 0 || other.last_ns > last_ns)
+	{
+		last_ns = other.last_ns;
+	}
+
+	total_bytes += other.total_bytes;
+	chunks += other.chunks;
+	gaps.insert(gaps.end(), other.gaps.begin(), other.gaps.end());
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		elapsed_ms
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		elapsed_ms()
+--
+--	RETURNS:		double - time from the start to the last byte in ms.
+--
+--	NOTES:
+--	The total transfer time. Idle time after the last byte (such as the UDP idle timeout) is not included.
+----------------------------------------------------------------------------------------------------------------------*/
+double TransferTimer::elapsed_ms() const
+{
+	return (last_ns - start_ns) / 1e6;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		ttfb_ms
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		ttfb_ms()
+--
+--	RETURNS:		double - time from the start to the first byte in ms.
+--
+--	NOTES:
+--	Zero when the timer was started by the first chunk itself, as is the case for UDP.
+----------------------------------------------------------------------------------------------------------------------*/
+double TransferTimer::ttfb_ms() const
+{
+	return (chunks > 0) ? (first_ns - start_ns) / 1e6 : 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		throughput_mbps
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		throughput_mbps()
+--
+--	RETURNS:		double - throughput in Mbit/s, or 0 if the transfer took no measurable time.
+--
+--	NOTES:
+--	Computed over the total transfer time (start to last byte).
+----------------------------------------------------------------------------------------------------------------------*/
+double TransferTimer::throughput_mbps() const
+{
+	uint64_t elapsed_ns = last_ns - start_ns;
+
+	return (elapsed_ns > 0) ? (total_bytes * 8.0 * 1000.0) / elapsed_ns : 0;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		gap_percentile_us
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		gap_percentile_us(double percentile)
+--						double percentile: Percentile between 0 and 100
+--
+--	RETURNS:		double - the inter-arrival gap at the percentile in us, or 0 if there are no gaps.
+--
+--	NOTES:
+--	Uses the nearest-rank method on a copy of the recorded gaps, so the timer can keep recording afterwards.
+----------------------------------------------------------------------------------------------------------------------*/
+double TransferTimer::gap_percentile_us(double percentile) const
+{
+	if (gaps.empty())
+	{
+		return 0;
+	}
+
+	std::vector<uint64_t> sorted(gaps);
+	size_t rank = (size_t)(percentile / 100.0 * sorted.size());
+
+	if (rank >= sorted.size())
+	{
+		rank = sorted.size() - 1;
+	}
+	std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+
+	return sorted[rank] / 1e3;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Receives the timing statistics
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Copies the timing statistics into the result of a transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferTimer::report(TransferResult &result) const
+{
+	result.elapsed_ms = elapsed_ms();
+	result.ttfb_ms = ttfb_ms();
+	result.throughput_mbps = throughput_mbps();
+	result.gap_p50_us = gap_percentile_us(50);
+	result.gap_p99_us = gap_percentile_us(99);
+	result.gap_p999_us = gap_percentile_us(99.9);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the statistics are appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the timing statistics in the same format as the rest of the receive output.
+----------------------------------------------------------------------------------------------------------------------*/
+void TransferTimer::append_report(std::string &print_output) const
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nTotal Transfer Time: %.3f ms", elapsed_ms());
+	print_output += line;
+
+	if (first_ns > start_ns)
+	{
+		snprintf(line, sizeof(line), "\nTime to First Byte: %.3f ms", ttfb_ms());
+		print_output += line;
+	}
+
+	if (last_ns > start_ns)
+	{
+		snprintf(line, sizeof(line), "\nThroughput: %.2f Mbit/s", throughput_mbps());
+		print_output += line;
+	}
+
+	if (!gaps.empty())
+	{
+		snprintf(line, sizeof(line), "\nInter-arrival Gap p50/p99/p999: %.1f / %.1f / %.1f us",
+			gap_percentile_us(50), gap_percentile_us(99), gap_percentile_us(99.9));
+		print_output += line;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+#define GAP_RESERVE 4096
+
+// Nanoseconds on a monotonic clock (never goes backwards, never wraps)
+uint64_t monotonic_ns();
+
+class TransferTimer
+{
+	public:
+		TransferTimer() {};
+		~TransferTimer() {};
+		void start();
+		void start(uint64_t now_ns);
+		void record_chunk(long long bytes);
+		void record_chunk(long long bytes, uint64_t now_ns);
+		void merge(const TransferTimer &other);
+		bool has_data() const { return chunks > 0; };
+		double elapsed_ms() const;
+		double ttfb_ms() const;
+		double throughput_mbps() const;
+		double gap_percentile_us(double percentile) const;
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output) const;
+	private:
+		uint64_t start_ns = 0;
+		uint64_t first_ns = 0;
+		uint64_t last_ns = 0;
+		long long total_bytes = 0;
+		long long chunks = 0;
+		std::vector<uint64_t> gaps;
+};
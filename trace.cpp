@@ -0,0 +1,231 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	trace.cpp - Lock-free ring of per-packet trace events and its binary dump
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void enable(const std::string &path)
+--					bool dump()
+--					TraceRing &trace_ring()
+--					int trace_decode(const char *path)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The receive loops used to write debug strings on every read, building std::to_string temporaries on the hot path.
+--	With --trace the send and receive paths instead record one TraceEvent per system call (per datagram for the
+--	mmsg calls): the monotonic time, the sequence stamp of the datagram or else the number of the call, the size,
+--	the return value and errno. Without --trace record returns on its first test.
+--
+--	The ring holds the latest TRACE_CAPACITY events. A writer claims a slot with one relaxed atomic increment and
+--	fills it in place, so recording takes a few nanoseconds, never blocks and never allocates, and the SO_REUSEPORT
+--	and event loop threads can record concurrently. Once the ring is full the oldest events are overwritten.
+--
+--	The ring is written to the dump file (overwriting it) after every finished transfer, as a TraceHeader followed by
+--	the events from the oldest. A dump taken while another thread is still recording may contain a partly written
+--	event. "analyser trace file" decodes a dump into one line per event and a summary.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#include "trace.h"
+#include <map>
+#include <string.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		enable
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		enable(const std::string &path)
+--						const std::string &path: File the ring is dumped to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Allocates and prefaults the ring. Must be called before the transfer threads start.
+----------------------------------------------------------------------------------------------------------------------*/
+void TraceRing::enable(const std::string &path)
+{
+	dump_path = path;
+	events.assign(TRACE_CAPACITY, TraceEvent());
+	head.store(0, std::memory_order_relaxed);
+	mask = TRACE_CAPACITY - 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		dump
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		dump()
+--
+--	RETURNS:		bool - true if the ring was written, or tracing is off.
+--
+--	NOTES:
+--	Writes the events in the ring, from the oldest, to the dump file.
+----------------------------------------------------------------------------------------------------------------------*/
+bool TraceRing::dump()
+{
+	TraceHeader header;
+	uint64_t recorded = head.load(std::memory_order_acquire);
+	uint64_t first = (recorded > mask + 1) ? recorded - (mask + 1) : 0;
+	FILE *file;
+
+	if (mask == 0)
+	{
+		return true;
+	}
+
+	if ((file = fopen(dump_path.c_str(), "wb")) == NULL)
+	{
+		perror("Cannot open trace file");
+		return false;
+	}
+
+	header.magic = TRACE_MAGIC;
+	header.event_size = sizeof(TraceEvent);
+	header.recorded = recorded;
+	header.count = recorded - first;
+	fwrite(&header, sizeof(header), 1, file);
+
+	// The Ring Wraps at most once between first and recorded
+	uint64_t start = first & mask;
+	uint64_t tail = (header.count < mask + 1 - start) ? header.count : mask + 1 - start;
+	fwrite(&events[start], sizeof(TraceEvent), tail, file);
+	fwrite(&events[0], sizeof(TraceEvent), header.count - tail, file);
+
+	if (fclose(file) != 0)
+	{
+		perror("Cannot write trace file");
+		return false;
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		trace_ring
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		trace_ring()
+--
+--	RETURNS:		TraceRing & - the ring shared by the send and receive paths.
+----------------------------------------------------------------------------------------------------------------------*/
+TraceRing &trace_ring()
+{
+	static TraceRing ring;
+
+	return ring;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		trace_decode
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		trace_decode(const char *path)
+--						const char *path: Dump file written by TraceRing::dump
+--
+--	RETURNS:		int - 0 on success, 1 if the file cannot be read.
+--
+--	NOTES:
+--	Prints every event with its time since the first event and since the previous one, then the number of events
+--	of each kind and of each errno. A dump of a different event layout (or byte order) is rejected.
+----------------------------------------------------------------------------------------------------------------------*/
+int trace_decode(const char *path)
+{
+	static const char *kind_names[] = { "?", "send", "recv", "sendmmsg", "recvmmsg" };
+	const int num_kinds = (int)(sizeof(kind_names) / sizeof(kind_names[0]));
+	std::map<int, long long> kinds;
+	std::map<int, long long> errors;
+	TraceHeader header;
+	TraceEvent event;
+	uint64_t first_ns = 0;
+	uint64_t last_ns = 0;
+	uint64_t decoded = 0;
+	FILE *file;
+
+	if ((file = fopen(path, "rb")) == NULL)
+	{
+		perror("Cannot open trace file");
+		return 1;
+	}
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != TRACE_MAGIC
+		|| header.event_size != sizeof(TraceEvent))
+	{
+		fprintf(stderr, "%s is not a trace dump of this build\n", path);
+		fclose(file);
+		return 1;
+	}
+
+	printf("%12s %10s %-8s %10s %8s %8s %s\n", "time_us", "delta_us", "call", "seq", "size", "return", "errno");
+	while (decoded < header.count && fread(&event, sizeof(event), 1, file) == 1)
+	{
+		const char *kind = (event.kind < num_kinds) ? kind_names[event.kind] : "?";
+
+		if (decoded == 0)
+		{
+			first_ns = last_ns = event.ns;
+		}
+		printf("%12.3f %10.3f %-8s %10u %8u %8d %s\n", (event.ns - first_ns) / 1e3,
+			((int64_t)event.ns - (int64_t)last_ns) / 1e3, kind, event.seq, event.size, event.ret,
+			(event.error != 0) ? strerror(event.error) : "-");
+		last_ns = event.ns;
+		kinds[event.kind]++;
+		if (event.error != 0)
+		{
+			errors[event.error]++;
+		}
+		decoded++;
+	}
+	fclose(file);
+
+	// Summary
+	printf("\nEvents: %llu of %llu recorded (%llu overwritten)", (unsigned long long)decoded,
+		(unsigned long long)header.recorded, (unsigned long long)(header.recorded - header.count));
+	if (decoded > 0)
+	{
+		printf(" over %.3f ms", (last_ns - first_ns) / 1e6);
+	}
+	printf("\n");
+	for (const auto &count : kinds)
+	{
+		printf("%s: %lld\n", (count.first < num_kinds) ? kind_names[count.first] : "?", count.second);
+	}
+	for (const auto &count : errors)
+	{
+		printf("errno %d (%s): %lld\n", count.first, strerror(count.first), count.second);
+	}
+
+	return 0;
+}
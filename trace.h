@@ -0,0 +1,67 @@
+#pragma once
+
+#include "transport.h"
+#include "timing.h"
+#include <atomic>
+#include <stdint.h>
+
+#define TRACE_MAGIC 0x54524331
+#define TRACE_CAPACITY (1 << 18)
+
+// What a Trace Event Records
+enum TraceKind { TRACE_SEND = 1, TRACE_RECV, TRACE_SEND_BATCH, TRACE_RECV_BATCH };
+
+// One Traced System Call (or one Datagram of a Batch), 24 Bytes in the Dump File
+struct TraceEvent
+{
+	uint64_t ns;
+	uint32_t seq;
+	uint32_t size;
+	int32_t ret;
+	uint16_t error;
+	uint16_t kind;
+};
+
+// Header of the Dump File, followed by count Events from the Oldest (host byte order)
+struct TraceHeader
+{
+	uint32_t magic;
+	uint32_t event_size;
+	uint64_t recorded;
+	uint64_t count;
+};
+
+// Fixed Size Ring of the Latest Trace Events, Written by any Thread without a Lock
+class TraceRing
+{
+	public:
+		TraceRing() {};
+		~TraceRing() {};
+		void enable(const std::string &path);
+		bool enabled() const { return mask != 0; };
+		void record(int kind, uint32_t seq, uint32_t size, int32_t ret, int error)
+		{
+			if (mask == 0)
+			{
+				return;
+			}
+
+			TraceEvent &event = events[head.fetch_add(1, std::memory_order_relaxed) & mask];
+			event.ns = monotonic_ns();
+			event.seq = seq;
+			event.size = size;
+			event.ret = ret;
+			event.error = (uint16_t)error;
+			event.kind = (uint16_t)kind;
+		};
+		bool dump();
+	private:
+		std::vector<TraceEvent> events;
+		uint64_t mask = 0;
+		std::atomic<uint64_t> head{0};
+		std::string dump_path;
+};
+
+// Shared Trace Ring and its Offline Decoder (trace.cpp)
+TraceRing &trace_ring();
+int trace_decode(const char *path);
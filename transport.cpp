@@ -0,0 +1,220 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	transport.cpp - Socket helpers shared by the POSIX TCP and UDP backends
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					bool set_nonblocking(SOCKET sock)
+--					bool set_blocking(SOCKET sock)
+--					bool resolve_host(const char *host, int port, struct sockaddr_in &addr)
+--					bool wait_for_socket(SOCKET sock, short events, int timeout_ms)
+--					bool raise_file_limit(int needed)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The POSIX backend runs every socket in non-blocking mode. These helpers cover the small pieces of WinSock
+--	behaviour that the BSD socket API does not provide directly: switching a socket to non-blocking mode, resolving
+--	a host into an address structure, and waiting for a socket to become readable or writable.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "transport.h"
+#include <sys/resource.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		set_nonblocking
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		set_nonblocking(SOCKET sock)
+--						SOCKET sock: The socket to modify
+--
+--	RETURNS:		bool - true on success.
+--
+--	NOTES:
+--	Puts the socket into non-blocking mode so that reads and writes return EAGAIN instead of blocking the caller.
+----------------------------------------------------------------------------------------------------------------------*/
+bool set_nonblocking(SOCKET sock)
+{
+	int flags;
+
+	if ((flags = fcntl(sock, F_GETFL, 0)) == -1)
+	{
+		return false;
+	}
+
+	return fcntl(sock, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		set_blocking
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		set_blocking(SOCKET sock)
+--						SOCKET sock: The socket to modify
+--
+--	RETURNS:		bool - true on success.
+--
+--	NOTES:
+--	Puts the socket back into blocking mode. The io_uring engine sends on blocking sockets so that the kernel waits
+--	for buffer space instead of completing writes with EAGAIN.
+----------------------------------------------------------------------------------------------------------------------*/
+bool set_blocking(SOCKET sock)
+{
+	int flags;
+
+	if ((flags = fcntl(sock, F_GETFL, 0)) == -1)
+	{
+		return false;
+	}
+
+	return fcntl(sock, F_SETFL, flags & ~O_NONBLOCK) != -1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		resolve_host
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		resolve_host(const char *host, int port, struct sockaddr_in &addr)
+--						const char *host: Host name or IP
+--						int port: The Port the server is listening on
+--						struct sockaddr_in &addr: Address structure to fill in
+--
+--	RETURNS:		bool - true if the host was resolved.
+--
+--	NOTES:
+--	Resolves an IPv4 address for the host. getaddrinfo is used instead of gethostbyname because the benchmark
+--	runner resolves hosts while the server side is running on another thread.
+----------------------------------------------------------------------------------------------------------------------*/
+bool resolve_host(const char *host, int port, struct sockaddr_in &addr)
+{
+	struct addrinfo hints;
+	struct addrinfo *result;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+
+	if (getaddrinfo(host, NULL, &hints, &result) != 0)
+	{
+		return false;
+	}
+
+	// Copy the server address
+	memcpy(&addr, result->ai_addr, sizeof(struct sockaddr_in));
+	addr.sin_port = htons(port);
+	freeaddrinfo(result);
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		wait_for_socket
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		wait_for_socket(SOCKET sock, short events, int timeout_ms)
+--						SOCKET sock: The socket to wait on
+--						short events: poll() events (POLLIN/POLLOUT)
+--						int timeout_ms: Maximum time to wait
+--
+--	RETURNS:		bool - true if the socket became ready before the timeout.
+--
+--	NOTES:
+--	Used by the client side when a non-blocking connect or send returns EINPROGRESS/EAGAIN. Interrupted waits are
+--	restarted.
+----------------------------------------------------------------------------------------------------------------------*/
+bool wait_for_socket(SOCKET sock, short events, int timeout_ms)
+{
+	struct pollfd pfd;
+	int result;
+
+	pfd.fd = sock;
+	pfd.events = events;
+	pfd.revents = 0;
+
+	do
+	{
+		result = poll(&pfd, 1, timeout_ms);
+	} while (result == -1 && errno == EINTR);
+
+	return result > 0 && (pfd.revents & (events | POLLERR | POLLHUP));
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		raise_file_limit
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		raise_file_limit(int needed)
+--						int needed: Number of descriptors the process needs open at once
+--
+--	RETURNS:		bool - true if the soft limit allows the descriptors.
+--
+--	NOTES:
+--	Thousands of streams need more descriptors than the usual soft limit of 1024. The soft limit is raised as far as
+--	the hard limit allows.
+----------------------------------------------------------------------------------------------------------------------*/
+bool raise_file_limit(int needed)
+{
+	struct rlimit limit;
+
+	if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+	{
+		perror("getrlimit() failed");
+		return false;
+	}
+	if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < (rlim_t)needed)
+	{
+		limit.rlim_cur = (limit.rlim_max != RLIM_INFINITY && limit.rlim_max < (rlim_t)needed) ? limit.rlim_max : needed;
+		if (setrlimit(RLIMIT_NOFILE, &limit) == -1 || limit.rlim_cur < (rlim_t)needed)
+		{
+			fprintf(stderr, "Only %llu descriptors can be open, %d are needed\n", (unsigned long long)limit.rlim_cur,
+				needed);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -1,18 +1,177 @@
 #pragma once
 
+#ifdef _WIN32
 #pragma warning(disable : 4996)
 #pragma warning(disable : 4096)
 
 #include <WinSock2.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
 #include <vector>
 
 #define EOT (char)17
-#define WM_SOCKET (WM_USER + 1)
 #define BUFFERSIZE 128
 #define RECVBUFSIZE 1000000
 #define PORT 5150
 #define PACKETSIZE 1024
 #define NUMPACKETS 10
+#define UDP_DATAGRAM_MAX 65536
+#define UDP_MAX_BATCH 1024
+#define UDP_MAX_SEGMENTS 64
+#define URING_MAX_DEPTH 256
+#define ZEROCOPY_MAX_DEPTH 4096
+#define TCP_MAX_STREAMS 4096
+#define SERVER_MAX_LOOPS 64
+#define RUDP_MAX_WINDOW 4096
+#define LATENCY_MAX_CONCURRENCY 4096
+#define PACE_MAX_BURST 1024
+
+// Enum Definition
+enum Protocol { TCP_PROTOCOL, UDP_PROTOCOL };
+enum PayloadMode { PAYLOAD_PATTERN, PAYLOAD_SIMD, PAYLOAD_RANDOM, PAYLOAD_ZERO, PAYLOAD_FILE };
+enum SinkMode { SINK_BUFFERED, SINK_MMAP, SINK_DIRECT };
+enum OutputFormat { FORMAT_TEXT, FORMAT_JSON, FORMAT_CSV };
+
+// Socket Options Requested by a Tuning Profile (0, -1 or empty leave the OS default)
+struct SocketTuning
+{
+	std::string profile = "default";
+	int sndbuf = 0;
+	int rcvbuf = 0;
+	int nodelay = -1;
+	int cork = -1;
+	int notsent_lowat = 0;
+	int busy_poll = 0;
+	std::string congestion;
+};
+
+// Socket Options in Effect, as Read back from the Kernel (-1 or empty if not read)
+struct SocketSettings
+{
+	std::string profile;
+	int sndbuf = -1;
+	int rcvbuf = -1;
+	int nodelay = -1;
+	int cork = -1;
+	int notsent_lowat = -1;
+	int busy_poll = -1;
+	std::string congestion;
+};
+
+// Options of a Transfer (set on the TCP and UDP classes before sending or receiving)
+struct TransferOptions
+{
+	PayloadMode payload = PAYLOAD_PATTERN;
+	std::string payload_file;
+	bool hugepages = false;
+	int batch_size = 1;
+	int gso_size = 0;
+	std::string send_file;
+	std::string save_file;
+	SinkMode sink = SINK_BUFFERED;
+	int uring_depth = 0;
+	int zerocopy_depth = 0;
+	int streams = 1;
+	int server_loops = 0;
+	int reuseport = 0;
+	int reliable_window = 0;
+	bool stamp = false;
+	bool timestamps = false;
+	bool frame = false;
+	bool verify = false;
+	bool echo = false;
+	int concurrency = 1;
+	int request_rate = 0;
+	double pace_bps = 0;
+	double pace_pps = 0;
+	int burst = 1;
+	double ramp_loss = 0;
+	std::string trace_file;
+	OutputFormat format = FORMAT_TEXT;
+	std::string history_file;
+	SocketTuning tuning;
+};
+
+// Statistics of the Last Transfer (client or server side)
+struct TransferResult
+{
+	long long total_bytes = 0;
+	long long packets = 0;
+	long long segments = 0;
+	double elapsed_ms = 0;
+	double ttfb_ms = 0;
+	double throughput_mbps = 0;
+	double gap_p50_us = 0;
+	double gap_p99_us = 0;
+	double gap_p999_us = 0;
+	double touched_per_byte = 0;
+	double datagrams_per_call = 0;
+	double disk_ms = 0;
+	double disk_mbps = 0;
+	long long syscalls = 0;
+	long long pace_waits = 0;
+	long long datagrams_lost = 0;
+	long long datagrams_reordered = 0;
+	long long datagrams_duplicated = 0;
+	double loss_rate = 0;
+	double jitter_us = 0;
+	double rtt_p50_us = 0;
+	double rtt_p99_us = 0;
+	double rtt_p999_us = 0;
+	double rtt_max_us = 0;
+	double one_way_p50_us = 0;
+	double one_way_p99_us = 0;
+	double send_stack_p50_us = 0;
+	double network_p50_us = 0;
+	double recv_stack_p50_us = 0;
+	int streams = 1;
+	long long zerocopy_completions = 0;
+	long long copied_completions = 0;
+	long long frames = 0;
+	long long frame_errors = 0;
+	long long crc_errors = 0;
+	double verify_ms = 0;
+	SocketSettings socket;
+};
+
+#ifdef _WIN32
+#define WM_SOCKET (WM_USER + 1)
+#else
+// BSD Socket Equivalents of the WinSock Types
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#define closesocket(s) close(s)
+
+// Socket Wait Timeouts (ms)
+#define CONNECT_TIMEOUT 5000
+#define SEND_TIMEOUT 5000
+#define UDP_IDLE_TIMEOUT 1000
+#define LATENCY_TIMEOUT 1000
+#define REPORT_TIMEOUT 2500
+
+// Descriptors Kept Free besides the Connections when Raising the Limit
+#define FILE_LIMIT_SPARE 64
+
+// Socket Helpers (transport.cpp)
+bool set_nonblocking(SOCKET sock);
+bool set_blocking(SOCKET sock);
+bool resolve_host(const char *host, int port, struct sockaddr_in &addr);
+bool wait_for_socket(SOCKET sock, short events, int timeout_ms);
+bool raise_file_limit(int needed);
+#endif
@@ -0,0 +1,226 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	tuning.cpp - Socket tuning profiles applied to the Client and Server sockets
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void apply_tuning(SOCKET sock, const SocketTuning &tuning, bool stream)
+--					SocketSettings read_settings(SOCKET sock, const SocketTuning &tuning, bool stream)
+--					void append_settings(std::string &print_output, const SocketSettings &settings)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The sockets used to be created with the OS defaults. A tuning profile (--profile, see options.cpp) and the
+--	single option overrides set the socket buffer sizes, TCP_NODELAY, TCP_CORK, TCP_NOTSENT_LOWAT, the congestion
+--	control algorithm and SO_BUSY_POLL. The TCP options only apply to stream sockets.
+--
+--	The kernel does not always do what was asked: the buffer sizes are doubled for its bookkeeping and capped by
+--	net.core.wmem_max/rmem_max, and an algorithm must be in net.ipv4.tcp_allowed_congestion_control. A setting the
+--	kernel refuses is reported and the transfer goes on. After setting them, the effective values are read back into
+--	the SocketSettings of the transfer, which is printed with the statistics and written to its run record.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "tuning.h"
+
+#define CONGESTION_NAME_MAX 16
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		set_option
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		set_option(SOCKET sock, int level, int name, int value, const char *label)
+--						SOCKET sock: Socket to tune
+--						int level: Protocol level of the option
+--						int name: Option
+--						int value: Requested value
+--						const char *label: Name of the option in the error message
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+static void set_option(SOCKET sock, int level, int name, int value, const char *label)
+{
+	if (setsockopt(sock, level, name, &value, sizeof(value)) == -1)
+	{
+		fprintf(stderr, "setsockopt(%s, %d) failed: %s\n", label, value, strerror(errno));
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		get_option
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		get_option(SOCKET sock, int level, int name)
+--						SOCKET sock: Tuned socket
+--						int level: Protocol level of the option
+--						int name: Option
+--
+--	RETURNS:		int - the value in effect, or -1 if it cannot be read.
+----------------------------------------------------------------------------------------------------------------------*/
+static int get_option(SOCKET sock, int level, int name)
+{
+	int value;
+	socklen_t value_len = sizeof(value);
+
+	if (getsockopt(sock, level, name, &value, &value_len) == -1)
+	{
+		return -1;
+	}
+	return value;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		apply_tuning
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		apply_tuning(SOCKET sock, const SocketTuning &tuning, bool stream)
+--						SOCKET sock: Socket to tune
+--						const SocketTuning &tuning: Requested options
+--						bool stream: The socket is a TCP socket
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sets the options the tuning asks for and leaves the others at their defaults. The buffer sizes must be set before
+--	connect or listen to size the TCP window scale, so the sockets are tuned right after they are created.
+----------------------------------------------------------------------------------------------------------------------*/
+void apply_tuning(SOCKET sock, const SocketTuning &tuning, bool stream)
+{
+	if (tuning.sndbuf > 0)
+		set_option(sock, SOL_SOCKET, SO_SNDBUF, tuning.sndbuf, "SO_SNDBUF");
+	if (tuning.rcvbuf > 0)
+		set_option(sock, SOL_SOCKET, SO_RCVBUF, tuning.rcvbuf, "SO_RCVBUF");
+	if (tuning.busy_poll > 0)
+		set_option(sock, SOL_SOCKET, SO_BUSY_POLL, tuning.busy_poll, "SO_BUSY_POLL");
+
+	if (!stream)
+	{
+		return;
+	}
+
+	if (tuning.nodelay >= 0)
+		set_option(sock, IPPROTO_TCP, TCP_NODELAY, tuning.nodelay, "TCP_NODELAY");
+	if (tuning.cork >= 0)
+		set_option(sock, IPPROTO_TCP, TCP_CORK, tuning.cork, "TCP_CORK");
+	if (tuning.notsent_lowat > 0)
+		set_option(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, tuning.notsent_lowat, "TCP_NOTSENT_LOWAT");
+	if (!tuning.congestion.empty() && setsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, tuning.congestion.c_str(),
+		(socklen_t)tuning.congestion.size()) == -1)
+	{
+		fprintf(stderr, "setsockopt(TCP_CONGESTION, %s) failed: %s\n", tuning.congestion.c_str(), strerror(errno));
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		read_settings
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		read_settings(SOCKET sock, const SocketTuning &tuning, bool stream)
+--						SOCKET sock: Tuned socket
+--						const SocketTuning &tuning: Requested options (for the name of the profile)
+--						bool stream: The socket is a TCP socket
+--
+--	RETURNS:		SocketSettings - the options in effect on the socket.
+--
+--	NOTES:
+--	Reads every option back, whether it was set or not, so the defaults are recorded as well.
+----------------------------------------------------------------------------------------------------------------------*/
+SocketSettings read_settings(SOCKET sock, const SocketTuning &tuning, bool stream)
+{
+	SocketSettings settings;
+	char congestion[CONGESTION_NAME_MAX];
+	socklen_t congestion_len = sizeof(congestion);
+
+	settings.profile = tuning.profile;
+	settings.sndbuf = get_option(sock, SOL_SOCKET, SO_SNDBUF);
+	settings.rcvbuf = get_option(sock, SOL_SOCKET, SO_RCVBUF);
+	settings.busy_poll = get_option(sock, SOL_SOCKET, SO_BUSY_POLL);
+
+	if (stream)
+	{
+		settings.nodelay = get_option(sock, IPPROTO_TCP, TCP_NODELAY);
+		settings.cork = get_option(sock, IPPROTO_TCP, TCP_CORK);
+		settings.notsent_lowat = get_option(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT);
+		if (getsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, congestion, &congestion_len) == 0)
+		{
+			settings.congestion.assign(congestion, strnlen(congestion, congestion_len));
+		}
+	}
+
+	return settings;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_settings
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_settings(std::string &print_output, const SocketSettings &settings)
+--						std::string &print_output: Output string the settings are appended to
+--						const SocketSettings &settings: Options in effect on the socket
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void append_settings(std::string &print_output, const SocketSettings &settings)
+{
+	char line[BUFFERSIZE];
+
+	if (settings.sndbuf < 0)
+	{
+		return;
+	}
+
+	snprintf(line, sizeof(line), "\nSocket Profile: %s (SO_SNDBUF %d, SO_RCVBUF %d, SO_BUSY_POLL %d)",
+		settings.profile.c_str(), settings.sndbuf, settings.rcvbuf, settings.busy_poll);
+	print_output += line;
+	if (settings.nodelay >= 0)
+	{
+		snprintf(line, sizeof(line), "\nTCP Options: TCP_NODELAY %d, TCP_CORK %d, TCP_NOTSENT_LOWAT %d, congestion %s",
+			settings.nodelay, settings.cork, settings.notsent_lowat, settings.congestion.c_str());
+		print_output += line;
+	}
+}
+
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "transport.h"
+
+// Socket Tuning (tuning.cpp)
+void apply_tuning(SOCKET sock, const SocketTuning &tuning, bool stream);
+SocketSettings read_settings(SOCKET sock, const SocketTuning &tuning, bool stream);
+void append_settings(std::string &print_output, const SocketSettings &settings);
@@ -26,6 +26,9 @@
 ----------------------------------------------------------------------------------------------------------------------*/
 
 #include "udp.h"
+#include "timing.h"
+#include "recv_pool.h"
+#include "payload.h"
 
 // Global Connection Socket
 SOCKET udp_sock;
@@ -94,7 +97,9 @@ void UDP::start_server(int port, HWND hwnd)
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Record TransferResult]
+--					October 16, 2026 [Send read-only views of a prepared Payload]
+--					October 16, 2026 [Reuse one event and wait for each overlapped send to complete]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -116,21 +121,30 @@ void UDP::start_server(int port, HWND hwnd)
 std::string UDP::send_packet(char * host, int port, int packet_size, int num_packet)
 {
 	SOCKET data_sock;
-	INT result;
+	INT wsa_result;
 	DWORD sent_bytes;
+	DWORD flags;
 	DWORD total_bytes = 0;
 	struct	hostent	*hp;
 	struct	sockaddr_in server;
 	WSAOVERLAPPED overlapped;
 	WSABUF data_buf;
-	char *packet_buf;
+	Payload payload;
 	WSADATA wsaData;
 	std::string print_output;
 
+	result = TransferResult();
+
+	// Generate the Data, with the EOT Marker at the End of the Last Datagram
+	if (!payload.prepare(options, packet_size, num_packet, true))
+	{
+		return "Error payload";
+	}
+
 	// Open up a Winsock Session
-	if ((result = WSAStartup(0x0202, &wsaData)) != 0)
+	if ((wsa_result = WSAStartup(0x0202, &wsaData)) != 0)
 	{
-		perror("WSAStartup failed with error %d\n" + result);
+		perror("WSAStartup failed with error %d\n" + wsa_result);
 		WSACleanup();
 		return "Error WSAStartup()";
 	}
@@ -157,34 +171,41 @@ std::string UDP::send_packet(char * host, int port, int packet_size, int num_pac
 	// Copy the server address
 	memcpy((char *)&server.sin_addr, hp->h_addr, hp->h_length);
 
-	// Allocate Single Packet Buffer
-	packet_buf = (char *)malloc(packet_size * sizeof(char));
+	// Create WSA Event for Asynchronous I/O, Reused by every Send
+	memset(&overlapped, 0, sizeof(overlapped));
+	if ((overlapped.hEvent = WSACreateEvent()) == WSA_INVALID_EVENT) {
+		perror("WSACreateEvent failed");
+		closesocket(data_sock);
+		WSACleanup();
+		return "Error WSACreateEvent()";
+	}
 
-	// Create and Send Packets
+	// Send Packets
 	for (int i = 0; i < num_packet; i++) {
-		int k = 0;
-		for (int j = 0; j < packet_size; j++) {
-			// Insert characters from A-Z
-			k = (j < 26) ? j : j % 26;
-			packet_buf[j] = 'A' + k;
-		}
-		if (i == num_packet - 1)
-			packet_buf[num_packet - 1] = EOT;
-
-		data_buf.buf = packet_buf;
+		data_buf.buf = (char *)payload.packet(i);
 		data_buf.len = packet_size;
 
+		// Send and wait for the send to complete
 		if (WSASendTo(data_sock, &data_buf, 1, &sent_bytes, 0, (PSOCKADDR)&server, sizeof(server), &overlapped, NULL) == SOCKET_ERROR) {
-			DWORD errorCode = WSAGetLastError();
-			if (errorCode != ERROR_IO_PENDING) {
-				WaitForMultipleObjects(1, &overlapped.hEvent, true, 1000);
+			if (WSAGetLastError() != WSA_IO_PENDING
+				|| !WSAGetOverlappedResult(data_sock, &overlapped, &sent_bytes, TRUE, &flags))
+			{
+				perror("WSASendTo() failed");
+				break;
 			}
 		}
-		overlapped.hEvent = WSACreateEvent();
+		total_bytes += sent_bytes;
+		WSAResetEvent(overlapped.hEvent);
 	}
 
+	WSACloseEvent(overlapped.hEvent);
+	closesocket(data_sock);
 	WSACleanup();
 
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = num_packet;
+
 	// Append Data Information to print_output
 	print_output += "[UDP CLIENT]";
 	print_output += "\nHost: ";
@@ -196,8 +217,10 @@ std::string UDP::send_packet(char * host, int port, int packet_size, int num_pac
 	print_output += " Bytes";
 	print_output += "\nNumber of Packets: ";
 	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
 	print_output += "\nTotal Data Transferred: ";
-	print_output += std::to_string(sent_bytes * num_packet);
+	print_output += std::to_string(total_bytes);
 	print_output += " Bytes";
 
 	return print_output;
@@ -208,7 +231,10 @@ std::string UDP::send_packet(char * host, int port, int packet_size, int num_pac
 --
 --	DATE:			February 6, 2019
 --
---	REVISIONS:	    (Date and Description)
+--	REVISIONS:	    October 16, 2026 [Record TransferResult]
+--					October 16, 2026 [Monotonic TransferTimer instead of GetSystemTime]
+--					October 16, 2026 [Reuse pooled receive buffers]
+--					October 17, 2026 [Check the receive buffer for NULL]
 --
 --	DESIGNER:		Viktor Alvar
 --
@@ -227,10 +253,9 @@ std::string UDP::send_packet(char * host, int port, int packet_size, int num_pac
 ----------------------------------------------------------------------------------------------------------------------*/
 void UDP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 {
-	char packet_buf[RECVBUFSIZE];
+	RecvBufferPool &pool = recv_pool();
+	RecvPoolStats pool_start = pool.stats();
 	WSABUF data_buf;
-	data_buf.len = RECVBUFSIZE;
-	data_buf.buf = packet_buf;
 	DWORD received_bytes;
 	SOCKADDR source_addr;
 	int source_addr_len = sizeof(SOCKADDR);
@@ -238,12 +263,17 @@ void UDP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 	int timeout = 0;
 	int packets_recvd = 0;
 	DWORD flags = 0;
-	SYSTEMTIME sys_time;
+	TransferTimer recv_timer;
 	std::string print_output;
 
+	data_buf.len = (ULONG)pool.buffer_size();
+	if ((data_buf.buf = pool.acquire()) == NULL)
+	{
+		return;
+	}
+
 	// Start Timer
-	GetSystemTime(&sys_time);
-	WORD start_millis = (sys_time.wSecond * 1000) + sys_time.wMilliseconds;
+	recv_timer.start();
 
 	// Receive Data from Socket
 	do
@@ -269,30 +299,35 @@ void UDP::receive_packet(int port, WPARAM wParam, std::string &print_string)
 		}
 		else {
 			timeout = 0;
+			recv_timer.record_chunk(received_bytes);
 			total_bytes += received_bytes;
 			packets_recvd++;
+			pool.record_received(received_bytes);
 		}
 	} while (true);
 
+	pool.release(data_buf.buf);
+
 	if (total_bytes == 0)
 	{
 		return;
 	}
 
-	// Stop Timer
-	GetSystemTime(&sys_time);
-	DWORD end_millis = (sys_time.wSecond * 1000) + sys_time.wMilliseconds;
+	// Record Server Statistics
+	result.total_bytes = total_bytes;
+	result.packets = packets_recvd;
+	recv_timer.report(result);
+	pool.report(result, pool_start);
 
 	// Append Received Data Statistics to print_output
 	print_output += "[UDP SERVER]";
-	print_output += "\nTotal Transfer Time: ";
-	print_output += std::to_string(end_millis - start_millis);
-	print_output += " ms";
+	recv_timer.append_report(print_output);
 	print_output += "\nTotal Data Transferred: ";
 	print_output += std::to_string(total_bytes);
 	print_output += " Bytes";
 	print_output += "\nNumber of Packets Received: ";
 	print_output += std::to_string(packets_recvd);
+	pool.append_report(print_output, pool_start);
 
 	print_string = print_output;
 }
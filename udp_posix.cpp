@@ -0,0 +1,2587 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	udp_posix.cpp - UDP Protocol operations for POSIX systems. Operations for both Client and Server
+--								side are included in this source file
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					void start_server(int port, EventLoop &loop)
+--					std::string send_packet(char *host, int port, int packet_size, int num_packet)
+--					std::string ramp_rate(char *host, int port, int packet_size, int num_packet)
+--					std::string send_reliable(char *host, int port, int packet_size, int num_packet)
+--					void receive_packet(int port, SOCKET sock, std::string &print_string)
+--					void receive_batch(SOCKET sock, std::string &print_string)
+--					void check_timeout(std::string &print_string)
+--					std::string measure_latency(char *host, int port, int packet_size, int num_request)
+--					void end_connection()
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The POSIX backend of the UDP class. It has the same operations as udp.cpp, but is built on non-blocking BSD
+--	sockets and the epoll EventLoop. A transfer ends when the datagram carrying the EOT marker in its last byte
+--	arrives, or when no datagram has arrived for UDP_IDLE_TIMEOUT ms (check_timeout is called on EVENT_IDLE).
+--
+--	With a batch size above 1 (--batch), the Client sends up to that many datagrams per sendmmsg call and the Server
+--	receives up to that many per recvmmsg call. Both sides report the average number of datagrams each call handled.
+--
+--	With a segment size (--gso), the Client hands the kernel each packet as one buffer with UDP_SEGMENT set, and the
+--	kernel sends it as a train of segments of that size instead of one IP-fragmented datagram. The Server enables
+--	UDP_GRO, so consecutive segments may be coalesced back into one buffer; the segment size is read from the control
+--	message of each receive and the number of segments in the buffer is counted.
+--
+--	With a queue depth (--uring), the Client connects its socket and keeps that many datagram writes in flight
+--	through an io_uring ring, and the Server receives with windows of queued reads (see uring.cpp). The Server only
+--	uses the ring without GRO, since a plain read does not return the segment size control message.
+--
+--	With a socket count (--reuseport), the Server binds that many sockets to the port with SO_REUSEPORT, and each is
+--	drained with recvmmsg by its own thread pinned to its own core. Every socket records its datagrams into its own
+--	part of the transfer, and hands the finished part to the main thread through a single-slot mailbox released with
+--	an atomic flag, so the receive path takes no lock. The main thread merges the parts into one report. The
+--	io_uring engine is not used with --reuseport.
+--
+--	With a window (--reliable), both sides speak the reliable UDP protocol of rudp.cpp: sequence numbered datagrams,
+--	acknowledgements with a selective bitmap sent by the Server, retransmission by the Client, and a FIN exchange
+--	that ends the transfer. The Server reports the goodput, counting every datagram once.
+--
+--	With --stamp, the Client puts a sequence stamp at the start of every datagram (see sequence.cpp) and the Server
+--	reports the loss, reordering, duplication and jitter of the stamped datagrams of a transfer. Every Client numbers
+--	its stamps from 0, so the Server keeps a SequenceStats per source address and port and merges them when the
+--	transfer ends: several Clients in one transfer add up their losses instead of reordering each other. Each source
+--	sizes its received bitmap (a std::vector<bool>) from the datagram total of its stamps, at most
+--	SEQUENCE_MAX_DATAGRAMS, so a source costs up to 32 MB. The io_uring engine does not see the source addresses and
+--	records every stamp into one SequenceStats, and the --reuseport sockets keep one per socket. Packets sent with
+--	--gso or through io_uring are not stamped. At the end of a stamped transfer the Server sends a loss report to the
+--	last source (except with the io_uring engine), and the Client prints it.
+--
+--	With a target rate (--bitrate or --pps) the Client paces its sends with a TokenBucket (see pacing.cpp); a batch
+--	is then at most one burst, and io_uring is not used. With --ramp X the Client runs paced, stamped steps and
+--	searches the highest rate at which the Server loses at most X percent of the datagrams (ramp_rate).
+--
+--	With --echo the Server sends every datagram back to its source, for the udp-latency mode of the Client
+--	(measure_latency). The echo Server receives with recvmsg on one socket.
+--
+--	With --timestamps the Client sends stamped datagrams one per call with kernel TX timestamps, which later
+--	datagrams carry to the Server, and the Server reads the kernel RX timestamp of every datagram with recvmsg on
+--	one socket and splits the one-way delay into sender stack, network and receiver delay (see timestamp.cpp).
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "udp.h"
+#include "timing.h"
+#include "recv_pool.h"
+#include "payload.h"
+#include "uring.h"
+#include "loop_shards.h"
+#include "rudp.h"
+#include "sequence.h"
+#include "latency.h"
+#include "pacing.h"
+#include "trace.h"
+#include "tuning.h"
+#include "timestamp.h"
+#include "coro.h"
+#include <netinet/udp.h>
+#include <sys/eventfd.h>
+#include <set>
+#include <map>
+
+// Space for the UDP_GRO Control Message of one Receive
+#define GRO_CONTROL_SIZE CMSG_SPACE(sizeof(int))
+
+// Global Connection Socket
+SOCKET udp_sock = INVALID_SOCKET;
+
+// Receive State of the Transfer in Progress
+static bool receiving = false;
+static long long recv_total_bytes = 0;
+static int packets_recvd = 0;
+static long long segments_recvd = 0;
+static bool gro_enabled = false;
+static long long recv_calls = 0;
+static int recv_batch_max = 0;
+static uint64_t recv_last = 0;
+static TransferTimer recv_timer;
+static RecvPoolStats recv_pool_start;
+static SocketSettings recv_settings;
+static long long recv_syscalls = 0;
+static long long recv_syscalls_start = 0;
+static SequenceStats recv_sequence;
+static std::map<uint64_t, SequenceStats> recv_sources;
+static bool rx_timestamps = false;
+static OneWayDelay recv_delay;
+static struct sockaddr_in recv_source;
+
+// io_uring Engine of the Server
+static IoUring recv_ring;
+static std::vector<char *> recv_ring_buffers;
+static std::vector<char *> recv_slots;
+
+// Reliable UDP Session of the Server
+static RudpReceiver rudp_receiver;
+static struct sockaddr_in rudp_client;
+static bool reliable_transfer = false;
+static uint32_t rudp_finished_session = 0;
+
+// Datagrams Received by one SO_REUSEPORT Socket during a Transfer
+struct ShardPart
+{
+	int shard = 0;
+	uint64_t start_ns = 0;
+	long long bytes = 0;
+	long long packets = 0;
+	long long segments = 0;
+	long long calls = 0;
+	long long syscalls = 0;
+	int batch_max = 0;
+	TransferTimer timer;
+	SequenceStats sequence;
+	struct sockaddr_in source;
+};
+
+// SO_REUSEPORT Socket of the Server, Received on by its own Thread
+struct UdpShard
+{
+	SOCKET sock = INVALID_SOCKET;
+	int index = 0;
+	bool active = false;
+	uint64_t last_ns = 0;
+	long long syscalls = 0;
+	long long syscalls_start = 0;
+	std::set<uint64_t> sources;
+	ShardPart part;
+	std::vector<char *> buffers;
+	std::vector<struct iovec> iovecs;
+	std::vector<struct mmsghdr> msgs;
+	std::vector<struct sockaddr_in> addrs;
+	std::vector<char> controls;
+
+	// Finished Part, Handed to the Main Thread without a Lock (one producer, one consumer)
+	ShardPart finished;
+	std::atomic<bool> finished_ready{false};
+};
+
+// Receive Sockets of the Server with --reuseport
+static std::vector<std::unique_ptr<UdpShard>> udp_shards;
+static LoopShards shard_loops;
+static std::atomic<int> active_shards(0);
+static int shard_notify = -1;
+static std::vector<ShardPart> shard_parts;
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_batch_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_batch_report(std::string &print_output, double per_call, int max_per_call)
+--						std::string &print_output: Output string the statistics are appended to
+--						double per_call: Average number of datagrams per system call
+--						int max_per_call: Largest number of datagrams handled by one system call
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the batching statistics of a transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+static void append_batch_report(std::string &print_output, double per_call, int max_per_call)
+{
+	char line[BUFFERSIZE];
+
+	snprintf(line, sizeof(line), "\nDatagrams per Call: %.2f (max %d)", per_call, max_per_call);
+	print_output += line;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		recv_syscall_count
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		recv_syscall_count()
+--
+--	RETURNS:		long long - the number of receive system calls made by the Server so far.
+--
+--	NOTES:
+--	Counts the socket receive calls and the io_uring_enter calls of the ring. A transfer reports the difference
+--	between its end and its start.
+----------------------------------------------------------------------------------------------------------------------*/
+static long long recv_syscall_count()
+{
+	return recv_syscalls + recv_ring.enter_calls();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_shard_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_shard_report(std::string &print_output)
+--						std::string &print_output: Output string the statistics are appended to
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Appends the number of datagrams and bytes every SO_REUSEPORT socket received during the transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+static void append_shard_report(std::string &print_output)
+{
+	std::vector<long long> packets(udp_shards.size(), 0);
+	std::vector<long long> bytes(udp_shards.size(), 0);
+	char line[BUFFERSIZE];
+
+	for (const ShardPart &part : shard_parts)
+	{
+		packets[part.shard] += part.packets;
+		bytes[part.shard] += part.bytes;
+	}
+
+	print_output += "\nReceive Sockets (SO_REUSEPORT): ";
+	print_output += std::to_string(udp_shards.size());
+	for (size_t i = 0; i < udp_shards.size(); i++)
+	{
+		snprintf(line, sizeof(line), "\nSocket %d: %lld Datagrams, %lld Bytes", (int)i + 1, packets[i], bytes[i]);
+		print_output += line;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_loss_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_loss_report()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sends the SequenceReport of a stamped transfer to the source of its last datagram, from the Server's socket (or
+--	its first SO_REUSEPORT socket). Nothing is sent for the io_uring engine, which does not see the sources.
+----------------------------------------------------------------------------------------------------------------------*/
+static void send_loss_report()
+{
+	SequenceReport report;
+	SOCKET sock = (udp_sock != INVALID_SOCKET) ? udp_sock : udp_shards.empty() ? INVALID_SOCKET : udp_shards[0]->sock;
+
+	if (sock == INVALID_SOCKET || recv_source.sin_port == 0 || recv_ring.is_ready())
+	{
+		return;
+	}
+
+	recv_sequence.build_report(report);
+	if (sendto(sock, &report, sizeof(report), 0, (struct sockaddr *)&recv_source, sizeof(recv_source)) == -1)
+	{
+		perror("sendto() failed");
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		finish_transfer
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Report datagrams per call]
+--					October 16, 2026 [Report GRO segments]
+--					October 16, 2026 [Report system calls]
+--					October 16, 2026 [Report the SO_REUSEPORT sockets]
+--					October 16, 2026 [Report the reliable UDP session]
+--					October 16, 2026 [Report loss, reordering, duplication and jitter]
+--					October 16, 2026 [Send the loss report of stamped transfers]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 16, 2026 [Kernel timestamps with --timestamps]
+--					October 17, 2026 [Merge the sequence statistics of the sources]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		finish_transfer(TransferResult &result, std::string &print_string)
+--						TransferResult &result: Set to the transfer statistics
+--						std::string &print_string: Set to the printable transfer statistics
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Ends the transfer in progress and writes the received data statistics to print_string. The transfer time is
+--	measured up to the last datagram received, so the idle timeout is not included. The sequence statistics
+--	recorded per source are merged into recv_sequence first.
+----------------------------------------------------------------------------------------------------------------------*/
+static void finish_transfer(TransferResult &result, std::string &print_string)
+{
+	std::string print_output;
+
+	receiving = false;
+
+	if (recv_total_bytes == 0)
+	{
+		return;
+	}
+
+	// Record Server Statistics
+	result.total_bytes = recv_total_bytes;
+	result.packets = packets_recvd;
+	result.segments = segments_recvd;
+	result.datagrams_per_call = (recv_calls > 0) ? (double)packets_recvd / recv_calls : 0;
+	result.syscalls = recv_syscall_count() - recv_syscalls_start;
+	recv_timer.report(result);
+
+	// Each Source Numbers its own Datagrams, so only its own Stream can be Reordered
+	if (!recv_sources.empty())
+	{
+		recv_sequence.start();
+		for (const auto &source : recv_sources)
+		{
+			recv_sequence.merge(source.second);
+		}
+		recv_sources.clear();
+	}
+	recv_sequence.report(result);
+	if (recv_delay.active())
+	{
+		recv_delay.report(result);
+	}
+	result.socket = recv_settings;
+	recv_pool().report(result, recv_pool_start);
+
+	// Tell a Stamping Client its Loss
+	if (recv_sequence.active())
+	{
+		send_loss_report();
+	}
+
+	// Append Received Data Statistics to print_output
+	print_output += "[UDP SERVER]";
+	recv_timer.append_report(print_output);
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(recv_total_bytes);
+	print_output += " Bytes";
+	print_output += "\nNumber of Packets Received: ";
+	print_output += std::to_string(packets_recvd);
+	if (recv_sequence.active())
+	{
+		recv_sequence.append_report(print_output);
+	}
+	if (recv_delay.active())
+	{
+		recv_delay.append_report(print_output);
+		recv_delay.start();
+	}
+	if (gro_enabled)
+	{
+		print_output += "\nNumber of Segments Received (GRO): ";
+		print_output += std::to_string(segments_recvd);
+	}
+	append_batch_report(print_output, result.datagrams_per_call, recv_batch_max);
+	if (recv_ring.is_ready())
+	{
+		print_output += "\nEngine: io_uring (queue depth ";
+		print_output += std::to_string(recv_slots.size());
+		print_output += ")";
+	}
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(result.syscalls);
+	if (!udp_shards.empty())
+	{
+		append_shard_report(print_output);
+	}
+	if (reliable_transfer)
+	{
+		rudp_receiver.append_report(print_output);
+		reliable_transfer = false;
+	}
+	recv_pool().append_report(print_output, recv_pool_start);
+	append_settings(print_output, recv_settings);
+
+	print_string = print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		trace_seq
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		trace_seq(const TraceRing &trace, const char *datagram, ssize_t len, long long call)
+--						const TraceRing &trace: Trace ring the datagram is recorded in
+--						const char *datagram: Received datagram
+--						ssize_t len: Length of the datagram, or -1
+--						long long call: Number of the system call that returned the datagram
+--
+--	RETURNS:		uint32_t - the sequence number of a stamped datagram, else the number of the call.
+--
+--	NOTES:
+--	Only parses the datagram while tracing.
+----------------------------------------------------------------------------------------------------------------------*/
+static uint32_t trace_seq(const TraceRing &trace, const char *datagram, ssize_t len, long long call)
+{
+	uint32_t seq, total;
+	uint64_t send_ns;
+
+	if (trace.enabled() && sequence_parse(datagram, len, seq, total, send_ns))
+	{
+		return seq;
+	}
+	return (uint32_t)call;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_datagram
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Count GRO coalesced segments]
+--					October 16, 2026 [Count system calls]
+--					October 16, 2026 [Record sequence stamps]
+--					October 17, 2026 [Record sequence stamps per source]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_datagram(const char *datagram, ssize_t received_bytes, int segments, int call_index,
+--						TransferResult &result, std::string &print_string)
+--						const char *datagram: The received datagram
+--						ssize_t received_bytes: Length of the datagram
+--						int segments: Number of segments coalesced into the datagram by GRO (1 without GRO)
+--						int call_index: Position of the datagram in the batch returned by one system call
+--						TransferResult &result: Set to the transfer statistics when the transfer ends
+--						std::string &print_string: Set to the printable transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Records one received datagram. The timer is started on the first datagram of a transfer, and the transfer ends
+--	when a datagram ending in EOT arrives. recv_last and recv_source must be set before calling. A stamped datagram
+--	is also recorded in the sequence statistics of its source, since the concurrent workers of udp-latency each
+--	send their own share of the sequence numbers to the one echo socket. A buffer of GRO coalesced segments is not
+--	parsed for stamps.
+----------------------------------------------------------------------------------------------------------------------*/
+static void record_datagram(const char *datagram, ssize_t received_bytes, int segments, int call_index,
+	TransferResult &result, std::string &print_string)
+{
+	RecvBufferPool &pool = recv_pool();
+	uint32_t seq, total;
+	uint64_t send_ns;
+
+	// Start Timer
+	if (!receiving)
+	{
+		receiving = true;
+		recv_total_bytes = 0;
+		packets_recvd = 0;
+		segments_recvd = 0;
+		recv_calls = 0;
+		recv_batch_max = 0;
+		recv_timer.start(recv_last);
+		recv_sequence.start();
+		recv_sources.clear();
+		recv_pool_start = pool.stats();
+
+		// Include the Call that Returned this Datagram
+		recv_syscalls_start = recv_syscall_count() - 1;
+	}
+
+	// Count the System Call with its First Datagram
+	if (call_index == 0)
+	{
+		recv_calls++;
+	}
+	if (call_index + 1 > recv_batch_max)
+	{
+		recv_batch_max = call_index + 1;
+	}
+
+	recv_timer.record_chunk(received_bytes, recv_last);
+	pool.record_received(received_bytes);
+	recv_total_bytes += received_bytes;
+	packets_recvd++;
+	segments_recvd += segments;
+
+	// Loss, Reordering and Jitter of Stamped Datagrams
+	if (segments == 1 && sequence_parse(datagram, received_bytes, seq, total, send_ns))
+	{
+		recv_sources[((uint64_t)recv_source.sin_addr.s_addr << 16) | recv_source.sin_port].record(seq, total,
+			send_ns, recv_last);
+	}
+
+	if (received_bytes > 0 && datagram[received_bytes - 1] == EOT)
+	{
+		finish_transfer(result, print_string);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_ack
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_ack(SOCKET sock)
+--						SOCKET sock: The datagram socket of the Server
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Sends the acknowledgement of the reliable session to its Client. A full socket drops the acknowledgement; the
+--	Client recovers through the next one or its retransmission timer.
+----------------------------------------------------------------------------------------------------------------------*/
+static void send_ack(SOCKET sock)
+{
+	RudpAck ack;
+	size_t len = rudp_receiver.build_ack(ack);
+
+	sendto(sock, (const char *)&ack, len, 0, (struct sockaddr *)&rudp_client, sizeof(rudp_client));
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_reliable
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_reliable(SOCKET sock, const struct sockaddr_in &source_addr, const char *datagram,
+--						ssize_t received_bytes, TransferResult &result, std::string &print_string)
+--						SOCKET sock: The datagram socket of the Server
+--						const struct sockaddr_in &source_addr: Address the datagram came from
+--						const char *datagram: The received datagram
+--						ssize_t received_bytes: Length of the datagram
+--						TransferResult &result: Set to the transfer statistics when the transfer ends
+--						std::string &print_string: Set to the printable transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	The counterpart of record_datagram in the reliable UDP mode (see rudp.cpp). The first DATA datagram of a new
+--	session starts the transfer; only datagrams received for the first time are recorded, so the statistics are the
+--	goodput. The transfer ends when the Client's FIN arrives with every datagram received, and every FIN is answered
+--	with FIN_ACK, including repeats of a FIN whose FIN_ACK was lost. recv_last must be set before calling.
+----------------------------------------------------------------------------------------------------------------------*/
+static void receive_reliable(SOCKET sock, const struct sockaddr_in &source_addr, const char *datagram,
+	ssize_t received_bytes, TransferResult &result, std::string &print_string)
+{
+	RecvBufferPool &pool = recv_pool();
+	RudpHeader header;
+	RudpHeader fin_ack;
+
+	if (!rudp_parse(datagram, received_bytes, header))
+	{
+		return;
+	}
+
+	switch (header.type)
+	{
+	case RUDP_DATA:
+		// Late Retransmission of a Finished Session
+		if (header.session == rudp_finished_session)
+		{
+			break;
+		}
+
+		// Start Timer
+		if (!receiving || !reliable_transfer || header.session != rudp_receiver.session())
+		{
+			receiving = true;
+			reliable_transfer = true;
+			recv_total_bytes = 0;
+			packets_recvd = 0;
+			segments_recvd = 0;
+			recv_calls = 0;
+			recv_batch_max = 1;
+			recv_timer.start(recv_last);
+			recv_pool_start = pool.stats();
+			recv_syscalls_start = recv_syscall_count() - 1;
+			rudp_receiver.start(header.session, header.total);
+			rudp_client = source_addr;
+		}
+
+		recv_calls++;
+		pool.record_received(received_bytes);
+		if (rudp_receiver.record(header.seq))
+		{
+			recv_timer.record_chunk(received_bytes - sizeof(RudpHeader), recv_last);
+			recv_total_bytes += received_bytes - sizeof(RudpHeader);
+			packets_recvd++;
+			segments_recvd++;
+		}
+		if (rudp_receiver.ack_due())
+		{
+			send_ack(sock);
+		}
+		break;
+	case RUDP_FIN:
+		rudp_header(fin_ack, RUDP_FIN_ACK, header.session, header.seq, header.total);
+		sendto(sock, (const char *)&fin_ack, sizeof(fin_ack), 0, (const struct sockaddr *)&source_addr,
+			sizeof(source_addr));
+
+		if (receiving && reliable_transfer && header.session == rudp_receiver.session() && rudp_receiver.complete())
+		{
+			rudp_finished_session = header.session;
+			finish_transfer(result, print_string);
+		}
+		break;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		gro_segments
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		gro_segments(struct msghdr &msg, ssize_t received_bytes)
+--						struct msghdr &msg: Message header of the receive, with its control messages
+--						ssize_t received_bytes: Length of the received buffer
+--
+--	RETURNS:		int - the number of segments coalesced into the buffer.
+--
+--	NOTES:
+--	The kernel only attaches a UDP_GRO control message when it coalesced segments. Its value is the segment size;
+--	every segment but the last has that size. Without the control message the buffer is a single datagram.
+----------------------------------------------------------------------------------------------------------------------*/
+static int gro_segments(struct msghdr &msg, ssize_t received_bytes)
+{
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+		{
+			int segment_size;
+
+			memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+			if (segment_size > 0)
+			{
+				return (int)((received_bytes + segment_size - 1) / segment_size);
+			}
+		}
+	}
+
+	return 1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		publish_part
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		publish_part(UdpShard &shard)
+--						UdpShard &shard: Socket whose part of the transfer is finished
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called on the socket's thread. Moves the part into the finished slot and wakes the main thread through the
+--	shard_notify eventfd. The slot is released by the main thread with an atomic flag, so no lock is taken; if the
+--	main thread has not taken the previous part yet, the socket keeps receiving into its part and publishes it on
+--	the next EVENT_IDLE.
+----------------------------------------------------------------------------------------------------------------------*/
+static void publish_part(UdpShard &shard)
+{
+	uint64_t notify = 1;
+
+	if (shard.finished_ready.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	shard.part.syscalls = shard.syscalls - shard.syscalls_start;
+	shard.finished = std::move(shard.part);
+	shard.finished_ready.store(true, std::memory_order_release);
+	shard.active = false;
+	shard.sources.clear();
+	active_shards.fetch_sub(1, std::memory_order_acq_rel);
+
+	if (write(shard_notify, &notify, sizeof(notify)) == -1)
+	{
+		perror("write() failed");
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		record_shard_datagram
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Record sequence stamps]
+--					October 16, 2026 [Send the loss report of stamped transfers]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		record_shard_datagram(UdpShard &shard, int call_index, uint64_t now_ns)
+--						UdpShard &shard: Socket the datagram was received on
+--						int call_index: Position of the datagram in the batch returned by recvmmsg
+--						uint64_t now_ns: Arrival time of the batch
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	The counterpart of record_datagram for a SO_REUSEPORT socket, called on the socket's thread. Every datagram is
+--	recorded into the socket's own part of the transfer. The kernel hashes each Client to one socket, so the socket
+--	keeps the Clients it has heard from, and its part is finished once every one of them has sent EOT.
+----------------------------------------------------------------------------------------------------------------------*/
+static void record_shard_datagram(UdpShard &shard, int call_index, uint64_t now_ns)
+{
+	const char *datagram = (const char *)shard.iovecs[call_index].iov_base;
+	ssize_t received_bytes = shard.msgs[call_index].msg_len;
+	struct sockaddr_in &source_addr = shard.addrs[call_index];
+	uint64_t source = ((uint64_t)source_addr.sin_addr.s_addr << 16) | source_addr.sin_port;
+	ShardPart &part = shard.part;
+	int segments = gro_segments(shard.msgs[call_index].msg_hdr, received_bytes);
+	uint32_t seq, total;
+	uint64_t send_ns;
+
+	// Start the Part of this Socket, Including the Call that Returned the Datagram
+	if (!shard.active)
+	{
+		shard.active = true;
+		active_shards.fetch_add(1, std::memory_order_acq_rel);
+		part = ShardPart();
+		part.shard = shard.index;
+		part.start_ns = now_ns;
+		part.timer.start(now_ns);
+		shard.syscalls_start = shard.syscalls - 1;
+	}
+
+	if (call_index == 0)
+	{
+		part.calls++;
+	}
+	if (call_index + 1 > part.batch_max)
+	{
+		part.batch_max = call_index + 1;
+	}
+
+	part.timer.record_chunk(received_bytes, now_ns);
+	recv_pool().record_received(received_bytes);
+	part.bytes += received_bytes;
+	part.packets++;
+	part.segments += segments;
+	part.source = source_addr;
+	shard.last_ns = now_ns;
+
+	if (segments == 1 && sequence_parse(datagram, received_bytes, seq, total, send_ns))
+	{
+		part.sequence.record(seq, total, send_ns, now_ns);
+	}
+
+	// Every Client of the Socket has Sent EOT
+	if (received_bytes > 0 && datagram[received_bytes - 1] == EOT)
+	{
+		shard.sources.erase(source);
+		if (shard.sources.empty())
+		{
+			publish_part(shard);
+		}
+	}
+	else
+	{
+		shard.sources.insert(source);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_shard
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Trace every call with --trace]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_shard(UdpShard &shard)
+--						UdpShard &shard: Socket passed by its EventLoop
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called on the socket's thread on EVENT_READ. Receives up to batch_size datagrams per recvmmsg call into the
+--	socket's own slots until no more datagrams are queued. Nothing is shared with the other sockets.
+----------------------------------------------------------------------------------------------------------------------*/
+static void receive_shard(UdpShard &shard)
+{
+	TraceRing &trace = trace_ring();
+	int batch_size = (int)shard.msgs.size();
+	int received;
+	uint64_t now_ns;
+
+	do
+	{
+		for (int i = 0; i < batch_size; i++)
+		{
+			memset(&shard.msgs[i], 0, sizeof(struct mmsghdr));
+			shard.msgs[i].msg_hdr.msg_name = &shard.addrs[i];
+			shard.msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+			shard.msgs[i].msg_hdr.msg_iov = &shard.iovecs[i];
+			shard.msgs[i].msg_hdr.msg_iovlen = 1;
+			shard.msgs[i].msg_hdr.msg_control = &shard.controls[(size_t)i * GRO_CONTROL_SIZE];
+			shard.msgs[i].msg_hdr.msg_controllen = GRO_CONTROL_SIZE;
+		}
+
+		shard.syscalls++;
+		if ((received = recvmmsg(shard.sock, shard.msgs.data(), batch_size, MSG_DONTWAIT, NULL)) == -1)
+		{
+			trace.record(TRACE_RECV_BATCH, (uint32_t)shard.syscalls, 0, -1, errno);
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				perror("recvmmsg() failed");
+			}
+			// Wait for the next EVENT_READ
+			return;
+		}
+
+		now_ns = monotonic_ns();
+		for (int i = 0; i < received; i++)
+		{
+			trace.record(TRACE_RECV_BATCH, trace_seq(trace, (const char *)shard.iovecs[i].iov_base,
+				shard.msgs[i].msg_len, shard.syscalls), shard.msgs[i].msg_len, received, 0);
+			record_shard_datagram(shard, i, now_ns);
+		}
+	} while (true);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		check_shard_timeout
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		check_shard_timeout(UdpShard &shard)
+--						UdpShard &shard: Socket whose EventLoop is idle
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called on the socket's thread on EVENT_IDLE. Finishes the socket's part if a Client's EOT was lost and nothing
+--	has arrived for UDP_IDLE_TIMEOUT ms, or retries a part that could not be published.
+----------------------------------------------------------------------------------------------------------------------*/
+static void check_shard_timeout(UdpShard &shard)
+{
+	if (shard.active && (shard.sources.empty() || monotonic_ns() - shard.last_ns >= UDP_IDLE_TIMEOUT * 1000000ULL))
+	{
+		publish_part(shard);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		collect_shards
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Merge the sequence statistics]
+--					October 16, 2026 [Send the loss report of stamped transfers]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		collect_shards(TransferResult &result, std::string &print_string)
+--						TransferResult &result: Set to the transfer statistics when the transfer ends
+--						std::string &print_string: Set to the printable transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called on the main thread when a socket publishes its part. The number of active sockets is read before the
+--	finished slots, so every socket that stopped being active has already published its part. Once no socket is
+--	active the parts are merged into one transfer (the earliest part's timer is the base, the others are merged into
+--	it) and reported with finish_transfer.
+----------------------------------------------------------------------------------------------------------------------*/
+static void collect_shards(TransferResult &result, std::string &print_string)
+{
+	uint64_t notified;
+	int active;
+	size_t base = 0;
+	long long syscalls = 0;
+
+	if (read(shard_notify, &notified, sizeof(notified)) == -1 && errno != EAGAIN)
+	{
+		perror("read() failed");
+	}
+
+	// Take the Finished Parts
+	active = active_shards.load(std::memory_order_acquire);
+	for (std::unique_ptr<UdpShard> &shard : udp_shards)
+	{
+		if (shard->finished_ready.load(std::memory_order_acquire))
+		{
+			shard_parts.push_back(std::move(shard->finished));
+			shard->finished_ready.store(false, std::memory_order_release);
+		}
+	}
+	if (active > 0 || shard_parts.empty())
+	{
+		return;
+	}
+
+	// Merge the Counters of every Socket
+	for (size_t i = 1; i < shard_parts.size(); i++)
+	{
+		if (shard_parts[i].start_ns < shard_parts[base].start_ns)
+		{
+			base = i;
+		}
+	}
+	recv_timer = shard_parts[base].timer;
+	recv_total_bytes = 0;
+	packets_recvd = 0;
+	segments_recvd = 0;
+	recv_calls = 0;
+	recv_batch_max = 0;
+	recv_sequence.start();
+	for (size_t i = 0; i < shard_parts.size(); i++)
+	{
+		if (i != base)
+		{
+			recv_timer.merge(shard_parts[i].timer);
+		}
+		recv_total_bytes += shard_parts[i].bytes;
+		packets_recvd += (int)shard_parts[i].packets;
+		segments_recvd += shard_parts[i].segments;
+		recv_calls += shard_parts[i].calls;
+		syscalls += shard_parts[i].syscalls;
+		recv_sequence.merge(shard_parts[i].sequence);
+		if (shard_parts[i].batch_max > recv_batch_max)
+		{
+			recv_batch_max = shard_parts[i].batch_max;
+		}
+	}
+
+	// The Sockets Counted their own Calls, the Loss Report goes to the Source of the Last Part
+	recv_syscalls_start = recv_syscall_count() - syscalls;
+	recv_source = shard_parts.back().source;
+	finish_transfer(result, print_string);
+
+	shard_parts.clear();
+	recv_pool_start = recv_pool().stats();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_batch
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Stamp datagrams with --stamp]
+--					October 16, 2026 [Trace every call with --trace]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_batch(SOCKET sock, struct sockaddr_in &server, Payload &payload, int packet_size,
+--						int first, int count, int total, bool stamp, long long &total_bytes)
+--						SOCKET sock: Non-blocking datagram socket
+--						struct sockaddr_in &server: Address of the Server
+--						Payload &payload: Data of the transfer
+--						int packet_size: Size of a datagram in Bytes
+--						int first: Index of the first datagram of the batch
+--						int count: Number of datagrams in the batch
+--						int total: Number of datagrams in the transfer
+--						bool stamp: Put a sequence stamp at the start of every datagram
+--						long long &total_bytes: Incremented by the number of bytes sent
+--
+--	RETURNS:		int - the number of datagrams sent, 0 if the socket is full, or -1 on error.
+--
+--	NOTES:
+--	Sends up to count datagrams with a single sendmmsg call. The kernel may send fewer than requested; the caller
+--	continues from the first datagram that was not sent. A stamp is a second buffer in front of the packet that
+--	replaces its first Bytes, so the datagrams keep their size; every stamp of a batch gets the time of the call.
+----------------------------------------------------------------------------------------------------------------------*/
+static int send_batch(SOCKET sock, struct sockaddr_in &server, Payload &payload, int packet_size,
+	int first, int count, int total, bool stamp, long long &total_bytes)
+{
+	std::vector<struct mmsghdr> msgs(count);
+	std::vector<struct iovec> iovecs(2 * count);
+	std::vector<SequenceStamp> stamps(stamp ? count : 0);
+	size_t skip = stamp ? sizeof(SequenceStamp) : 0;
+	uint64_t send_ns = stamp ? monotonic_ns() : 0;
+	int sent;
+
+	for (int i = 0; i < count; i++)
+	{
+		struct iovec *iov = &iovecs[2 * i];
+
+		if (stamp)
+		{
+			sequence_stamp(stamps[i], first + i, total, send_ns);
+			iov->iov_base = &stamps[i];
+			iov->iov_len = skip;
+			iov++;
+		}
+		iov->iov_base = (void *)(payload.packet(first + i) + skip);
+		iov->iov_len = packet_size - skip;
+		memset(&msgs[i], 0, sizeof(struct mmsghdr));
+		msgs[i].msg_hdr.msg_name = &server;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server);
+		msgs[i].msg_hdr.msg_iov = &iovecs[2 * i];
+		msgs[i].msg_hdr.msg_iovlen = stamp ? 2 : 1;
+	}
+
+	sent = sendmmsg(sock, msgs.data(), count, 0);
+	trace_ring().record(TRACE_SEND_BATCH, first, (uint32_t)count * packet_size, sent, (sent == -1) ? errno : 0);
+	if (sent == -1)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS)
+		{
+			return 0;
+		}
+		return -1;
+	}
+
+	for (int i = 0; i < sent; i++)
+	{
+		total_bytes += msgs[i].msg_len;
+	}
+	return sent;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_stamped
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Kernel timestamps with --timestamps]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_stamped(SOCKET sock, struct sockaddr_in &server, const char *packet, int packet_size,
+--						int seq, int total, const TimestampFollowUp *follow_up)
+--						SOCKET sock: Non-blocking datagram socket
+--						struct sockaddr_in &server: Address of the Server
+--						const char *packet: Payload of the datagram
+--						int packet_size: Size of the datagram in Bytes
+--						int seq: Sequence number of the datagram
+--						int total: Number of datagrams in the transfer
+--						const TimestampFollowUp *follow_up: Sent after the stamp, or NULL
+--
+--	RETURNS:		ssize_t - the number of bytes sent, or -1 on error (errno is set by sendmsg).
+--
+--	NOTES:
+--	The stamped counterpart of sendto. The stamp (and the follow-up) is sent from its own buffer in place of the
+--	first Bytes of the packet, so the read-only payload is not copied or modified.
+----------------------------------------------------------------------------------------------------------------------*/
+static ssize_t send_stamped(SOCKET sock, struct sockaddr_in &server, const char *packet, int packet_size,
+	int seq, int total, const TimestampFollowUp *follow_up)
+{
+	SequenceStamp stamp;
+	struct iovec iov[3];
+	struct msghdr msg;
+	size_t header = sizeof(stamp);
+	int count = 0;
+
+	sequence_stamp(stamp, seq, total, monotonic_ns());
+	iov[count].iov_base = &stamp;
+	iov[count++].iov_len = sizeof(stamp);
+	if (follow_up != NULL)
+	{
+		iov[count].iov_base = (void *)follow_up;
+		iov[count++].iov_len = sizeof(TimestampFollowUp);
+		header += sizeof(TimestampFollowUp);
+	}
+	iov[count].iov_base = (void *)(packet + header);
+	iov[count++].iov_len = packet_size - header;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server;
+	msg.msg_namelen = sizeof(server);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = count;
+
+	return sendmsg(sock, &msg, 0);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		release_shards
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		release_shards()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Stops the threads of the SO_REUSEPORT sockets, then closes the sockets and returns their slots to the pool.
+----------------------------------------------------------------------------------------------------------------------*/
+static void release_shards()
+{
+	shard_loops.stop();
+
+	for (std::unique_ptr<UdpShard> &shard : udp_shards)
+	{
+		if (shard->sock != INVALID_SOCKET)
+		{
+			closesocket(shard->sock);
+		}
+		for (char *buf : shard->buffers)
+		{
+			recv_pool().release(buf);
+		}
+	}
+	udp_shards.clear();
+	shard_parts.clear();
+	active_shards.store(0);
+
+	if (shard_notify != -1)
+	{
+		close(shard_notify);
+		shard_notify = -1;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start_shards
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Check the receive buffers for NULL]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start_shards(int port, const TransferOptions &options, EventLoop &loop)
+--						int port: The Port the server will be listening on
+--						const TransferOptions &options: Options of the Server (reuseport sockets, batch size, GRO)
+--						EventLoop &loop: Event loop of the main thread, which collects the finished parts
+--
+--	RETURNS:		bool - true if every socket was bound.
+--
+--	NOTES:
+--	Binds reuseport sockets to the port with SO_REUSEPORT and starts one EventLoop per socket, each on its own
+--	thread pinned to its own core. Every socket gets its own recvmmsg slots carved out of pool buffers, so the
+--	threads share nothing on the receive path.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool start_shards(int port, const TransferOptions &options, EventLoop &loop)
+{
+	RecvBufferPool &pool = recv_pool();
+	int batch_size = (options.batch_size > 1) ? options.batch_size : 1;
+	int slots_per_buffer = (int)(pool.buffer_size() / UDP_DATAGRAM_MAX);
+	int reuse = 1;
+	int gro = 1;
+	struct sockaddr_in internet_addr;
+
+	// The Main Thread is Woken when a Socket Finishes its Part
+	if ((shard_notify = eventfd(0, EFD_NONBLOCK)) == -1)
+	{
+		perror("eventfd() failed");
+		return false;
+	}
+
+	// Initialize Address Structure
+	memset(&internet_addr, 0, sizeof(internet_addr));
+	internet_addr.sin_family = AF_INET;
+	internet_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	internet_addr.sin_port = htons(port);
+
+	gro_enabled = (options.gso_size > 0);
+	for (int i = 0; i < options.reuseport; i++)
+	{
+		UdpShard *shard = new UdpShard();
+
+		udp_shards.push_back(std::unique_ptr<UdpShard>(shard));
+		shard->index = i;
+
+		// Every Socket Binds the Same Port, the Kernel Hashes each Client to one of them
+		if ((shard->sock = socket(PF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET)
+		{
+			perror("socket() failed");
+			release_shards();
+			return false;
+		}
+		set_nonblocking(shard->sock);
+		apply_tuning(shard->sock, options.tuning, false);
+		if (i == 0)
+		{
+			recv_settings = read_settings(shard->sock, options.tuning, false);
+		}
+		if (setsockopt(shard->sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == -1)
+		{
+			perror("setsockopt(SO_REUSEPORT) failed");
+			release_shards();
+			return false;
+		}
+		if (gro_enabled && setsockopt(shard->sock, SOL_UDP, UDP_GRO, &gro, sizeof(gro)) == -1)
+		{
+			perror("setsockopt(UDP_GRO) failed, receiving segments individually");
+			gro_enabled = false;
+		}
+		if (bind(shard->sock, (struct sockaddr *)&internet_addr, sizeof(internet_addr)) == SOCKET_ERROR)
+		{
+			perror("bind() failed");
+			release_shards();
+			return false;
+		}
+
+		// Carve the Datagram Slots of the Socket out of Pool Buffers
+		shard->msgs.resize(batch_size);
+		shard->iovecs.resize(batch_size);
+		shard->addrs.resize(batch_size);
+		shard->controls.resize((size_t)batch_size * GRO_CONTROL_SIZE);
+		for (int j = 0; j < batch_size; j++)
+		{
+			if (j % slots_per_buffer == 0)
+			{
+				shard->buffers.push_back(pool.acquire());
+				if (shard->buffers.back() == NULL)
+				{
+					fprintf(stderr, "Cannot allocate the receive buffers\n");
+					release_shards();
+					return false;
+				}
+			}
+			shard->iovecs[j].iov_base = shard->buffers.back() + (size_t)(j % slots_per_buffer) * UDP_DATAGRAM_MAX;
+			shard->iovecs[j].iov_len = UDP_DATAGRAM_MAX;
+		}
+	}
+
+	// One Pinned Receive Thread per Socket
+	shard_loops.start(options.reuseport, 0, [](int shard, [[maybe_unused]] SOCKET sock, int event)
+	{
+		if (event == EVENT_READ)
+		{
+			receive_shard(*udp_shards[shard]);
+		}
+		else if (event == EVENT_IDLE)
+		{
+			check_shard_timeout(*udp_shards[shard]);
+		}
+	}, UDP_IDLE_TIMEOUT);
+	for (int i = 0; i < options.reuseport; i++)
+	{
+		shard_loops.loop(i).async_select(udp_shards[i]->sock, EVENT_READ);
+	}
+
+	recv_pool_start = pool.stats();
+	loop.async_select(shard_notify, EVENT_READ);
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		start_server
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Enable UDP_GRO]
+--					October 16, 2026 [Set up the io_uring engine]
+--					October 16, 2026 [Receive on SO_REUSEPORT sockets with --reuseport]
+--					October 16, 2026 [Single recvmsg socket for --reliable]
+--					October 16, 2026 [Receive on one socket with --echo]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 16, 2026 [Kernel timestamps with --timestamps]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		start_server(int port, EventLoop &loop)
+--						int port: The Port the server will be listening on
+--						EventLoop &loop: Event loop that dispatches the socket events
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Starts the UDP Server on the given port. The datagram socket is registered with the EventLoop for EVENT_READ.
+--	With a socket count (--reuseport) the Server receives on that many SO_REUSEPORT sockets instead, each on its own
+--	thread (see start_shards). The reliable mode needs the source address of every datagram to acknowledge it, so
+--	it receives on one socket with recvmsg.
+----------------------------------------------------------------------------------------------------------------------*/
+void UDP::start_server(int port, EventLoop &loop)
+{
+	struct sockaddr_in internet_addr;
+
+	// Receive on SO_REUSEPORT Sockets, each on its own Thread
+	if (options.reuseport > 0 && options.reliable_window == 0 && !options.echo && !options.timestamps)
+	{
+		start_shards(port, options, loop);
+		return;
+	}
+
+	// Create Socket
+	if ((udp_sock = socket(PF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET)
+	{
+		perror("socket() failed");
+		return;
+	}
+	set_nonblocking(udp_sock);
+	apply_tuning(udp_sock, options.tuning, false);
+	recv_settings = read_settings(udp_sock, options.tuning, false);
+
+	// Kernel Receive Timestamps of every Datagram
+	rx_timestamps = options.timestamps && timestamping_enable(udp_sock, false);
+
+	// Allocate the Receive Buffers before the First Transfer
+	recv_pool();
+
+	// Coalesce Segment Trains on Receive
+	gro_enabled = false;
+	if (options.gso_size > 0)
+	{
+		int gro = 1;
+
+		if (setsockopt(udp_sock, SOL_UDP, UDP_GRO, &gro, sizeof(gro)) == -1)
+		{
+			perror("setsockopt(UDP_GRO) failed, receiving segments individually");
+		}
+		else
+		{
+			gro_enabled = true;
+		}
+	}
+
+	// Receive through io_uring
+	if (options.uring_depth > 0 && !gro_enabled && options.reliable_window == 0 && !options.echo
+		&& !options.timestamps && !recv_ring.is_ready())
+	{
+		if (uring_receiver_setup(recv_ring, options.uring_depth, recv_ring_buffers, recv_slots))
+		{
+			recv_ring.register_file(udp_sock);
+		}
+		else
+		{
+			fprintf(stderr, "io_uring is not available, receiving with recvmsg()\n");
+		}
+	}
+
+	// Initialize Address Structure
+	memset(&internet_addr, 0, sizeof(internet_addr));
+	internet_addr.sin_family = AF_INET;
+	internet_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	internet_addr.sin_port = htons(port);
+
+	// Bind socket to address structure
+	if (bind(udp_sock, (struct sockaddr *)&internet_addr, sizeof(internet_addr)) == SOCKET_ERROR)
+	{
+		perror("bind() failed");
+		recv_ring.unregister_file();
+		closesocket(udp_sock);
+		udp_sock = INVALID_SOCKET;
+		return;
+	}
+
+	loop.async_select(udp_sock, EVENT_READ);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		await_loss_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		await_loss_report(SOCKET sock, uint32_t &received, uint32_t &expected)
+--						SOCKET sock: Socket the stamped datagrams were sent from
+--						uint32_t &received: Set to the number of distinct datagrams the Server received
+--						uint32_t &expected: Set to the number of datagrams the Client sent
+--
+--	RETURNS:		bool - true if a report arrived within REPORT_TIMEOUT ms.
+--
+--	NOTES:
+--	The Server sends the report when the transfer ends, which is up to twice UDP_IDLE_TIMEOUT after the last
+--	datagram if the one carrying EOT was lost. Other datagrams on the socket are skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+static bool await_loss_report(SOCKET sock, uint32_t &received, uint32_t &expected)
+{
+	char datagram[BUFFERSIZE];
+	uint64_t deadline_ns = monotonic_ns() + (uint64_t)REPORT_TIMEOUT * 1000000ULL;
+	uint64_t now_ns;
+
+	while ((now_ns = monotonic_ns()) < deadline_ns)
+	{
+		ssize_t len;
+
+		if (!wait_for_socket(sock, POLLIN, (int)((deadline_ns - now_ns) / 1000000ULL) + 1))
+		{
+			return false;
+		}
+		if ((len = recv(sock, datagram, sizeof(datagram), 0)) == -1)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				continue;
+			perror("recv() failed");
+			return false;
+		}
+		if (sequence_parse_report(datagram, len, received, expected))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_packet
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Send read-only views of a prepared Payload]
+--					October 16, 2026 [Send batches with sendmmsg]
+--					October 16, 2026 [Segment packets with UDP_SEGMENT]
+--					October 16, 2026 [Send through io_uring with --uring]
+--					October 16, 2026 [Send reliably with --reliable]
+--					October 16, 2026 [Stamp datagrams with --stamp]
+--					October 16, 2026 [Pace with --bitrate/--pps, wait for the loss report, --ramp]
+--					October 16, 2026 [Trace every call with --trace]
+--					October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 16, 2026 [Kernel timestamps with --timestamps]
+--					October 17, 2026 [Report the pacing waits]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_packet(char *host, int port, int packet_size, int num_packet)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Sends datagrams to the Server. The last byte of the last datagram is the EOT marker so the Server knows the
+--	transfer is over without waiting for the idle timeout. With --stamp every datagram starts with its sequence
+--	stamp, which leaves the EOT marker in place.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string UDP::send_packet(char *host, int port, int packet_size, int num_packet)
+{
+	SOCKET data_sock;
+	ssize_t sent_bytes;
+	long long total_bytes = 0;
+	long long send_calls = 0;
+	long long syscalls = 0;
+	int send_batch_max = 0;
+	int batch_size = options.batch_size;
+	int gso_size = options.gso_size;
+	struct sockaddr_in server;
+	Payload payload;
+	IoUring ring;
+	TokenBucket bucket;
+	TxTimestamps tx_stamps;
+	TimestampFollowUp follow_up;
+	TraceRing &trace = trace_ring();
+	bool use_uring = false;
+	bool stamp = options.stamp;
+	bool timestamps = options.timestamps;
+	uint64_t app_ns = 0;
+	bool paid = false;
+	int prepaid = 0;
+	uint32_t report_received = 0;
+	uint32_t report_expected = 0;
+	std::string print_output;
+
+	// Sequence Numbers, Acknowledgements and Retransmission
+	if (options.reliable_window > 0)
+	{
+		return send_reliable(host, port, packet_size, num_packet);
+	}
+
+	// Search the Highest Rate within the Loss Limit
+	if (options.ramp_loss > 0)
+	{
+		return ramp_rate(host, port, packet_size, num_packet);
+	}
+
+	result = TransferResult();
+
+	// Generate the Data, with the EOT Marker at the End of the Last Datagram
+	if (!payload.prepare(options, packet_size, num_packet, true))
+	{
+		return "Error payload";
+	}
+
+	// Create Non-Blocking Datagram Socket
+	if ((data_sock = socket(AF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET)
+	{
+		perror("Cannot create socket");
+		return "Error socket()";
+	}
+	set_nonblocking(data_sock);
+	apply_tuning(data_sock, options.tuning, false);
+	result.socket = read_settings(data_sock, options.tuning, false);
+
+	// Resolve Host
+	memset(&server, 0, sizeof(struct sockaddr_in));
+	if (!resolve_host(host, port, server))
+	{
+		perror("Unknown server address");
+		closesocket(data_sock);
+		return "Error getaddrinfo()";
+	}
+
+	// Let the Kernel Split every Packet into Segments
+	if (gso_size > 0)
+	{
+		if (packet_size > gso_size * UDP_MAX_SEGMENTS)
+		{
+			fprintf(stderr, "A packet of %d Bytes needs more than %d segments of %d Bytes\n",
+				packet_size, UDP_MAX_SEGMENTS, gso_size);
+			closesocket(data_sock);
+			return "Error UDP_SEGMENT";
+		}
+		if (setsockopt(data_sock, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size)) == -1)
+		{
+			perror("setsockopt(UDP_SEGMENT) failed");
+			closesocket(data_sock);
+			return "Error UDP_SEGMENT";
+		}
+	}
+
+	// Stamps go at the Start of every Datagram
+	if (stamp && (gso_size > 0 || packet_size <= (int)sizeof(SequenceStamp)))
+	{
+		fprintf(stderr, "Stamps need unsegmented packets of more than %d Bytes, sending unstamped\n",
+			(int)sizeof(SequenceStamp));
+		stamp = false;
+	}
+
+	// Every Datagram takes its own Send Call, so the Kernel Numbers its TX Timestamp with its Sequence Number
+	if (timestamps && (!stamp || packet_size <= (int)(sizeof(SequenceStamp) + sizeof(TimestampFollowUp))))
+	{
+		fprintf(stderr, "Timestamps need stamped packets of more than %d Bytes, sending without\n",
+			(int)(sizeof(SequenceStamp) + sizeof(TimestampFollowUp)));
+		timestamps = false;
+	}
+	if (timestamps && batch_size > 1)
+	{
+		fprintf(stderr, "Timestamps follow every send call, sending one datagram per call\n");
+		batch_size = 1;
+	}
+	if (timestamps && !tx_stamps.start(data_sock))
+	{
+		fprintf(stderr, "TX timestamps are not available, sending without\n");
+		timestamps = false;
+	}
+
+	// Send through io_uring on the Connected Socket
+	bucket.start(options, packet_size);
+	if (options.uring_depth > 0 && stamp)
+	{
+		fprintf(stderr, "io_uring sends the registered payload unchanged, stamping with sendmsg()\n");
+	}
+	else if (options.uring_depth > 0 && bucket.active())
+	{
+		fprintf(stderr, "io_uring keeps the queue full, pacing with sendto()\n");
+	}
+	else if (options.uring_depth > 0)
+	{
+		if (connect(data_sock, (struct sockaddr *)&server, sizeof(server)) == -1)
+		{
+			perror("connect() failed");
+		}
+		else if (!(use_uring = uring_sender_setup(ring, options.uring_depth, data_sock, payload)))
+		{
+			fprintf(stderr, "io_uring is not available, sending with sendto()\n");
+		}
+	}
+
+	uint64_t send_start = monotonic_ns();
+
+	if (use_uring)
+	{
+		uring_send_datagrams(ring, payload, packet_size, num_packet, options.uring_depth, total_bytes);
+		send_calls = syscalls = ring.enter_calls();
+		send_batch_max = (num_packet < options.uring_depth) ? num_packet : options.uring_depth;
+	}
+
+	// Send Batches of Packets
+	for (int i = 0; i < num_packet && batch_size > 1 && !use_uring; )
+	{
+		int count = (num_packet - i < batch_size) ? num_packet - i : batch_size;
+		int sent;
+
+		// A Paced Batch is at most one Burst, the Tokens of a Retried Batch are already Taken
+		if (bucket.active())
+		{
+			if (count > bucket.burst_packets())
+				count = bucket.burst_packets();
+			if (count > prepaid)
+			{
+				bucket.take(count - prepaid);
+				prepaid = count;
+			}
+		}
+
+		syscalls++;
+		sent = send_batch(data_sock, server, payload, packet_size, i, count, num_packet, stamp, total_bytes);
+
+		if (sent == -1)
+		{
+			perror("sendmmsg() failed");
+			break;
+		}
+		if (sent == 0)
+		{
+			// Retry the batch once the socket is writable
+			wait_for_socket(data_sock, POLLOUT, SEND_TIMEOUT);
+			continue;
+		}
+
+		send_calls++;
+		if (sent > send_batch_max)
+			send_batch_max = sent;
+		i += sent;
+		prepaid = (prepaid > sent) ? prepaid - sent : 0;
+	}
+
+	// Send Packets
+	for (int i = 0; i < num_packet && batch_size <= 1 && !use_uring; i++)
+	{
+		if (!paid)
+		{
+			bucket.take(1);
+		}
+		paid = false;
+
+		syscalls++;
+		if (timestamps)
+		{
+			tx_stamps.reap();
+			tx_stamps.follow_up(follow_up);
+			app_ns = realtime_ns();
+			sent_bytes = send_stamped(data_sock, server, payload.packet(i), packet_size, i, num_packet, &follow_up);
+		}
+		else if (stamp)
+			sent_bytes = send_stamped(data_sock, server, payload.packet(i), packet_size, i, num_packet, NULL);
+		else
+			sent_bytes = sendto(data_sock, payload.packet(i), packet_size, 0, (struct sockaddr *)&server, sizeof(server));
+		trace.record(TRACE_SEND, i, packet_size, (int32_t)sent_bytes, (sent_bytes == -1) ? errno : 0);
+
+		if (sent_bytes == -1)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS)
+			{
+				// Retry the datagram once the socket is writable
+				wait_for_socket(data_sock, POLLOUT, SEND_TIMEOUT);
+				paid = true;
+				i--;
+				continue;
+			}
+			perror("sendto() failed");
+			break;
+		}
+		if (timestamps)
+		{
+			tx_stamps.sent(app_ns);
+		}
+		total_bytes += sent_bytes;
+		send_calls++;
+		send_batch_max = 1;
+	}
+
+	ring.close();
+
+	// Record Client Statistics
+	result.total_bytes = total_bytes;
+	result.packets = num_packet;
+	result.elapsed_ms = (monotonic_ns() - send_start) / 1e6;
+	result.pace_waits = bucket.waits();
+
+	// TX Timestamps of the Last Datagrams, for the Report
+	if (timestamps)
+	{
+		tx_stamps.finish(LATENCY_TIMEOUT);
+	}
+
+	// Wait for the Server's Loss Report of the Stamped Datagrams
+	if (stamp)
+	{
+		result.loss_rate = -1;
+		if (await_loss_report(data_sock, report_received, report_expected))
+		{
+			result.datagrams_lost = (long long)report_expected - report_received;
+			result.loss_rate = (report_expected > 0) ? 100.0 * result.datagrams_lost / report_expected : 0;
+		}
+	}
+	closesocket(data_sock);
+
+	result.datagrams_per_call = (send_calls > 0) ? (double)num_packet / send_calls : 0;
+	result.syscalls = syscalls;
+	result.segments = (long long)num_packet * ((gso_size > 0) ? (packet_size + gso_size - 1) / gso_size : 1);
+
+	// Append Data Information to print_output
+	print_output += "[UDP CLIENT]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Packets: ";
+	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
+	if (stamp)
+	{
+		print_output += " (sequence stamped)";
+	}
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(total_bytes);
+	print_output += " Bytes";
+	if (gso_size > 0)
+	{
+		print_output += "\nSegment Size (GSO): ";
+		print_output += std::to_string(gso_size);
+		print_output += " Bytes";
+		print_output += "\nNumber of Segments: ";
+		print_output += std::to_string(result.segments);
+	}
+	if (use_uring)
+	{
+		print_output += "\nEngine: io_uring (queue depth ";
+		print_output += std::to_string(options.uring_depth);
+		print_output += ")";
+	}
+	append_batch_report(print_output, result.datagrams_per_call, send_batch_max);
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(syscalls);
+	if (bucket.active())
+	{
+		bucket.append_report(print_output, total_bytes, result.elapsed_ms);
+	}
+	if (stamp)
+	{
+		char line[BUFFERSIZE];
+
+		if (result.loss_rate >= 0)
+			snprintf(line, sizeof(line), "\nServer Received: %u of %u Datagrams (%.3f%% loss)", report_received,
+				report_expected, result.loss_rate);
+		else
+			snprintf(line, sizeof(line), "\nServer Received: no loss report within %d ms", REPORT_TIMEOUT);
+		print_output += line;
+	}
+	if (timestamps)
+	{
+		tx_stamps.append_report(print_output);
+	}
+	append_settings(print_output, result.socket);
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		ramp_rate
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 17, 2026 [Find the Client limit from the pacing waits]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		ramp_rate(char *host, int port, int packet_size, int num_packet)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send in every step
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Searches the highest paced rate at which the Server loses at most --ramp percent of the datagrams. Every step is
+--	a stamped, paced transfer of num_packet datagrams, and its loss is taken from the Server's loss report. The rate
+--	starts at --bitrate (or --pps, or PACE_RAMP_START) and doubles while the loss stays within the limit, then is
+--	bisected between the last good and the first bad rate until they are within PACE_RAMP_PRECISION of each other.
+--	The search also ends when the Client cannot send at the target rate any more, which the TokenBucket shows as a
+--	step in which it seldom had to wait, or after PACE_RAMP_STEPS steps. The wall clock rate is not compared, since
+--	a step also loses the time of wakeups later than the bucket can catch up.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string UDP::ramp_rate(char *host, int port, int packet_size, int num_packet)
+{
+	TransferOptions step_options = options;
+	double rate = (options.pace_bps > 0) ? options.pace_bps
+		: (options.pace_pps > 0) ? options.pace_pps * packet_size * 8.0 : PACE_RAMP_START;
+	double good = 0;
+	double bad = 0;
+	std::string print_output;
+	char line[BUFFERSIZE];
+
+	step_options.ramp_loss = 0;
+	step_options.stamp = true;
+	step_options.pace_pps = 0;
+
+	print_output += "[UDP RAMP]";
+	snprintf(line, sizeof(line), "\nLoss Limit: %.3f%% of %d Packets of %d Bytes", options.ramp_loss, num_packet,
+		packet_size);
+	print_output += line;
+
+	for (int step = 1; step <= PACE_RAMP_STEPS; step++)
+	{
+		UDP step_connection;
+		double sent_bps;
+
+		step_options.pace_bps = rate;
+		step_connection.set_options(step_options);
+		step_connection.send_packet(host, port, packet_size, num_packet);
+
+		const TransferResult &step_result = step_connection.get_result();
+		if (step_result.loss_rate < 0)
+		{
+			print_output += "\nNo loss report from the Server, is it a udp-server?";
+			break;
+		}
+		sent_bps = (step_result.elapsed_ms > 0) ? step_result.total_bytes * 8.0 / (step_result.elapsed_ms / 1000.0) : 0;
+		snprintf(line, sizeof(line), "\nStep %d: %.2f Mbit/s target, %.2f Mbit/s sent, %.3f%% loss", step, rate / 1e6,
+			sent_bps / 1e6, step_result.loss_rate);
+		print_output += line;
+
+		if (step_result.loss_rate <= options.ramp_loss)
+		{
+			good = rate;
+
+			// The Client itself is the Limit: it Fell behind the Schedule instead of Waiting for Tokens
+			if (step_result.pace_waits * step_options.burst < num_packet / 2)
+			{
+				good = sent_bps;
+				print_output += "\nThe Client cannot send faster";
+				break;
+			}
+		}
+		else
+		{
+			bad = rate;
+		}
+
+		// Double up to the First Loss, then Bisect
+		if (bad == 0)
+			rate = good * 2;
+		else if (good == 0)
+			rate = bad / 2;
+		else if (bad - good <= bad * PACE_RAMP_PRECISION)
+			break;
+		else
+			rate = (good + bad) / 2;
+	}
+
+	result = TransferResult();
+	result.throughput_mbps = good / 1e6;
+	snprintf(line, sizeof(line), "\nMaximum Rate with at most %.3f%% Loss: %.2f Mbit/s (%.0f packets/s)",
+		options.ramp_loss, good / 1e6, good / 8.0 / packet_size);
+	print_output += line;
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send_reliable
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Reject transfers above RUDP_MAX_DATAGRAMS]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send_reliable(char *host, int port, int packet_size, int num_packet)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Sends the packets with the reliable UDP protocol (see rudp.cpp), with up to reliable_window datagrams in
+--	flight. The socket is connected so that only the Server's acknowledgements are received. The Payload has no EOT
+--	marker, since the transfer is ended by the FIN exchange. The throughput is the goodput: the packet bytes over
+--	the time until the Server answered the FIN.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string UDP::send_reliable(char *host, int port, int packet_size, int num_packet)
+{
+	SOCKET data_sock;
+	struct sockaddr_in server;
+	Payload payload;
+	RudpSendStats stats;
+	uint64_t send_start;
+	bool delivered;
+	char line[BUFFERSIZE];
+	std::string print_output;
+
+	result = TransferResult();
+
+	if (packet_size + (int)sizeof(RudpHeader) > UDP_DATAGRAM_MAX - 28)
+	{
+		fprintf(stderr, "A packet of %d Bytes does not fit in a datagram with the reliable UDP header\n", packet_size);
+		return "Error packet size";
+	}
+	if (num_packet > RUDP_MAX_DATAGRAMS)
+	{
+		fprintf(stderr, "Reliable UDP sends at most %d packets\n", RUDP_MAX_DATAGRAMS);
+		return "Error packet count";
+	}
+
+	// Generate the Data
+	if (!payload.prepare(options, packet_size, num_packet, false))
+	{
+		return "Error payload";
+	}
+
+	// Create Non-Blocking Datagram Socket, Connected to the Server
+	if ((data_sock = socket(AF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET)
+	{
+		perror("Cannot create socket");
+		return "Error socket()";
+	}
+	set_nonblocking(data_sock);
+	apply_tuning(data_sock, options.tuning, false);
+	result.socket = read_settings(data_sock, options.tuning, false);
+
+	memset(&server, 0, sizeof(struct sockaddr_in));
+	if (!resolve_host(host, port, server))
+	{
+		perror("Unknown server address");
+		closesocket(data_sock);
+		return "Error getaddrinfo()";
+	}
+	if (connect(data_sock, (struct sockaddr *)&server, sizeof(server)) == -1)
+	{
+		perror("connect() failed");
+		closesocket(data_sock);
+		return "Error connect()";
+	}
+
+	send_start = monotonic_ns();
+	delivered = rudp_send(data_sock, payload, packet_size, num_packet, options.reliable_window, stats);
+	closesocket(data_sock);
+
+	// Record Client Statistics
+	result.total_bytes = delivered ? (long long)packet_size * num_packet : 0;
+	result.packets = num_packet;
+	result.elapsed_ms = (monotonic_ns() - send_start) / 1e6;
+	result.throughput_mbps = (result.elapsed_ms > 0) ? result.total_bytes * 8.0 / (result.elapsed_ms * 1000.0) : 0;
+	result.datagrams_per_call = 1;
+	result.syscalls = stats.syscalls;
+	result.segments = stats.datagrams_sent;
+
+	// Append Data Information to print_output
+	print_output += "[UDP CLIENT]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Packets: ";
+	print_output += std::to_string(num_packet);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
+	print_output += "\nReliable UDP: ";
+	print_output += delivered ? "delivered" : "failed";
+	print_output += " (window ";
+	print_output += std::to_string(options.reliable_window);
+	print_output += " Datagrams)";
+	print_output += "\nDatagrams Sent: ";
+	print_output += std::to_string(stats.datagrams_sent);
+	print_output += " (";
+	print_output += std::to_string(stats.retransmits);
+	print_output += " retransmitted, ";
+	print_output += std::to_string(stats.timeouts);
+	print_output += " timeouts)";
+	print_output += "\nACKs Received: ";
+	print_output += std::to_string(stats.acks);
+	snprintf(line, sizeof(line), "\nSmoothed RTT: %.1f us (RTO %.1f us)", stats.srtt_us, stats.rto_us);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nElapsed Time: %.3f ms\nGoodput: %.2f Mbit/s", result.elapsed_ms, result.throughput_mbps);
+	print_output += line;
+	print_output += "\nTotal Data Transferred: ";
+	print_output += std::to_string(stats.bytes_sent);
+	print_output += " Bytes";
+	print_output += "\nSystem Calls: ";
+	print_output += std::to_string(stats.syscalls);
+	append_settings(print_output, result.socket);
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_packet
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Receive batches with recvmmsg]
+--					October 16, 2026 [Count GRO coalesced segments]
+--					October 16, 2026 [Receive through io_uring with --uring]
+--					October 16, 2026 [Collect the parts of the SO_REUSEPORT sockets]
+--					October 16, 2026 [Speak the reliable UDP protocol with --reliable]
+--					October 16, 2026 [Echo datagrams with --echo]
+--					October 16, 2026 [Send the loss report of stamped transfers]
+--					October 16, 2026 [Trace every call with --trace]
+--					October 16, 2026 [Kernel timestamps with --timestamps]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_packet(int port, SOCKET sock, std::string &print_string)
+--						int port: The Port the server is listening on
+--						SOCKET sock: The datagram socket passed by the EventLoop
+--						std::string &print_string: Set to the transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Receives datagrams from the Client. This function is called by the EventLoop handler on EVENT_READ and reads
+--	until the socket has no more datagrams queued, into a buffer from the shared receive pool. The timer is started on
+--	the first datagram of a transfer, and the transfer ends when a datagram ending in EOT arrives. With the io_uring
+--	engine the datagrams are read with windows of queued reads instead. With SO_REUSEPORT sockets the only socket of
+--	the main EventLoop is shard_notify, and the finished parts of the sockets are collected instead. In the reliable
+--	mode every datagram goes through receive_reliable, and the pending acknowledgement is sent once the socket is
+--	drained.
+----------------------------------------------------------------------------------------------------------------------*/
+void UDP::receive_packet([[maybe_unused]] int port, SOCKET sock, std::string &print_string)
+{
+	RecvBufferPool &pool = recv_pool();
+	TraceRing &trace = trace_ring();
+	char *packet_buf;
+	ssize_t received_bytes;
+	struct sockaddr_in source_addr;
+	struct iovec iov;
+	struct msghdr msg;
+	char control[GRO_CONTROL_SIZE + TIMESTAMP_CONTROL_SIZE];
+	uint32_t seq, total;
+	uint64_t send_ns;
+
+	// Parts Finished by the SO_REUSEPORT Sockets
+	if (sock == shard_notify)
+	{
+		collect_shards(result, print_string);
+		return;
+	}
+
+	// Receive Datagrams through io_uring
+	if (recv_ring.is_ready())
+	{
+		uring_receive(recv_ring, recv_slots, URING_SLOT_SIZE,
+			[this, &print_string](const char *data, ssize_t len, int call_index)
+			{
+				if (call_index == 0)
+					recv_last = monotonic_ns();
+				record_datagram(data, len, 1, call_index, result, print_string);
+				return true;
+			});
+		return;
+	}
+
+	if (options.batch_size > 1 && options.reliable_window == 0 && !options.echo && !rx_timestamps)
+	{
+		receive_batch(sock, print_string);
+		return;
+	}
+
+	if ((packet_buf = pool.acquire()) == NULL)
+	{
+		return;
+	}
+
+	iov.iov_base = packet_buf;
+	iov.iov_len = pool.buffer_size();
+
+	// Receive Data from Socket
+	do
+	{
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_name = &source_addr;
+		msg.msg_namelen = sizeof(source_addr);
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		recv_syscalls++;
+		received_bytes = recvmsg(sock, &msg, 0);
+		trace.record(TRACE_RECV, trace_seq(trace, packet_buf, received_bytes, recv_syscalls), (uint32_t)iov.iov_len,
+			(int32_t)received_bytes, (received_bytes == -1) ? errno : 0);
+		if (received_bytes == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				perror("recvmsg() failed");
+			}
+
+			// Acknowledge what the Drained Socket Delivered
+			if (reliable_transfer && receiving && rudp_receiver.ack_pending())
+			{
+				send_ack(sock);
+			}
+
+			// Wait for the next EVENT_READ
+			pool.release(packet_buf);
+			return;
+		}
+
+		recv_last = monotonic_ns();
+		recv_source = source_addr;
+		if (rx_timestamps && sequence_parse(packet_buf, received_bytes, seq, total, send_ns))
+		{
+			if (!receiving)
+			{
+				recv_delay.start();
+			}
+			recv_delay.received(packet_buf, received_bytes, seq, msg, realtime_ns());
+		}
+		if (options.reliable_window > 0)
+		{
+			receive_reliable(sock, source_addr, packet_buf, received_bytes, result, print_string);
+			continue;
+		}
+		if (options.echo && sendto(sock, packet_buf, received_bytes, 0, (struct sockaddr *)&source_addr,
+			msg.msg_namelen) == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			perror("sendto() failed");
+		}
+		record_datagram(packet_buf, received_bytes, gro_segments(msg, received_bytes), 0, result, print_string);
+	} while (true);
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		receive_batch
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Count GRO coalesced segments]
+--					October 16, 2026 [Count system calls]
+--					October 16, 2026 [Send the loss report of stamped transfers]
+--					October 16, 2026 [Trace every call with --trace]
+--					October 17, 2026 [Check the receive buffers for NULL]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		receive_batch(SOCKET sock, std::string &print_string)
+--						SOCKET sock: The datagram socket passed by the EventLoop
+--						std::string &print_string: Set to the transfer statistics when the transfer ends
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	The batched counterpart of receive_packet. Each recvmmsg call receives up to batch_size datagrams into slots of
+--	UDP_DATAGRAM_MAX Bytes carved out of pool buffers. Every datagram of a batch gets the arrival time of the call
+--	that returned it.
+----------------------------------------------------------------------------------------------------------------------*/
+void UDP::receive_batch(SOCKET sock, std::string &print_string)
+{
+	RecvBufferPool &pool = recv_pool();
+	TraceRing &trace = trace_ring();
+	int batch_size = options.batch_size;
+	int slots_per_buffer = (int)(pool.buffer_size() / UDP_DATAGRAM_MAX);
+	std::vector<char *> buffers;
+	std::vector<struct mmsghdr> msgs(batch_size);
+	std::vector<struct iovec> iovecs(batch_size);
+	std::vector<struct sockaddr_in> addrs(batch_size);
+	std::vector<char> controls((size_t)batch_size * GRO_CONTROL_SIZE);
+	int received;
+
+	// Carve the Datagram Slots out of Pool Buffers
+	for (int i = 0; i < batch_size; i++)
+	{
+		if (i % slots_per_buffer == 0)
+		{
+			buffers.push_back(pool.acquire());
+			if (buffers.back() == NULL)
+			{
+				for (char *buf : buffers)
+				{
+					pool.release(buf);
+				}
+				return;
+			}
+		}
+		iovecs[i].iov_base = buffers.back() + (size_t)(i % slots_per_buffer) * UDP_DATAGRAM_MAX;
+		iovecs[i].iov_len = UDP_DATAGRAM_MAX;
+	}
+
+	// Receive Data from Socket
+	do
+	{
+		for (int i = 0; i < batch_size; i++)
+		{
+			memset(&msgs[i], 0, sizeof(struct mmsghdr));
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+			msgs[i].msg_hdr.msg_iov = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_control = &controls[(size_t)i * GRO_CONTROL_SIZE];
+			msgs[i].msg_hdr.msg_controllen = GRO_CONTROL_SIZE;
+		}
+
+		recv_syscalls++;
+		if ((received = recvmmsg(sock, msgs.data(), batch_size, MSG_DONTWAIT, NULL)) == -1)
+		{
+			trace.record(TRACE_RECV_BATCH, (uint32_t)recv_syscalls, 0, -1, errno);
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				perror("recvmmsg() failed");
+			}
+			break;
+		}
+
+		recv_last = monotonic_ns();
+		for (int i = 0; i < received; i++)
+		{
+			trace.record(TRACE_RECV_BATCH, trace_seq(trace, (const char *)iovecs[i].iov_base, msgs[i].msg_len,
+				recv_syscalls), msgs[i].msg_len, received, 0);
+			recv_source = addrs[i];
+			record_datagram((const char *)iovecs[i].iov_base, msgs[i].msg_len,
+				gro_segments(msgs[i].msg_hdr, msgs[i].msg_len), i, result, print_string);
+		}
+	} while (true);
+
+	// Wait for the next EVENT_READ
+	for (char *buf : buffers)
+	{
+		pool.release(buf);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		check_timeout
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Reliable sessions wait RUDP_GIVE_UP_MS]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		check_timeout(std::string &print_string)
+--						std::string &print_string: Set to the transfer statistics if the transfer timed out
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Called by the EventLoop handler on EVENT_IDLE. If the datagram carrying EOT was lost, the transfer in progress is
+--	ended once no datagram has arrived for UDP_IDLE_TIMEOUT ms. A reliable session waits as long as its Client
+--	retransmits (RUDP_GIVE_UP_MS), since an idle period there means the Client is backing off.
+----------------------------------------------------------------------------------------------------------------------*/
+void UDP::check_timeout(std::string &print_string)
+{
+	uint64_t timeout_ms = reliable_transfer ? RUDP_GIVE_UP_MS : UDP_IDLE_TIMEOUT;
+
+	if (receiving && monotonic_ns() - recv_last >= timeout_ms * 1000000ULL)
+	{
+		if (reliable_transfer)
+		{
+			rudp_finished_session = rudp_receiver.session();
+		}
+		finish_transfer(result, print_string);
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		echo_datagram
+--
+--	DATE:			October 17, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		echo_datagram(AsyncSocket &conn, char *request, char *reply, int packet_size, uint32_t seq,
+--						int num_request, bool stamp)
+--						AsyncSocket &conn: Connected socket of the worker
+--						char *request: Request to send, stamped in place
+--						char *reply: Buffer the echo is read into
+--						int packet_size: Size of the request and of its echo in Bytes
+--						uint32_t seq: Number of the request
+--						int num_request: Number of requests of the run
+--						bool stamp: Stamp the request, so its echo can be told from a late echo of an earlier one
+--
+--	RETURNS:		Task<RequestStatus> - REQUEST_DONE when the echo came back, REQUEST_LOST when it did not within
+--					LATENCY_TIMEOUT ms, REQUEST_FAILED on a socket error.
+--
+--	NOTES:
+--	One request of measure_latency as a coroutine. A datagram is sent whole or not at all, so AsyncSocket::send
+--	sends it in one call.
+----------------------------------------------------------------------------------------------------------------------*/
+static Task<RequestStatus> echo_datagram(AsyncSocket &conn, char *request, char *reply, int packet_size, uint32_t seq,
+	int num_request, bool stamp)
+{
+	SequenceStamp request_stamp;
+	uint32_t reply_seq, total;
+	uint64_t send_ns;
+	uint64_t deadline_ns = monotonic_ns() + LATENCY_TIMEOUT * 1000000ULL;
+	long long received_bytes;
+
+	if (stamp)
+	{
+		sequence_stamp(request_stamp, seq, num_request, monotonic_ns());
+		memcpy(request, &request_stamp, sizeof(request_stamp));
+	}
+
+	if (co_await conn.send(request, packet_size) == -1)
+	{
+		perror("send() failed");
+		co_return REQUEST_FAILED;
+	}
+
+	// Wait for the Echo of this Request
+	while (true)
+	{
+		if ((received_bytes = co_await conn.recv(reply, packet_size, deadline_ns)) == -1)
+		{
+			if (errno == ETIMEDOUT)
+			{
+				co_return REQUEST_LOST;
+			}
+			perror("recv() failed (is the server running with --echo?)");
+			co_return REQUEST_FAILED;
+		}
+		if (!stamp || (sequence_parse(reply, received_bytes, reply_seq, total, send_ns) && reply_seq == seq))
+		{
+			co_return REQUEST_DONE;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		measure_latency
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Applied the socket tuning and reported the effective settings]
+--					October 17, 2026 [Run every worker as an echo_datagram coroutine on one Executor]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		measure_latency(char *host, int port, int packet_size, int num_request)
+--						char *host: Host IP
+--						int port: The Port the server is listening on
+--						int packet_size: Size of a request in Bytes
+--						int num_request: Number of requests to send
+--
+--	RETURNS:		std::string - output string.
+--
+--	NOTES:
+--	Sends num_request datagrams of packet_size Bytes to a Server started with --echo, and waits up to
+--	LATENCY_TIMEOUT ms for each to come back before counting it as lost. Every worker has its own connected socket,
+--	and the sockets of all workers are driven by one Executor on this thread. A request of more than a SequenceStamp
+--	carries a stamp, so a late echo of an earlier request is recognised and skipped, and the Server can report the
+--	loss on the way in.
+----------------------------------------------------------------------------------------------------------------------*/
+std::string UDP::measure_latency(char *host, int port, int packet_size, int num_request)
+{
+	LatencyRun run;
+	std::vector<SOCKET> socks;
+	Executor executor;
+	std::vector<std::unique_ptr<AsyncSocket>> conns;
+	std::vector<std::vector<char>> requests;
+	std::vector<std::vector<char>> replies;
+	struct sockaddr_in server;
+	Payload payload;
+	bool stamp = packet_size > (int)sizeof(SequenceStamp);
+	std::string print_output;
+
+	result = TransferResult();
+	run.concurrency = options.concurrency;
+	run.num_request = num_request;
+	run.rate = options.request_rate;
+
+	if (!payload.prepare(options, packet_size, 1, false))
+	{
+		return "Error payload";
+	}
+
+	if (!executor.is_ready())
+	{
+		return "Error epoll";
+	}
+
+	// Resolve Host
+	memset(&server, 0, sizeof(struct sockaddr_in));
+	if (!resolve_host(host, port, server))
+	{
+		perror("Unknown server address");
+		return "Error getaddrinfo()";
+	}
+
+	// Connect every Worker, so it only Receives the Server's Echoes
+	raise_file_limit(run.concurrency + FILE_LIMIT_SPARE);
+	for (int w = 0; w < run.concurrency; w++)
+	{
+		SOCKET sock;
+
+		if ((sock = socket(AF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET
+			|| connect(sock, (struct sockaddr *)&server, sizeof(server)) == -1)
+		{
+			perror("Cannot create socket");
+			if (sock != INVALID_SOCKET)
+				closesocket(sock);
+			for (SOCKET open_sock : socks)
+			{
+				closesocket(open_sock);
+			}
+			return "Error socket()";
+		}
+		set_nonblocking(sock);
+		apply_tuning(sock, options.tuning, false);
+		if (socks.empty())
+		{
+			result.socket = read_settings(sock, options.tuning, false);
+		}
+		socks.push_back(sock);
+		requests.emplace_back(payload.packet(0), payload.packet(0) + packet_size);
+		replies.emplace_back(packet_size);
+		conns.emplace_back(new AsyncSocket(executor, sock));
+	}
+
+	run_latency(run, executor, [&](int w, uint32_t seq) -> Task<RequestStatus>
+	{
+		return echo_datagram(*conns[w], requests[w].data(), replies[w].data(), packet_size, seq, num_request, stamp);
+	});
+
+	// Deregister the Sockets before Closing them
+	conns.clear();
+	for (SOCKET sock : socks)
+	{
+		closesocket(sock);
+	}
+	result.total_bytes = run.completed * packet_size;
+
+	// Append Latency Information to print_output
+	print_output += "[UDP LATENCY]";
+	print_output += "\nHost: ";
+	print_output += host;
+	print_output += "\nPort: ";
+	print_output += std::to_string(port);
+	print_output += "\nPacket Size: ";
+	print_output += std::to_string(packet_size);
+	print_output += " Bytes";
+	print_output += "\nNumber of Requests: ";
+	print_output += std::to_string(num_request);
+	print_output += "\nPayload: ";
+	print_output += payload.mode_name();
+	append_latency_report(print_output, run, result);
+	append_settings(print_output, result.socket);
+
+	return print_output;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		end_connection
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    October 16, 2026 [Release the io_uring ring]
+--					October 16, 2026 [Release the SO_REUSEPORT sockets]
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		end_connection()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Closes the datagram sockets so that the server can be started again on the same port.
+----------------------------------------------------------------------------------------------------------------------*/
+void UDP::end_connection()
+{
+	if (udp_sock != INVALID_SOCKET)
+	{
+		recv_ring.unregister_file();
+		closesocket(udp_sock);
+		udp_sock = INVALID_SOCKET;
+	}
+	uring_receiver_release(recv_ring, recv_ring_buffers, recv_slots);
+	release_shards();
+	receiving = false;
+}
+
+#endif
@@ -0,0 +1,969 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	uring.cpp - io_uring I/O engine for the TCP and UDP transfers (Linux)
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					bool setup(unsigned entries)
+--					void close()
+--					bool register_buffers(const std::vector<struct iovec> &iovecs)
+--					bool register_file(int fd)
+--					void unregister_file()
+--					bool queue_read(void *buf, size_t len, uint64_t user_data)
+--					bool queue_write(const void *buf, size_t len, uint64_t user_data, bool link)
+--					int submit(unsigned wait_nr)
+--					bool reap(UringCompletion &completion)
+--					bool uring_sender_setup(IoUring &ring, int depth, SOCKET sock, const Payload &payload)
+--					bool uring_receiver_setup(IoUring &ring, int depth, std::vector<char *> &buffers,
+--						std::vector<char *> &slots)
+--					void uring_receiver_release(IoUring &ring, std::vector<char *> &buffers, std::vector<char *> &slots)
+--					bool uring_send_stream(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+--						long long &total_bytes)
+--					bool uring_send_datagrams(IoUring &ring, Payload &payload, int packet_size, int num_packet,
+--						int depth, long long &total_bytes)
+--					int uring_receive(IoUring &ring, const std::vector<char *> &slots, size_t slot_size,
+--						const UringDataHandler &handler)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	The synchronous loops make one system call per send or receive. The io_uring engine keeps up to a queue depth
+--	of operations in flight and submits and reaps them with a single io_uring_enter call. The transfer buffers are
+--	registered with the ring (READ_FIXED/WRITE_FIXED) so the kernel does not map them on every operation, and the
+--	socket is registered as a fixed file.
+--
+--	The ring is driven with the raw io_uring_setup/io_uring_enter/io_uring_register system calls, so there is no
+--	dependency on liburing. The submission and completion ring indexes are shared with the kernel and accessed with
+--	acquire/release atomics.
+--
+--	Sends on a TCP stream must complete in order, so the stream sender submits each window of depth writes as one
+--	linked chain and waits for the whole window before the next. A short write ends the chain (the rest of the
+--	window is cancelled) and the remainder is sent first in the next window. Datagrams have no order, so the
+--	datagram sender keeps depth writes in flight at all times, except that the last datagram (carrying EOT) is only
+--	sent once every other datagram has completed.
+--
+--	Receives are flagged RWF_NOWAIT, so every read of a window is issued in submission order during io_uring_enter
+--	and either returns data or -EAGAIN, and the data is handed on in stream order.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifdef __linux__
+
+#include "uring.h"
+#include "payload.h"
+#include "recv_pool.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <algorithm>
+
+// Shared Ring Index Access
+#define load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		setup
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		setup(unsigned entries)
+--						unsigned entries: Size of the submission queue (the queue depth)
+--
+--	RETURNS:		bool - false if io_uring is not available.
+--
+--	NOTES:
+--	Creates the ring and maps its submission queue, completion queue and submission entries.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::setup(unsigned entries)
+{
+	struct io_uring_params params;
+
+	close();
+	memset(&params, 0, sizeof(params));
+
+	if ((ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params)) == -1)
+	{
+		perror("io_uring_setup() failed");
+		return false;
+	}
+
+	sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+	}
+
+	// Map the Rings
+	sq_ring = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	if (sq_ring == MAP_FAILED)
+	{
+		sq_ring = NULL;
+		perror("mmap() of io_uring failed");
+		close();
+		return false;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		cq_ring = sq_ring;
+	}
+	else if ((cq_ring = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+		IORING_OFF_CQ_RING)) == MAP_FAILED)
+	{
+		cq_ring = NULL;
+		perror("mmap() of io_uring failed");
+		close();
+		return false;
+	}
+
+	sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	if ((sqes = (struct io_uring_sqe *)mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		ring_fd, IORING_OFF_SQES)) == MAP_FAILED)
+	{
+		sqes = NULL;
+		perror("mmap() of io_uring failed");
+		close();
+		return false;
+	}
+
+	sq_head = (unsigned *)((char *)sq_ring + params.sq_off.head);
+	sq_tail = (unsigned *)((char *)sq_ring + params.sq_off.tail);
+	sq_mask = (unsigned *)((char *)sq_ring + params.sq_off.ring_mask);
+	sq_array = (unsigned *)((char *)sq_ring + params.sq_off.array);
+	sq_entries = params.sq_entries;
+	cq_head = (unsigned *)((char *)cq_ring + params.cq_off.head);
+	cq_tail = (unsigned *)((char *)cq_ring + params.cq_off.tail);
+	cq_mask = (unsigned *)((char *)cq_ring + params.cq_off.ring_mask);
+	cqes = (struct io_uring_cqe *)((char *)cq_ring + params.cq_off.cqes);
+
+	queued = 0;
+	enters = 0;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		close
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		close()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Unmaps the rings and closes the ring, which also unregisters its buffers and files.
+----------------------------------------------------------------------------------------------------------------------*/
+void IoUring::close()
+{
+	if (sqes != NULL)
+		munmap(sqes, sqes_size);
+	if (cq_ring != NULL && cq_ring != sq_ring)
+		munmap(cq_ring, cq_ring_size);
+	if (sq_ring != NULL)
+		munmap(sq_ring, sq_ring_size);
+	if (ring_fd != -1)
+		::close(ring_fd);
+
+	sqes = NULL;
+	cq_ring = NULL;
+	sq_ring = NULL;
+	ring_fd = -1;
+	file_fd = -1;
+	file_registered = false;
+	registered.clear();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		register_buffers
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		register_buffers(const std::vector<struct iovec> &iovecs)
+--						const std::vector<struct iovec> &iovecs: Memory regions the transfer reads or writes
+--
+--	RETURNS:		bool - false if the buffers could not be registered (the engine then uses plain reads and writes).
+--
+--	NOTES:
+--	Registers the buffers with the ring. Operations on memory inside a registered buffer use READ_FIXED and
+--	WRITE_FIXED.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::register_buffers(const std::vector<struct iovec> &iovecs)
+{
+	if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), (unsigned)iovecs.size()) == -1)
+	{
+		perror("io_uring_register(IORING_REGISTER_BUFFERS) failed");
+		return false;
+	}
+
+	registered = iovecs;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		register_file
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		register_file(int fd)
+--						int fd: Socket the queued operations work on
+--
+--	RETURNS:		bool - false if the socket could not be registered (it is then used as a normal descriptor).
+--
+--	NOTES:
+--	Sets the socket of the following operations. It is registered as fixed file 0, which saves the kernel the
+--	descriptor lookup on every operation. A new connection replaces the registered socket.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::register_file(int fd)
+{
+	file_fd = fd;
+
+	if (file_registered)
+	{
+		struct io_uring_files_update update;
+
+		memset(&update, 0, sizeof(update));
+		update.offset = 0;
+		update.fds = (uint64_t)(uintptr_t)&file_fd;
+		if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_FILES_UPDATE, &update, 1) == 1)
+		{
+			return true;
+		}
+	}
+	else if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_FILES, &file_fd, 1) == 0)
+	{
+		file_registered = true;
+		return true;
+	}
+
+	perror("io_uring_register(IORING_REGISTER_FILES) failed");
+	file_registered = false;
+	return false;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		unregister_file
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		unregister_file()
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Must be called before the registered socket is closed. The registration holds a reference to the socket, so
+--	closing it would neither release it nor remove it from the EventLoop.
+----------------------------------------------------------------------------------------------------------------------*/
+void IoUring::unregister_file()
+{
+	if (file_registered)
+	{
+		syscall(__NR_io_uring_register, ring_fd, IORING_UNREGISTER_FILES, NULL, 0);
+		file_registered = false;
+	}
+	file_fd = -1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		fixed_buffer
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		fixed_buffer(const void *data, size_t len)
+--						const void *data: Start of the memory an operation uses
+--						size_t len: Length of the memory
+--
+--	RETURNS:		int - index of the registered buffer holding the memory, or -1.
+--
+--	NOTES:
+--	Looks up the registered buffer an operation can use.
+----------------------------------------------------------------------------------------------------------------------*/
+int IoUring::fixed_buffer(const void *data, size_t len) const
+{
+	const char *start = (const char *)data;
+
+	for (size_t i = 0; i < registered.size(); i++)
+	{
+		const char *base = (const char *)registered[i].iov_base;
+
+		if (start >= base && start + len <= base + registered[i].iov_len)
+		{
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		next_sqe
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		next_sqe()
+--
+--	RETURNS:		struct io_uring_sqe * - the next free submission entry, or NULL if the queue is full.
+--
+--	NOTES:
+--	Entries are used in ring order, so the submission array maps every slot to the entry of the same index.
+----------------------------------------------------------------------------------------------------------------------*/
+struct io_uring_sqe *IoUring::next_sqe()
+{
+	unsigned tail = *sq_tail + queued;
+
+	if (tail - load_acquire(sq_head) >= sq_entries)
+	{
+		return NULL;
+	}
+
+	sq_array[tail & *sq_mask] = tail & *sq_mask;
+	queued++;
+	return &sqes[tail & *sq_mask];
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		prep_rw
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		prep_rw(struct io_uring_sqe *sqe, int op, const void *buf, size_t len, uint64_t user_data)
+--						struct io_uring_sqe *sqe: Entry to fill
+--						int op: IORING_OP_READ or IORING_OP_WRITE
+--						const void *buf: Memory to read into or write from
+--						size_t len: Length of the operation
+--						uint64_t user_data: Returned with the completion
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Fills a read or write entry on the registered socket, switching to the fixed variant when the memory is inside a
+--	registered buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+void IoUring::prep_rw(struct io_uring_sqe *sqe, int op, const void *buf, size_t len, uint64_t user_data)
+{
+	int buf_index = fixed_buffer(buf, len);
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = (uint8_t)op;
+	sqe->addr = (uint64_t)(uintptr_t)buf;
+	sqe->len = (uint32_t)len;
+	sqe->user_data = user_data;
+
+	if (buf_index >= 0)
+	{
+		sqe->opcode = (op == IORING_OP_READ) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+		sqe->buf_index = (uint16_t)buf_index;
+	}
+
+	if (file_registered)
+	{
+		sqe->fd = 0;
+		sqe->flags |= IOSQE_FIXED_FILE;
+	}
+	else
+	{
+		sqe->fd = file_fd;
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		queue_read
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		queue_read(void *buf, size_t len, uint64_t user_data)
+--						void *buf: Memory to read into
+--						size_t len: Maximum number of bytes to read
+--						uint64_t user_data: Returned with the completion
+--
+--	RETURNS:		bool - false if the submission queue is full.
+--
+--	NOTES:
+--	Queues a read from the registered socket. Nothing is sent to the kernel until submit. io_uring ignores
+--	O_NONBLOCK on sockets and would park a read without data until data arrives, letting later reads overtake it,
+--	so the read is flagged RWF_NOWAIT and completes with -EAGAIN instead.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::queue_read(void *buf, size_t len, uint64_t user_data)
+{
+	struct io_uring_sqe *sqe;
+
+	if ((sqe = next_sqe()) == NULL)
+	{
+		return false;
+	}
+
+	prep_rw(sqe, IORING_OP_READ, buf, len, user_data);
+
+	// Fail with -EAGAIN instead of Waiting for Data
+	sqe->rw_flags = RWF_NOWAIT;
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		queue_write
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		queue_write(const void *buf, size_t len, uint64_t user_data, bool link)
+--						const void *buf: Memory to write
+--						size_t len: Number of bytes to write
+--						uint64_t user_data: Returned with the completion
+--						bool link: The next queued operation only starts once this one has completed
+--
+--	RETURNS:		bool - false if the submission queue is full.
+--
+--	NOTES:
+--	Queues a write to the registered socket. Nothing is sent to the kernel until submit.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::queue_write(const void *buf, size_t len, uint64_t user_data, bool link)
+{
+	struct io_uring_sqe *sqe;
+
+	if ((sqe = next_sqe()) == NULL)
+	{
+		return false;
+	}
+
+	prep_rw(sqe, IORING_OP_WRITE, buf, len, user_data);
+	if (link)
+	{
+		sqe->flags |= IOSQE_IO_LINK;
+	}
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		submit
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		submit(unsigned wait_nr)
+--						unsigned wait_nr: Number of completions to wait for
+--
+--	RETURNS:		int - the number of operations submitted, or -1 on error.
+--
+--	NOTES:
+--	Hands the queued operations to the kernel and waits for completions with one io_uring_enter call. The call is
+--	repeated if it is interrupted by a signal.
+----------------------------------------------------------------------------------------------------------------------*/
+int IoUring::submit(unsigned wait_nr)
+{
+	unsigned to_submit = queued;
+	int submitted;
+
+	// Publish the Queued Entries
+	store_release(sq_tail, *sq_tail + queued);
+	queued = 0;
+
+	do
+	{
+		enters++;
+		submitted = (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, wait_nr,
+			(wait_nr > 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	} while (submitted == -1 && errno == EINTR);
+
+	if (submitted == -1)
+	{
+		perror("io_uring_enter() failed");
+	}
+	return submitted;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		reap
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		reap(UringCompletion &completion)
+--						UringCompletion &completion: Set to the next completion
+--
+--	RETURNS:		bool - false if no completion is waiting.
+--
+--	NOTES:
+--	Takes one completion off the completion queue without a system call.
+----------------------------------------------------------------------------------------------------------------------*/
+bool IoUring::reap(UringCompletion &completion)
+{
+	unsigned head = *cq_head;
+
+	if (head == load_acquire(cq_tail))
+	{
+		return false;
+	}
+
+	completion.user_data = cqes[head & *cq_mask].user_data;
+	completion.result = cqes[head & *cq_mask].res;
+	store_release(cq_head, head + 1);
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_sender_setup
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_sender_setup(IoUring &ring, int depth, SOCKET sock, const Payload &payload)
+--						IoUring &ring: Ring to set up
+--						int depth: Queue depth
+--						SOCKET sock: Connected socket of the Client
+--						const Payload &payload: Prepared data of the transfer
+--
+--	RETURNS:		bool - false if io_uring is not available (the caller then sends with the socket calls).
+--
+--	NOTES:
+--	Sets up the Client ring, registers the payload and the socket, and puts the socket into blocking mode.
+----------------------------------------------------------------------------------------------------------------------*/
+bool uring_sender_setup(IoUring &ring, int depth, SOCKET sock, const Payload &payload)
+{
+	if (!ring.setup(depth))
+	{
+		return false;
+	}
+
+	ring.register_buffers(payload.buffers());
+	ring.register_file(sock);
+	set_blocking(sock);
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_receiver_setup
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_receiver_setup(IoUring &ring, int depth, std::vector<char *> &buffers,
+--						std::vector<char *> &slots)
+--						IoUring &ring: Ring to set up
+--						int depth: Queue depth, the number of receive slots
+--						std::vector<char *> &buffers: Set to the pool buffers holding the slots
+--						std::vector<char *> &slots: Set to the receive slots
+--
+--	RETURNS:		bool - false if io_uring is not available (the caller then receives with the socket calls).
+--
+--	NOTES:
+--	Sets up the Server ring. The receive slots of URING_SLOT_SIZE Bytes are carved out of pool buffers, which are
+--	registered with the ring and held until uring_receiver_release. The socket is registered on every connection.
+----------------------------------------------------------------------------------------------------------------------*/
+bool uring_receiver_setup(IoUring &ring, int depth, std::vector<char *> &buffers, std::vector<char *> &slots)
+{
+	RecvBufferPool &pool = recv_pool();
+	int slots_per_buffer = (int)(pool.buffer_size() / URING_SLOT_SIZE);
+	std::vector<struct iovec> iovecs;
+	struct iovec iov;
+
+	if (!ring.setup(depth))
+	{
+		return false;
+	}
+
+	// Carve the Slots out of Pool Buffers
+	for (int i = 0; i < depth; i++)
+	{
+		if (i % slots_per_buffer == 0)
+		{
+			buffers.push_back(pool.acquire());
+			iov.iov_base = buffers.back();
+			iov.iov_len = pool.buffer_size();
+			iovecs.push_back(iov);
+		}
+		slots.push_back(buffers.back() + (size_t)(i % slots_per_buffer) * URING_SLOT_SIZE);
+	}
+
+	ring.register_buffers(iovecs);
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_receiver_release
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_receiver_release(IoUring &ring, std::vector<char *> &buffers, std::vector<char *> &slots)
+--						IoUring &ring: Ring set up by uring_receiver_setup
+--						std::vector<char *> &buffers: Pool buffers holding the slots
+--						std::vector<char *> &slots: Receive slots
+--
+--	RETURNS:		void.
+--
+--	NOTES:
+--	Closes the Server ring and returns its buffers to the pool.
+----------------------------------------------------------------------------------------------------------------------*/
+void uring_receiver_release(IoUring &ring, std::vector<char *> &buffers, std::vector<char *> &slots)
+{
+	ring.close();
+
+	for (char *buf : buffers)
+	{
+		recv_pool().release(buf);
+	}
+	buffers.clear();
+	slots.clear();
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_send_stream
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_send_stream(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+--						long long &total_bytes)
+--						IoUring &ring: Ring with the connected (blocking) stream socket registered
+--						Payload &payload: Data of the transfer
+--						int packet_size: Size of a packet in Bytes
+--						int num_packet: Number of packets to send
+--						int depth: Number of writes per window
+--						long long &total_bytes: Incremented by the number of bytes sent
+--
+--	RETURNS:		bool - true if every packet was sent.
+--
+--	NOTES:
+--	Sends the packets in windows of depth linked writes, one io_uring_enter per window. Writes after a short or
+--	failed write are cancelled by the kernel and sent again, in order, in the next window.
+----------------------------------------------------------------------------------------------------------------------*/
+bool uring_send_stream(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+	long long &total_bytes)
+{
+	// Packet Index and Bytes of it Already Sent
+	std::vector<std::pair<int, int>> window;
+	std::vector<std::pair<int, int>> retry;
+	std::vector<int> results(depth);
+	UringCompletion completion;
+	int next = 0;
+
+	while (next < num_packet || !retry.empty())
+	{
+		window.swap(retry);
+		retry.clear();
+		while ((int)window.size() < depth && next < num_packet)
+		{
+			window.push_back(std::make_pair(next++, 0));
+		}
+
+		// Queue the Window as one Chain
+		for (size_t k = 0; k < window.size(); k++)
+		{
+			const char *data = payload.packet(window[k].first) + window[k].second;
+			ring.queue_write(data, packet_size - window[k].second, k, k + 1 < window.size());
+		}
+
+		if (ring.submit((unsigned)window.size()) == -1)
+		{
+			return false;
+		}
+
+		for (size_t k = 0; k < window.size(); k++)
+		{
+			while (!ring.reap(completion))
+			{
+				if (ring.submit(1) == -1)
+					return false;
+			}
+			results[completion.user_data] = completion.result;
+		}
+
+		// Carry Short, Cancelled and Interrupted Writes into the next Window
+		for (size_t k = 0; k < window.size(); k++)
+		{
+			int remaining = packet_size - window[k].second;
+
+			if (results[k] == remaining)
+			{
+				total_bytes += results[k];
+			}
+			else if (results[k] > 0)
+			{
+				total_bytes += results[k];
+				retry.push_back(std::make_pair(window[k].first, window[k].second + results[k]));
+			}
+			else if (results[k] == -ECANCELED || results[k] == -EAGAIN || results[k] == -EINTR)
+			{
+				retry.push_back(window[k]);
+			}
+			else
+			{
+				errno = -results[k];
+				perror("io_uring write failed");
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_send_datagrams
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_send_datagrams(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+--						long long &total_bytes)
+--						IoUring &ring: Ring with the connected (blocking) datagram socket registered
+--						Payload &payload: Data of the transfer
+--						int packet_size: Size of a datagram in Bytes
+--						int num_packet: Number of datagrams to send
+--						int depth: Number of writes kept in flight
+--						long long &total_bytes: Incremented by the number of bytes sent
+--
+--	RETURNS:		bool - true if every datagram was sent.
+--
+--	NOTES:
+--	Keeps depth datagram writes in flight, refilling the queue as writes complete. Each io_uring_enter submits the
+--	new writes and waits for at least one completion. The last datagram is held back until all others completed,
+--	so the EOT marker is not overtaken.
+----------------------------------------------------------------------------------------------------------------------*/
+bool uring_send_datagrams(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+	long long &total_bytes)
+{
+	std::vector<int> retry;
+	UringCompletion completion;
+	int next = 0;
+	int in_flight = 0;
+
+	while (next < num_packet || !retry.empty() || in_flight > 0)
+	{
+		// Refill the Queue
+		while (in_flight < depth && (!retry.empty() || next < num_packet))
+		{
+			int index;
+
+			if (!retry.empty())
+			{
+				index = retry.back();
+				retry.pop_back();
+			}
+			else if (next < num_packet - 1 || in_flight == 0)
+			{
+				index = next++;
+			}
+			else
+			{
+				break;
+			}
+
+			ring.queue_write(payload.packet(index), packet_size, index, false);
+			in_flight++;
+		}
+
+		if (ring.submit(1) == -1)
+		{
+			return false;
+		}
+
+		while (ring.reap(completion))
+		{
+			in_flight--;
+			if (completion.result > 0)
+			{
+				total_bytes += completion.result;
+			}
+			else if (completion.result == -EAGAIN || completion.result == -ENOBUFS || completion.result == -EINTR)
+			{
+				retry.push_back((int)completion.user_data);
+			}
+			else
+			{
+				errno = -completion.result;
+				perror("io_uring write failed");
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		uring_receive
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		uring_receive(IoUring &ring, const std::vector<char *> &slots, size_t slot_size,
+--						const UringDataHandler &handler)
+--						IoUring &ring: Ring with the non-blocking socket registered
+--						const std::vector<char *> &slots: Receive slots inside the registered buffers, one per read
+--						size_t slot_size: Size of every slot in Bytes
+--						const UringDataHandler &handler: Called for every chunk read, in order
+--
+--	RETURNS:		int - 1 once the socket is drained, 0 if the peer closed the connection, -1 on error or if the
+--					handler stopped the receive.
+--
+--	NOTES:
+--	Called on EVENT_READ. Issues one read per slot with a single io_uring_enter and hands the data to the handler,
+--	until a window ends with the socket drained. The handler gets the position of the chunk in its window, so the
+--	caller can count chunks per system call.
+----------------------------------------------------------------------------------------------------------------------*/
+int uring_receive(IoUring &ring, const std::vector<char *> &slots, size_t slot_size, const UringDataHandler &handler)
+{
+	std::vector<int> results(slots.size());
+	UringCompletion completion;
+
+	do
+	{
+		bool drained = false;
+		int chunk = 0;
+
+		for (size_t k = 0; k < slots.size(); k++)
+		{
+			ring.queue_read(slots[k], slot_size, k);
+		}
+
+		if (ring.submit((unsigned)slots.size()) == -1)
+		{
+			return -1;
+		}
+
+		for (size_t k = 0; k < slots.size(); k++)
+		{
+			while (!ring.reap(completion))
+			{
+				if (ring.submit(1) == -1)
+					return -1;
+			}
+			results[completion.user_data] = completion.result;
+		}
+
+		// Hand on the Data in Submission Order
+		for (size_t k = 0; k < slots.size(); k++)
+		{
+			if (results[k] > 0)
+			{
+				if (!handler(slots[k], results[k], chunk++))
+					return -1;
+			}
+			else if (results[k] == 0)
+			{
+				return 0;
+			}
+			else if (results[k] == -EAGAIN || results[k] == -EINTR)
+			{
+				drained = true;
+			}
+			else
+			{
+				errno = -results[k];
+				perror("io_uring read failed");
+				return -1;
+			}
+		}
+
+		if (drained)
+		{
+			return 1;
+		}
+	} while (true);
+}
+
+#endif
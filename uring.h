@@ -0,0 +1,82 @@
+#pragma once
+
+#include "transport.h"
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <functional>
+#include <stdint.h>
+
+// Size of a Receive Slot (one read)
+#define URING_SLOT_SIZE UDP_DATAGRAM_MAX
+
+class Payload;
+
+// Completed io_uring Operation
+struct UringCompletion
+{
+	uint64_t user_data;
+	int result;
+};
+
+// Called for every Chunk of Data Read, in Stream Order (return false to stop)
+typedef std::function<bool(const char *data, ssize_t len, int call_index)> UringDataHandler;
+
+class IoUring
+{
+	public:
+		IoUring() {};
+		~IoUring() { close(); };
+		bool setup(unsigned entries);
+		void close();
+		bool is_ready() const { return ring_fd != -1; };
+		bool register_buffers(const std::vector<struct iovec> &iovecs);
+		bool register_file(int fd);
+		void unregister_file();
+		int registered_file() const { return file_fd; };
+		bool queue_read(void *buf, size_t len, uint64_t user_data);
+		bool queue_write(const void *buf, size_t len, uint64_t user_data, bool link);
+		int submit(unsigned wait_nr);
+		bool reap(UringCompletion &completion);
+		long long enter_calls() const { return enters; };
+		void reset_enter_calls() { enters = 0; };
+	private:
+		struct io_uring_sqe *next_sqe();
+		void prep_rw(struct io_uring_sqe *sqe, int op, const void *buf, size_t len, uint64_t user_data);
+		int fixed_buffer(const void *data, size_t len) const;
+		int ring_fd = -1;
+		int file_fd = -1;
+		bool file_registered = false;
+		unsigned queued = 0;
+		long long enters = 0;
+		void *sq_ring = NULL;
+		void *cq_ring = NULL;
+		size_t sq_ring_size = 0;
+		size_t cq_ring_size = 0;
+		struct io_uring_sqe *sqes = NULL;
+		size_t sqes_size = 0;
+		unsigned *sq_head = NULL;
+		unsigned *sq_tail = NULL;
+		unsigned *sq_mask = NULL;
+		unsigned *sq_array = NULL;
+		unsigned sq_entries = 0;
+		unsigned *cq_head = NULL;
+		unsigned *cq_tail = NULL;
+		unsigned *cq_mask = NULL;
+		struct io_uring_cqe *cqes = NULL;
+		std::vector<struct iovec> registered;
+};
+
+// Ring Setup of the Client and Server (uring.cpp)
+bool uring_sender_setup(IoUring &ring, int depth, SOCKET sock, const Payload &payload);
+bool uring_receiver_setup(IoUring &ring, int depth, std::vector<char *> &buffers, std::vector<char *> &slots);
+void uring_receiver_release(IoUring &ring, std::vector<char *> &buffers, std::vector<char *> &slots);
+
+// Transfer Loops on top of the Ring (uring.cpp)
+bool uring_send_stream(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+	long long &total_bytes);
+bool uring_send_datagrams(IoUring &ring, Payload &payload, int packet_size, int num_packet, int depth,
+	long long &total_bytes);
+int uring_receive(IoUring &ring, const std::vector<char *> &slots, size_t slot_size, const UringDataHandler &handler);
+#endif
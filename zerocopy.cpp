@@ -0,0 +1,352 @@
+/*----------------------------------------------------------------------------------------------------------------------
+--	SOURCE FILE:	zerocopy.cpp - MSG_ZEROCOPY sends of the TCP Client and their completion notifications
+--
+--	PROGRAM:		File Transfer/Protocol Analysis
+--
+--	FUNCTIONS:
+--					bool setup(SOCKET sock, int depth)
+--					bool send(const char *buf, int len, long long &total_bytes, long long &calls)
+--					bool finish(int timeout_ms)
+--					void report(TransferResult &result)
+--					void append_report(std::string &print_output)
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:		(Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	NOTES:
+--	A plain send copies the packet into the socket buffer, which for large packets is the biggest CPU cost of the
+--	Client. With --zerocopy N the Client sends with MSG_ZEROCOPY instead: the kernel pins the pages of the packet
+--	and transmits from them, and once the data is acknowledged it queues a completion notification on the error
+--	queue of the socket. Until then the packet must not change.
+--
+--	The kernel numbers the zero-copy sends of a socket from 0, and every notification covers a range of them. The
+--	sender keeps at most N sends in flight (each one holds pinned pages and socket option memory) and recycles a
+--	slot of the pool only when the notification of its send has been read. When the pool is full it waits on the
+--	error queue. The packets are read-only views of the Payload, which is not written during the transfer (the simd
+--	mode rewrites the region with the same bytes), so the data of a send in flight stays unchanged.
+--
+--	A notification flagged SO_EE_CODE_ZEROCOPY_COPIED means the kernel copied the data after all, which it always
+--	does for loopback and for devices without scatter-gather, so the report counts both kinds. Zero-copy only pays
+--	for packets of about 10 KB and more, below that pinning the pages costs more than the copy.
+----------------------------------------------------------------------------------------------------------------------*/
+
+#ifndef _WIN32
+
+#include "zerocopy.h"
+#include "trace.h"
+#include <linux/errqueue.h>
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		setup
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		setup(SOCKET sock, int depth)
+--						SOCKET sock: Connected socket of the Client
+--						int depth: Number of sends that may wait for their notification
+--
+--	RETURNS:		bool - false if the socket does not support MSG_ZEROCOPY (the caller then sends with send()).
+----------------------------------------------------------------------------------------------------------------------*/
+bool ZeroCopySender::setup(SOCKET sock, int depth)
+{
+	int enable = 1;
+
+	if (setsockopt(sock, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == -1)
+	{
+		perror("setsockopt(SO_ZEROCOPY) failed");
+		return false;
+	}
+
+	socket = sock;
+	this->depth = depth;
+	next_id = 0;
+	completed = 0;
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		reap
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		reap()
+--
+--	RETURNS:		bool - false if the error queue cannot be read.
+--
+--	NOTES:
+--	Reads every notification queued on the error queue without waiting, and frees the slots of the sends it covers.
+--	TCP completes the sends in order, so the pool is freed up to the end of the highest range.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ZeroCopySender::reap()
+{
+	char control[BUFFERSIZE];
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct sock_extended_err *error;
+	uint32_t count;
+
+	while (true)
+	{
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		if (recvmsg(socket, &msg, MSG_ERRQUEUE) == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return (errno == EAGAIN || errno == EWOULDBLOCK);
+		}
+
+		for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+				&& !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+			{
+				continue;
+			}
+
+			error = (struct sock_extended_err *)CMSG_DATA(cmsg);
+			if (error->ee_errno != 0 || error->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+			{
+				continue;
+			}
+
+			// ee_info to ee_data (inclusive) are Complete
+			count = error->ee_data - error->ee_info + 1;
+			notifications++;
+			if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+				copied_completions += count;
+			else
+				zerocopy_completions += count;
+			if ((int32_t)(error->ee_data + 1 - completed) > 0)
+			{
+				completed = error->ee_data + 1;
+			}
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		acquire
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		acquire()
+--
+--	RETURNS:		bool - true once a slot of the pool is free, false if no notification arrives in time.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ZeroCopySender::acquire()
+{
+	if (!reap())
+	{
+		return false;
+	}
+
+	while ((int)(next_id - completed) >= depth)
+	{
+		pool_waits++;
+		if (!wait_for_socket(socket, 0, SEND_TIMEOUT) || !reap())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		send
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		send(const char *buf, int len, long long &total_bytes, long long &calls)
+--						const char *buf: Data to send, unchanged until its notification has been read
+--						int len: Number of bytes to send
+--						long long &total_bytes: Running total of bytes sent
+--						long long &calls: Running total of send calls
+--
+--	RETURNS:		bool - true if every byte was sent.
+--
+--	NOTES:
+--	Like send_all, but every call is a zero-copy send taking a slot of the pool. When the kernel runs out of
+--	socket option memory for the notifications (ENOBUFS) the sender waits for the sends in flight, and with none
+--	in flight sends that call with a copy.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ZeroCopySender::send(const char *buf, int len, long long &total_bytes, long long &calls)
+{
+	ssize_t sent_bytes;
+	int flags;
+	int offset = 0;
+
+	while (offset < len)
+	{
+		if (!acquire())
+		{
+			return false;
+		}
+
+		flags = MSG_NOSIGNAL | MSG_ZEROCOPY;
+		calls++;
+		sent_bytes = ::send(socket, buf + offset, len - offset, flags);
+		if (sent_bytes == -1 && errno == ENOBUFS && next_id == completed)
+		{
+			flags = MSG_NOSIGNAL;
+			sent_bytes = ::send(socket, buf + offset, len - offset, flags);
+		}
+		trace_ring().record(TRACE_SEND, (uint32_t)calls, len - offset, (int32_t)sent_bytes,
+			(sent_bytes == -1) ? errno : 0);
+		if (sent_bytes == -1)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(socket, POLLOUT, SEND_TIMEOUT))
+			{
+				continue;
+			}
+			if (errno == ENOBUFS && wait_for_socket(socket, 0, SEND_TIMEOUT))
+			{
+				continue;
+			}
+			return false;
+		}
+
+		// Every Successful Zero-Copy Call gets the Next Notification Number
+		if (flags & MSG_ZEROCOPY)
+			next_id++;
+		else
+			copied_sends++;
+		offset += sent_bytes;
+		total_bytes += sent_bytes;
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		finish
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		finish(int timeout_ms)
+--						int timeout_ms: Maximum time to wait for each notification
+--
+--	RETURNS:		bool - true if every send has completed.
+--
+--	NOTES:
+--	Waits for the notifications of all sends in flight. Called before the payload is released.
+----------------------------------------------------------------------------------------------------------------------*/
+bool ZeroCopySender::finish(int timeout_ms)
+{
+	if (!reap())
+	{
+		return false;
+	}
+
+	while (next_id != completed)
+	{
+		if (!wait_for_socket(socket, 0, timeout_ms) || !reap())
+		{
+			fprintf(stderr, "%u zero-copy sends did not complete\n", next_id - completed);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		report(TransferResult &result)
+--						TransferResult &result: Statistics of the transfer
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void ZeroCopySender::report(TransferResult &result) const
+{
+	result.zerocopy_completions = zerocopy_completions;
+	result.copied_completions = copied_completions + copied_sends;
+}
+
+/*----------------------------------------------------------------------------------------------------------------------
+--	FUNCTION:		append_report
+--
+--	DATE:			October 16, 2026
+--
+--	REVISIONS:	    (Date and Description)
+--
+--	DESIGNER:		Viktor Alvar
+--
+--	PROGRAMMER:		Viktor Alvar
+--
+--	INTERFACE:		append_report(std::string &print_output)
+--						std::string &print_output: Output string the report is appended to
+--
+--	RETURNS:		void.
+----------------------------------------------------------------------------------------------------------------------*/
+void ZeroCopySender::append_report(std::string &print_output) const
+{
+	char line[BUFFERSIZE * 2];
+
+	snprintf(line, sizeof(line), "\nZero-Copy Sends: %lld without a copy, %lld copied by the kernel (%lld notifications)",
+		zerocopy_completions, copied_completions, notifications);
+	print_output += line;
+	snprintf(line, sizeof(line), "\nZero-Copy Pool: %d sends, waited %lld times for a free slot", depth, pool_waits);
+	print_output += line;
+	if (copied_sends > 0)
+	{
+		print_output += "\nSent with a Copy (ENOBUFS): ";
+		print_output += std::to_string(copied_sends);
+	}
+}
+
+#endif
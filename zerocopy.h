@@ -0,0 +1,30 @@
+#pragma once
+
+#include "transport.h"
+#include <stdint.h>
+
+// MSG_ZEROCOPY Sender of a TCP Client: a Pool of Sends Waiting for their Completion Notification
+class ZeroCopySender
+{
+	public:
+		ZeroCopySender() {};
+		~ZeroCopySender() {};
+		bool setup(SOCKET sock, int depth);
+		bool is_ready() const { return socket != INVALID_SOCKET; };
+		bool send(const char *buf, int len, long long &total_bytes, long long &calls);
+		bool finish(int timeout_ms);
+		void report(TransferResult &result) const;
+		void append_report(std::string &print_output) const;
+	private:
+		bool reap();
+		bool acquire();
+		SOCKET socket = INVALID_SOCKET;
+		int depth = 0;
+		uint32_t next_id = 0;
+		uint32_t completed = 0;
+		long long zerocopy_completions = 0;
+		long long copied_completions = 0;
+		long long notifications = 0;
+		long long copied_sends = 0;
+		long long pool_waits = 0;
+};